@@ -100,6 +100,7 @@
 #include "irouts.h"
 #include "irprintf.h"
 #include "irprog.h"
+#include "irtrace.h"
 #include "irverify.h"
 #include "lowering.h"
 #include "target.h"
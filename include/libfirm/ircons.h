@@ -146,6 +146,13 @@
  *    - An even less comfortable interface where the block needs to be specified
  *      explicitly.  This is called the "raw" interface. (new_r_<Node>
  *      constructors).
+ *    - The raw interface in bulk mode for importing IR which already is in
+ *      optimized SSA form (irg_begin_bulk_cons()).  New nodes are neither
+ *      verified nor locally optimized nor entered into the CSE table, so
+ *      nodes may be created with NULL predecessors which are set later with
+ *      set_irn_n(), and Phi nodes are created directly with all their
+ *      predecessors.  irg_finalize_bulk_cons() verifies the nodes and
+ *      performs common subexpression elimination once for the whole graph.
  *
  *    To use the functionality of the comfortable interface correctly the front
  *    end needs to follow certain protocols.  This is explained in the
@@ -585,6 +592,27 @@ FIRM_API void keep_alive(ir_node *ka);
 /** Puts the graph into state "phase_high" */
 FIRM_API void irg_finalize_cons(ir_graph *irg);
 
+/**
+ * Starts bulk construction of a graph under construction.
+ *
+ * Until irg_finalize_bulk_cons() the node constructors do not verify or
+ * optimize new nodes and do not perform common subexpression elimination.
+ * Construct nodes with their final predecessors where possible, or with NULL
+ * predecessors which must be set with set_irn_n() before finalizing.  The
+ * automatic SSA construction (set_value(), get_value(), immature blocks) must
+ * not be used in this mode.
+ */
+FIRM_API void irg_begin_bulk_cons(ir_graph *irg);
+
+/**
+ * Finishes bulk construction of a graph and puts it into state "phase_high".
+ *
+ * Performs common subexpression elimination on the whole graph if local
+ * optimizations and CSE are enabled, and verifies all nodes if firm is built
+ * in debug mode.
+ */
+FIRM_API void irg_finalize_bulk_cons(ir_graph *irg);
+
 /**
  * If firm is built in debug mode, verify that a newly created node is fine.
  * The normal node constructors already call this function, you only need to
@@ -175,6 +175,38 @@ FIRM_API void postdom_tree_walk_irg(ir_graph *irg, irg_walk_func *pre,
  */
 FIRM_API void compute_doms(ir_graph *irg);
 
+/**
+ * Updates the dominance information of a graph after a control flow edge
+ * from block @p from to block @p to has been added.
+ *
+ * The dominance information must have been consistent before the edge was
+ * added, so call this after each change.  Only the dominator subtree below
+ * the nearest common dominator of both blocks is recomputed.  If dead code
+ * becomes reachable the dominance information is recomputed from scratch.
+ * A block @p to created after the dominance computation becomes a leaf below
+ * @p from, so it must not have successors yet; add them with further calls.
+ * The dominance frontiers are freed.
+ */
+FIRM_API void ir_dom_insert_edge(ir_node *from, ir_node *to);
+
+/**
+ * Updates the dominance information of a graph after a control flow edge
+ * from block @p from to block @p to has been removed.
+ *
+ * The dominance information must have been consistent before the edge was
+ * removed, so call this after each change.  Only the dominator subtree below
+ * the old immediate dominator of @p to is recomputed.  Blocks which became
+ * unreachable get the dominance information of dead code.
+ * The dominance frontiers are freed.
+ */
+FIRM_API void ir_dom_delete_edge(ir_node *from, ir_node *to);
+
+/**
+ * Sets the dominance verification flag: If set, the result of every
+ * incremental update is compared against a full recomputation.
+ */
+FIRM_API void dom_init_dbg(int do_dbg);
+
 /** Computes the post dominance relation for all basic blocks of a given graph.
  *
  * Sets a flag in irg to "dom_consistent".
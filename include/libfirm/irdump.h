@@ -83,6 +83,25 @@ typedef void (*ir_graph_dump_func)(FILE *out, ir_graph *graph);
 FIRM_API void dump_ir_graph_ext(ir_graph_dump_func func, ir_graph *graph,
                                 const char *suffix);
 
+/**
+ * Appends the state of @p graph to the stream file of the graph.
+ *
+ * The file is named after the graph with the extension ".irstream" and is
+ * stored into the directory specified by #ir_set_dump_path. The first dump of
+ * a graph writes all its nodes, every later dump only the nodes whose opcode,
+ * mode, operands or label (attributes like Proj numbers, tarvals and
+ * entities) changed and the nodes that became unreachable. Each dump
+ * starts with a line "dump <nr> full|delta <suffix>", followed by lines
+ * "n <idx> <op> <mode> <block> <arity> <operands...> <label>" for new or
+ * changed nodes and "d <idx>" for removed ones; node references are node
+ * indices, "-" stands for no node. support/irstream.py rebuilds the graph
+ * after any dump from such a file and converts it to vcg or dot.
+ *
+ * @param graph   the graph to dump
+ * @param suffix  name of the dump, usually the name of the last phase
+ */
+FIRM_API void dump_ir_graph_stream(ir_graph *graph, const char *suffix);
+
 /**
  * A walker that calls a dumper for each graph in the program
  *
@@ -283,6 +302,9 @@ typedef enum {
 	ir_dump_flag_ld_names              = 1U << 15,
 	/** dump entities in class hierarchies */
 	ir_dump_flag_entities_in_hierarchy = 1U << 16,
+	/** dump_ir_graph() appends to the graph's stream file (see
+	 * dump_ir_graph_stream()) instead of writing a vcg file */
+	ir_dump_flag_stream                = 1U << 17,
 } ir_dump_flags_t;
 ENUM_BITSET(ir_dump_flags_t)
 
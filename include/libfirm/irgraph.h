@@ -342,6 +342,11 @@ typedef enum ir_graph_constraints_t {
 	 * annotated.
 	 */
 	IR_GRAPH_CONSTRAINT_BACKEND                   = 1U << 6,
+	/**
+	 * The graph is being constructed in bulk: New nodes are neither
+	 * verified nor optimized, see irg_begin_bulk_cons().
+	 */
+	IR_GRAPH_CONSTRAINT_BULK_CONSTRUCTION         = 1U << 7,
 } ir_graph_constraints_t;
 ENUM_BITSET(ir_graph_constraints_t)
 
@@ -395,6 +400,8 @@ typedef enum ir_graph_properties_t {
 	IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE        = 1U << 11,
 	/** graph contains as many returns as possible */
 	IR_GRAPH_PROPERTY_MANY_RETURNS                   = 1U << 12,
+	/** memoized alias analysis results are up to date */
+	IR_GRAPH_PROPERTY_CONSISTENT_ALIAS_INFO          = 1U << 13,
 
 	/**
 	 * List of all graph properties that are only affected by control flow
@@ -419,7 +426,8 @@ typedef enum ir_graph_properties_t {
 		| IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES
 		| IR_GRAPH_PROPERTY_CONSISTENT_OUTS
 		| IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE
-		| IR_GRAPH_PROPERTY_MANY_RETURNS,
+		| IR_GRAPH_PROPERTY_MANY_RETURNS
+		| IR_GRAPH_PROPERTY_CONSISTENT_ALIAS_INFO,
 
 } ir_graph_properties_t;
 ENUM_BITSET(ir_graph_properties_t)
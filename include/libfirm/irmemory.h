@@ -49,6 +49,9 @@ typedef enum ir_disambiguator_options {
 	aa_opt_no_alias            = 1u << 3, /**< different addresses NEVER alias */
 	/**< internal flag: options from a graph are inherited from global */
 	aa_opt_inherited           = 1u << 4,
+	/**< use the whole program points-to analysis, see
+	 * compute_irp_points_to() */
+	aa_opt_points_to           = 1u << 5,
 } ir_disambiguator_options;
 ENUM_BITSET(ir_disambiguator_options)
 
@@ -109,6 +112,31 @@ FIRM_API void set_irp_globals_entity_usage_state(ir_entity_usage_computed_state
  */
 FIRM_API void assure_irp_globals_entity_usage_computed(void);
 
+/**
+ * Computes a whole program points-to analysis over all graphs of the program.
+ *
+ * The analysis is flow- and context-insensitive and unification based, so it
+ * runs in almost linear time in the size of the program. If the callee
+ * information is consistent (see cgana()), it is used to resolve indirect
+ * calls, otherwise everything passed to them is treated as unknown.
+ *
+ * The result is used by get_alias_relation() for graphs having the
+ * aa_opt_points_to option set. It stays valid under transformations; nodes
+ * created after the analysis are treated conservatively.
+ */
+FIRM_API void compute_irp_points_to(void);
+
+/**
+ * Assure that the points-to analysis has been computed, see
+ * compute_irp_points_to().
+ */
+FIRM_API void assure_irp_points_to_computed(void);
+
+/**
+ * Frees the results of the points-to analysis.
+ */
+FIRM_API void free_irp_points_to(void);
+
 /**
  * Returns the memory disambiguator options for a graph.
  *
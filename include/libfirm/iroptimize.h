@@ -425,6 +425,9 @@ FIRM_API void shape_blocks(ir_graph *irg);
  * Perform loop inversion on a given graph.
  * Loop inversion transforms a head controlled loop (like while(...) {} and
  * for(...) {}) into a foot controlled loop (do {} while(...)).
+ *
+ * If the blocks carry execution frequencies (see ir_estimate_execfreq()),
+ * cold loops and loops with few iterations per entry are not inverted.
  */
 FIRM_API void do_loop_inversion(ir_graph *irg);
 
@@ -432,12 +435,21 @@ FIRM_API void do_loop_inversion(ir_graph *irg);
  * Perform loop unrolling on a given graph.
  * Loop unrolling multiplies the number loop completely by a number found
  * through a heuristic.
+ *
+ * If the blocks carry execution frequencies (see ir_estimate_execfreq()),
+ * cold loops are not unrolled, hot loops may grow larger and the unroll
+ * factor does not exceed the average number of iterations per entry.
  */
 FIRM_API void do_loop_unrolling(ir_graph *irg);
 
 /**
  * Perform loop unrolling on a given graph.
  *
+ * If the blocks carry execution frequencies (see ir_estimate_execfreq()),
+ * cold loops are not unrolled, and hot loops with a constant number of
+ * iterations are unrolled completely if the result has at most
+ * @p factor * @p maxsize nodes.
+ *
  * @param irg       the IR-graph to optimize
  * @param factor    the unroll factor
  * @param maxsize   the maximum number of nodes in a loop
@@ -0,0 +1,71 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2012 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       Hierarchical compile time tracing.
+ */
+#ifndef FIRM_IRTRACE_H
+#define FIRM_IRTRACE_H
+
+#include "firm_types.h"
+
+#include "begin.h"
+
+/**
+ * @defgroup irtrace Compile Time Tracing
+ *
+ * The tracing system records nested spans (a name, an optional graph and a
+ * begin and end timestamp with nanosecond resolution) for the compiler passes
+ * running on a graph. The spans are written in the Chrome trace event format
+ * (JSON array of "B"/"E" events) and can be loaded into chrome://tracing or
+ * Perfetto to find compile time outliers.
+ *
+ * The backend phases and the more expensive middle-end passes open their own
+ * spans. A driver may open additional spans around its own pass pipeline with
+ * ir_trace_push() and ir_trace_pop().
+ *
+ * @{
+ */
+
+/**
+ * Starts tracing and writes the spans to @p filename (the file is truncated).
+ * If a trace is already running, its open spans are continued in the new
+ * file.
+ * @return 0 on success, non-zero if the file could not be opened
+ */
+FIRM_API int ir_trace_begin(const char *filename);
+
+/**
+ * Finishes tracing and closes the trace file.
+ * Spans which are still open are closed first.
+ */
+FIRM_API void ir_trace_end(void);
+
+/**
+ * Opens a new span named @p name nested in the currently open span.
+ * Spans nested more than 256 levels deep are not recorded.
+ * @param name  name of the span, must stay valid until ir_trace_pop()
+ * @param irg   graph the span works on, may be NULL
+ */
+FIRM_API void ir_trace_push(const char *name, const ir_graph *irg);
+
+/**
+ * Closes the most recently opened span.
+ * Does nothing if no span is open, for example for spans opened before
+ * tracing started.
+ */
+FIRM_API void ir_trace_pop(void);
+
+/**
+ * This variable indicates whether trace output is enabled.
+ */
+FIRM_API int ir_trace_enabled;
+
+/** @} */
+
+#include "end.h"
+
+#endif
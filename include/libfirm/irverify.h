@@ -41,9 +41,39 @@ FIRM_API int irg_verify(ir_graph *irg);
 /**
  * Convenience function: Checks graph for errors, in case of error the graph
  * is dumped to a file with "-assert" suffix and the program aborted.
+ * The check is done by irg_verify_sampled(), so a sampling period set with
+ * irg_verify_set_sample_period() switches it to the sampled mode.
  */
 FIRM_API void irg_assert_verify(ir_graph *irg);
 
+/**
+ * Sets the sampling period for irg_verify_sampled().
+ *
+ * With a period greater than 1 all nodes created or replaced (see exchange())
+ * are recorded, and only every @p period th call of irg_verify_sampled() for
+ * a graph runs the full irg_verify(). The calls in between only verify the
+ * recorded nodes. A period of 0 or 1 disables recording, so that
+ * irg_verify_sampled() behaves like irg_verify().
+ *
+ * @param period  the number of sampled verifications per full verification
+ */
+FIRM_API void irg_verify_set_sample_period(unsigned period);
+
+/**
+ * Verifies the part of @p irg changed since the last call, or the whole graph
+ * every irg_verify_set_sample_period() calls.
+ *
+ * The partial check runs irn_verify() on every reachable node created or
+ * replaced since the last call, on its block and, if out edges are active,
+ * on its users. If dominance information is consistent, these nodes are also
+ * checked for the SSA property. Inputs changed in place with set_irn_n() are
+ * not recorded and are only caught by the next full verification.
+ *
+ * @param irg  the IR-graph to check
+ * @return NON-zero if no problems were found
+ */
+FIRM_API int irg_verify_sampled(ir_graph *irg);
+
 /** @} */
 
 #include "end.h"
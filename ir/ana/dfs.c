@@ -15,6 +15,7 @@
 
 #define DISABLE_STATEV
 
+#include "array.h"
 #include "irdom_t.h"
 #include "iredges_t.h"
 #include "irgraph_t.h"
@@ -55,9 +56,19 @@ static dfs_edge_t *get_edge(dfs_t const *const self, ir_node const *const src, i
 	return set_insert(dfs_edge_t, self->edges, &templ, sizeof(templ), hash);
 }
 
-static void dfs_perform(dfs_t *dfs, ir_node *n, dfs_node_t const *anc, int level)
+/**
+ * A node on the depth-first search stack of dfs_perform() with the next
+ * successor edge to visit.
+ */
+typedef struct dfs_frame_t {
+	dfs_node_t      *node;
+	ir_edge_t const *edge;
+	dfs_node_t      *child;  /**< child visited from edge, if any */
+} dfs_frame_t;
+
+static void dfs_enter(dfs_t *dfs, dfs_node_t *node, ir_node *n,
+                      dfs_node_t const *anc, int level)
 {
-	dfs_node_t *node = get_node(dfs, n);
 	assert(node->visited == 0);
 	node->visited     = 1;
 	node->node        = n;
@@ -65,26 +76,61 @@ static void dfs_perform(dfs_t *dfs, ir_node *n, dfs_node_t const *anc, int level
 	node->pre_num     = dfs->pre_num++;
 	node->max_pre_num = node->pre_num;
 	node->level       = level;
+}
+
+static void dfs_perform(dfs_t *dfs, ir_node *n)
+{
+	/* the stack grows with the depth of the search */
+	dfs_frame_t *stack = NEW_ARR_F(dfs_frame_t, 16);
+	size_t       tos   = 0;
+
+	dfs_node_t *const root = get_node(dfs, n);
+	dfs_enter(dfs, root, n, NULL, 0);
+	stack[tos].node  = root;
+	stack[tos].edge  = get_irn_out_edge_first_kind(n, EDGE_KIND_BLOCK);
+	stack[tos].child = NULL;
+	++tos;
+	while (tos > 0) {
+		dfs_frame_t *const frame = &stack[tos - 1];
+		dfs_node_t  *const node  = frame->node;
+		ir_node     *const block = (ir_node*)node->node;
+
+		/* get the maximum pre num of the subtree. needed for ancestor determination. */
+		if (frame->child != NULL) {
+			node->max_pre_num = MAX(node->max_pre_num, frame->child->max_pre_num);
+			frame->child = NULL;
+		}
+
+		ir_edge_t const *const edge = frame->edge;
+		if (edge == NULL) {
+			node->post_num = dfs->post_num++;
+			--tos;
+			continue;
+		}
+		frame->edge = get_irn_out_edge_next(block, edge, EDGE_KIND_BLOCK);
 
-	foreach_block_succ(n, edge) {
 		ir_node *const p = get_edge_src_irn(edge);
 
 		/* get the node */
 		dfs_node_t *child = get_node(dfs, p);
 
 		/* create the edge object */
-		dfs_edge_t *edge = get_edge(dfs, n, p);
-		edge->s = node;
-		edge->t = child;
-
-		if (!child->visited)
-			dfs_perform(dfs, p, node, level + 1);
-
-		/* get the maximum pre num of the subtree. needed for ancestor determination. */
-		node->max_pre_num = MAX(node->max_pre_num, child->max_pre_num);
+		dfs_edge_t *dfs_edge = get_edge(dfs, block, p);
+		dfs_edge->s = node;
+		dfs_edge->t = child;
+
+		frame->child = child;
+		if (!child->visited) {
+			dfs_enter(dfs, child, p, node, node->level + 1);
+			if (tos == ARR_LEN(stack))
+				ARR_RESIZE(dfs_frame_t, stack, 2 * tos);
+			stack[tos].node  = child;
+			stack[tos].edge  = get_irn_out_edge_first_kind(p, EDGE_KIND_BLOCK);
+			stack[tos].child = NULL;
+			++tos;
+		}
 	}
-
-	node->post_num = dfs->post_num++;
+	DEL_ARR_F(stack);
 }
 
 static void classify_edges(dfs_t *dfs)
@@ -139,7 +185,7 @@ dfs_t *dfs_new(ir_graph *const irg)
 	res->edges_classified = false;
 
 	ir_node *const root = get_irg_start_block(irg);
-	dfs_perform(res, root, NULL, 0);
+	dfs_perform(res, root);
 
 	/* make sure the end node (which might not be accessible) has a number */
 	ir_node    *const end  = get_irg_end_block(irg);
@@ -25,7 +25,7 @@
 #define dfs_get_post_num(dfs, node)     (_dfs_get_node((dfs), (node))->post_num)
 #define dfs_get_pre_num_node(dfs, num)  ((dfs)->pre_order[num]->node)
 #define dfs_get_post_num_node(dfs, num) ((dfs)->post_order[num]->node)
-#define dfs_is_ancestor(dfs, n, m)      _dfs_is_ancestor((n), (m))
+#define dfs_is_ancestor(dfs, n, m)      _dfs_is_ancestor((dfs), (n), (m))
 
 struct dfs_node_t {
 	int               visited;
@@ -345,6 +345,60 @@ int get_block_execfreq_int(const ir_execfreq_int_factors *factors,
 	return res;
 }
 
+bool ir_has_execfreq(const ir_graph *irg)
+{
+	return get_block_execfreq(get_irg_start_block(irg)) > 0.0;
+}
+
+/** Returns true if @p block belongs to @p loop or one of its inner loops. */
+static bool is_block_in_loop(const ir_node *block, const ir_loop *loop)
+{
+	const ir_loop *block_loop = get_irn_loop(block);
+	if (block_loop == NULL)
+		return false;
+	unsigned const depth = get_loop_depth(loop);
+	while (get_loop_depth(block_loop) > depth)
+		block_loop = get_loop_outer_loop(block_loop);
+	return block_loop == loop;
+}
+
+/**
+ * Returns the frequency of the control flow edge @p pos into @p block.
+ * Only block frequencies are known, so the frequency of a branching
+ * predecessor is split evenly between its successors.
+ */
+static double get_cf_edge_execfreq(const ir_node *block, int pos)
+{
+	const ir_node *pred = get_Block_cfgpred_block(block, pos);
+	if (pred == NULL)
+		return 0.0;
+
+	double         freq = get_block_execfreq(pred);
+	const ir_node *cfop = skip_Proj_const(get_Block_cfgpred(block, pos));
+	if (is_Cond(cfop))
+		freq /= 2.0;
+	else if (is_Switch(cfop))
+		freq /= get_Switch_n_outs(cfop);
+	return MIN(freq, get_block_execfreq(block));
+}
+
+double get_loop_trip_count(const ir_loop *loop, const ir_node *header)
+{
+	double const header_freq = get_block_execfreq(header);
+	if (header_freq <= 0.0)
+		return 0.0;
+
+	double entry_freq = 0.0;
+	for (int i = 0, n = get_Block_n_cfgpreds(header); i < n; ++i) {
+		const ir_node *pred = get_Block_cfgpred_block(header, i);
+		if (pred != NULL && !is_block_in_loop(pred, loop))
+			entry_freq += get_cf_edge_execfreq(header, i);
+	}
+	if (entry_freq <= 0.0)
+		return 0.0;
+	return header_freq / entry_freq;
+}
+
 static void block_walk_no_keeps(ir_node *block)
 {
 	if (Block_block_visited(block))
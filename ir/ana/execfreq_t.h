@@ -14,6 +14,8 @@
 
 #include "execfreq.h"
 
+#include <stdbool.h>
+
 void init_execfreq(void);
 
 void exit_execfreq(void);
@@ -32,4 +34,23 @@ void ir_calculate_execfreq_int_factors(ir_execfreq_int_factors *factors,
 int get_block_execfreq_int(const ir_execfreq_int_factors *factors,
                            const ir_node *block);
 
+/**
+ * Returns true if the blocks of @p irg carry execution frequencies, either
+ * estimated by ir_estimate_execfreq() or taken from profile data.
+ */
+bool ir_has_execfreq(const ir_graph *irg);
+
+/**
+ * Returns the average number of executions of the loop header @p header per
+ * entry into @p loop, derived from the block execution frequencies.
+ * Requires consistent loop information. Returns 0 if the frequencies are
+ * unknown.
+ */
+double get_loop_trip_count(const ir_loop *loop, const ir_node *header);
+
+/** Loop optimizations skip loops whose header executes less often per call. */
+#define COLD_LOOP_FREQ 1.0
+/** Loops whose header executes at least this often per call are hot. */
+#define HOT_LOOP_FREQ  8.0
+
 #endif
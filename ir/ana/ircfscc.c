@@ -20,6 +20,7 @@
 #include "irnode_t.h"
 #include "irprog_t.h"
 #include "pmap.h"
+#include "util.h"
 
 /** The outermost graph the scc is computed for */
 static ir_graph *outermost_ir_graph;
@@ -126,16 +127,39 @@ static ir_node **stack = NULL;
 static size_t    tos = 0;
 
 /**
- * Initializes the IR-node stack
+ * A block on the depth-first search stack of cfscc(), i.e. the state of what
+ * used to be a recursive call.
  */
-static inline void init_stack(void)
+typedef struct cfscc_frame_t {
+	ir_node *block;
+	ir_node *pred;     /**< predecessor visited last, if any */
+	int      pos;      /**< next predecessor to visit */
+	bool     in_tail;  /**< the tail of the loop headed by block is visited */
+	bool     close;    /**< close loop after visiting the tail */
+	ir_loop *loop;
+} cfscc_frame_t;
+
+/** The depth-first search stack */
+static cfscc_frame_t *frames = NULL;
+/** The top (index) of the depth-first search stack */
+static size_t         frames_tos = 0;
+
+/**
+ * Initializes the IR-node stack and the depth-first search stack for a graph
+ * with @p n_blocks blocks.
+ */
+static inline void init_stack(size_t n_blocks)
 {
-	stack = NEW_ARR_F(ir_node *, 100);
+	stack = NEW_ARR_F(ir_node *, MAX(n_blocks, 1));
 	tos = 0;
+	frames = NEW_ARR_F(cfscc_frame_t, MAX(n_blocks, 1));
+	frames_tos = 0;
 }
 
 static void finish_stack(void)
 {
+	DEL_ARR_F(frames);
+	frames = NULL;
 	DEL_ARR_F(stack);
 	stack = NULL;
 }
@@ -243,27 +267,34 @@ static ir_loop *new_loop(void)
 
 /* Initialization steps. **********************************************/
 
+typedef struct init_env_t {
+	struct obstack *obst;
+	size_t          n_blocks;
+} init_env_t;
+
 /**
  * Allocates a scc_info for every Block node n.
  * Clear the backedges for all nodes.
  * Called from a walker.
  */
-static inline void init_node(ir_node *n, void *env)
+static inline void init_node(ir_node *n, void *data)
 {
-	struct obstack *obst = (struct obstack*) env;
-	if (is_Block(n))
-		set_irn_link(n, new_scc_info(obst));
+	init_env_t *env = (init_env_t*)data;
+	if (is_Block(n)) {
+		set_irn_link(n, new_scc_info(env->obst));
+		++env->n_blocks;
+	}
 	clear_backedges(n);
 }
 
 /**
  * Initializes the common global settings for the scc algorithm
  */
-static inline void init_scc_common(void)
+static inline void init_scc_common(size_t n_blocks)
 {
 	current_dfn   = 1;
 	loop_node_cnt = 0;
-	init_stack();
+	init_stack(n_blocks);
 }
 
 /**
@@ -272,8 +303,9 @@ static inline void init_scc_common(void)
  */
 static inline void init_scc(ir_graph *irg, struct obstack *obst)
 {
-	init_scc_common();
-	irg_walk_graph(irg, init_node, NULL, obst);
+	init_env_t env = { obst, 0 };
+	irg_walk_graph(irg, init_node, NULL, &env);
+	init_scc_common(env.n_blocks);
 }
 
 static inline void finish_scc(void)
@@ -463,9 +495,9 @@ inline static bool is_outermost_loop(const ir_loop *l)
  *-----------------------------------------------------------*/
 
 /**
- * Walks over all blocks of a graph
+ * Starts visiting block @p n unless it was visited already.
  */
-static void cfscc(ir_node *n)
+static void cfscc_enter(ir_node *n)
 {
 	assert(is_Block(n));
 	if (irn_visited_else_mark(n))
@@ -478,77 +510,116 @@ static void cfscc(ir_node *n)
 	++current_dfn;
 	push(n);
 
-	for (int i = 0, arity = get_Block_n_cfgpreds(n); i < arity; i++) {
-		if (is_backedge(n, i))
-			continue;
-		ir_node *m = get_Block_cfgpred_block(n, i);
-		/* ignore Bad control flow: it cannot happen */
-		if (m == NULL)
-			continue;
-
-		cfscc(m);
-		if (irn_is_in_stack(m)) {
-			/* Uplink of m is smaller if n->m is a backedge.
-			   Propagate the uplink to mark the cfloop. */
-			if (get_irn_uplink(m) < get_irn_uplink(n))
-				set_irn_uplink(n, get_irn_uplink(m));
-		}
+	if (frames_tos == ARR_LEN(frames)) {
+		size_t nlen = ARR_LEN(frames) * 2;
+		ARR_RESIZE(cfscc_frame_t, frames, nlen);
 	}
+	cfscc_frame_t *frame = &frames[frames_tos++];
+	frame->block   = n;
+	frame->pred    = NULL;
+	frame->pos     = 0;
+	frame->in_tail = false;
+	frame->close   = false;
+	frame->loop    = NULL;
+}
 
-	if (get_irn_dfn(n) == get_irn_uplink(n)) {
-		/* This condition holds for
-		   1) the node with the incoming backedge.
-		      That is: We found a cfloop!
-		   2) Straight line code, because no uplink has been propagated, so the
-		      uplink still is the same as the dfn.
-
-		   But n might not be a proper cfloop head for the analysis. Proper cfloop
-		   heads are Block and Phi nodes. find_tail searches the stack for
-		   Block's and Phi's and takes those nodes as cfloop heads for the current
-		   cfloop instead and marks the incoming edge as backedge. */
-
-		ir_node *tail = find_tail(n);
-		if (tail) {
-			/* We have a cfloop, that is no straight line code,
-			   because we found a cfloop head!
-			   Next actions: Open a new cfloop on the cfloop tree and
-			   try to find inner cfloops */
-
-			/* This is an adaption of the algorithm from fiasco / optscc to
-			 * avoid cfloops without Block or Phi as first node.  This should
-			 * severely reduce the number of evaluations of nodes to detect
-			 * a fixpoint in the heap analysis.
-			 * Further it avoids cfloops without firm nodes that cause errors
-			 * in the heap analyses. */
-
-			ir_loop *l;
-			bool     close;
-			if ((get_loop_n_elements(current_loop) > 0) || (is_outermost_loop(current_loop))) {
-				l = new_loop();
-				close = true;
-			} else {
-				l = current_loop;
-				close = false;
+/**
+ * Walks over all blocks of a graph.  The search keeps its own stack, as
+ * the control flow can be much deeper than the C stack.
+ */
+static void cfscc(ir_node *root)
+{
+	cfscc_enter(root);
+	while (frames_tos > 0) {
+		cfscc_frame_t *const frame = &frames[frames_tos - 1];
+		ir_node       *const n     = frame->block;
+
+		ir_node *const m = frame->pred;
+		if (m != NULL) {
+			frame->pred = NULL;
+			if (irn_is_in_stack(m)) {
+				/* Uplink of m is smaller if n->m is a backedge.
+				   Propagate the uplink to mark the cfloop. */
+				if (get_irn_uplink(m) < get_irn_uplink(n))
+					set_irn_uplink(n, get_irn_uplink(m));
 			}
+		}
+
+		if (frame->in_tail) {
+			/* the inner cfloops of the cfloop headed by n are done */
+			assert(irn_visited(n));
+			if (frame->close)
+				close_loop(frame->loop);
+			--frames_tos;
+			continue;
+		}
+
+		if (frame->pos < get_Block_n_cfgpreds(n)) {
+			int const i = frame->pos++;
+			if (is_backedge(n, i))
+				continue;
+			ir_node *const pred = get_Block_cfgpred_block(n, i);
+			/* ignore Bad control flow: it cannot happen */
+			if (pred == NULL)
+				continue;
+
+			frame->pred = pred;
+			cfscc_enter(pred);
+			continue;
+		}
 
-			/* Remove the cfloop from the stack ... */
-			pop_scc_unmark_visit(n);
+		if (get_irn_dfn(n) == get_irn_uplink(n)) {
+			/* This condition holds for
+			   1) the node with the incoming backedge.
+			      That is: We found a cfloop!
+			   2) Straight line code, because no uplink has been propagated, so the
+			      uplink still is the same as the dfn.
+
+			   But n might not be a proper cfloop head for the analysis. Proper cfloop
+			   heads are Block and Phi nodes. find_tail searches the stack for
+			   Block's and Phi's and takes those nodes as cfloop heads for the current
+			   cfloop instead and marks the incoming edge as backedge. */
+
+			ir_node *tail = find_tail(n);
+			if (tail) {
+				/* We have a cfloop, that is no straight line code,
+				   because we found a cfloop head!
+				   Next actions: Open a new cfloop on the cfloop tree and
+				   try to find inner cfloops */
+
+				/* This is an adaption of the algorithm from fiasco / optscc to
+				 * avoid cfloops without Block or Phi as first node.  This should
+				 * severely reduce the number of evaluations of nodes to detect
+				 * a fixpoint in the heap analysis.
+				 * Further it avoids cfloops without firm nodes that cause errors
+				 * in the heap analyses. */
+
+				if ((get_loop_n_elements(current_loop) > 0) || (is_outermost_loop(current_loop))) {
+					frame->loop  = new_loop();
+					frame->close = true;
+				} else {
+					frame->loop  = current_loop;
+					frame->close = false;
+				}
+				frame->in_tail = true;
 
-			/* The current backedge has been marked, that is temporarily eliminated,
-			   by find tail. Start the scc algorithm
-			   anew on the subgraph thats left (the current cfloop without the backedge)
-			   in order to find more inner cfloops. */
+				/* Remove the cfloop from the stack ... */
+				pop_scc_unmark_visit(n);
 
-			cfscc(tail);
+				/* The current backedge has been marked, that is temporarily eliminated,
+				   by find tail. Start the scc algorithm
+				   anew on the subgraph thats left (the current cfloop without the backedge)
+				   in order to find more inner cfloops. */
 
-			assert(irn_visited(n));
-			if (close)
-				close_loop(l);
-		} else {
-			/* AS: No cfloop head was found, that is we have straight line code.
-			       Pop all nodes from the stack to the current cfloop. */
-			pop_scc_to_loop(n);
+				cfscc_enter(tail);
+				continue;
+			} else {
+				/* AS: No cfloop head was found, that is we have straight line code.
+				       Pop all nodes from the stack to the current cfloop. */
+				pop_scc_to_loop(n);
+			}
 		}
+		--frames_tos;
 	}
 }
 
@@ -17,7 +17,10 @@
 #include "irgraph_t.h"
 #include "irgwalk.h"
 #include "irnode_t.h"
+#include "irnodemap.h"
 #include "irouts_t.h"
+#include "irprintf.h"
+#include "panic.h"
 #include "util.h"
 #include "xmalloc.h"
 #include <string.h>
@@ -231,36 +234,54 @@ ir_node *get_Block_postdominated_next(const ir_node *block)
 	return get_pdom_info_const(block)->next;
 }
 
-void dom_tree_walk(ir_node *block, irg_walk_func *pre, irg_walk_func *post,
-                   void *env)
+/**
+ * Walks the (post)dominator subtree of @p root without recursion: The tree
+ * is threaded by the first/next child links and the idom links, so no stack
+ * is needed to find the way back up.
+ */
+static void dom_tree_walk_(ir_node *root, irg_walk_func *pre,
+                           irg_walk_func *post, void *env,
+                           ir_dom_info *(*get_info)(ir_node *block))
 {
-	assert(irg_has_properties(get_irn_irg(block), IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE));
-
-	if (pre != NULL)
-		pre(block, env);
+	ir_node *block = root;
+	for (;;) {
+		if (pre != NULL)
+			pre(block, env);
+
+		ir_node *const first = get_info(block)->first;
+		if (first != NULL) {
+			block = first;
+			continue;
+		}
 
-	dominates_for_each(block, p) {
-		dom_tree_walk(p, pre, post, env);
+		/* leave finished subtrees until a sibling is left to visit */
+		for (;;) {
+			if (post != NULL)
+				post(block, env);
+			if (block == root)
+				return;
+			ir_dom_info *const info = get_info(block);
+			if (info->next != NULL) {
+				block = info->next;
+				break;
+			}
+			block = info->idom;
+		}
 	}
+}
 
-	if (post != NULL)
-		post(block, env);
+void dom_tree_walk(ir_node *block, irg_walk_func *pre, irg_walk_func *post,
+                   void *env)
+{
+	assert(irg_has_properties(get_irn_irg(block), IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE));
+	dom_tree_walk_(block, pre, post, env, get_dom_info);
 }
 
 void postdom_tree_walk(ir_node *block, irg_walk_func *pre,
                        irg_walk_func *post, void *env)
 {
 	assert(irg_has_properties(get_irn_irg(block), IR_GRAPH_PROPERTY_CONSISTENT_POSTDOMINANCE));
-
-	if (pre != NULL)
-		pre(block, env);
-
-	postdominates_for_each(block, p) {
-		postdom_tree_walk(p, pre, post, env);
-	}
-
-	if (post != NULL)
-		post(block, env);
+	dom_tree_walk_(block, pre, post, env, get_pdom_info);
 }
 
 void dom_tree_walk_irg(ir_graph *irg, irg_walk_func *pre, irg_walk_func *post,
@@ -370,20 +391,13 @@ typedef struct tmp_dom_info {
 	int unreachable : 1; /**< node is not reachable by control flow edges */
 } tmp_dom_info;
 
-/**
- * Walks Blocks along the out data structure.  If recursion started with
- * Start block misses control dead blocks.
- */
-static void init_tmp_dom_info(ir_node *block, tmp_dom_info *parent,
-                              tmp_dom_info *tdi_list, int *used, int n_blocks)
+/** Initializes the temporary information of a block in depth-first order. */
+static tmp_dom_info *init_tmp_info(ir_node *block, tmp_dom_info *parent,
+                                   tmp_dom_info *tdi_list, int *used,
+                                   int n_blocks, int unreachable)
 {
-	if (Block_block_visited(block)) {
-		return;
-	}
-	mark_Block_block_visited(block);
-	set_Block_dom_pre_num(block, *used);
-
 	assert(*used < n_blocks);
+	(void)n_blocks;
 	tmp_dom_info *tdi = &tdi_list[*used];
 	++(*used);
 
@@ -394,74 +408,136 @@ static void init_tmp_dom_info(ir_node *block, tmp_dom_info *parent,
 	tdi->ancestor    = NULL;
 	tdi->dom         = NULL;
 	tdi->bucket      = NULL;
-	tdi->unreachable = 0;
+	tdi->unreachable = unreachable;
+	return tdi;
+}
+
+/**
+ * A block on the depth-first search stack of init_tmp_dom_info() and
+ * init_tmp_pdom_info(), together with the number of successors left to
+ * visit.
+ */
+typedef struct dfs_frame_t {
+	tmp_dom_info *tdi;
+	int           pos;
+} dfs_frame_t;
+
+/**
+ * Walks Blocks along the out data structure.  If the search started with
+ * Start block misses control dead blocks.
+ */
+static void init_tmp_dom_info(ir_node *root, tmp_dom_info *tdi_list, int *used,
+                              int n_blocks)
+{
+	/* every block is on the stack at most once */
+	dfs_frame_t *const stack = XMALLOCN(dfs_frame_t, n_blocks);
+	int                tos   = 0;
+
+	mark_Block_block_visited(root);
+	set_Block_dom_pre_num(root, *used);
+	stack[tos].tdi = init_tmp_info(root, NULL, tdi_list, used, n_blocks, 0);
+	stack[tos].pos = get_Block_n_cfg_outs_ka(root);
+	++tos;
+	while (tos > 0) {
+		dfs_frame_t *const frame = &stack[tos - 1];
+		if (frame->pos == 0) {
+			--tos;
+			continue;
+		}
 
-	/* Iterate */
-	for (unsigned i = get_Block_n_cfg_outs_ka(block); i-- != 0;) {
-		ir_node *pred = get_Block_cfg_out_ka(block, i);
+		ir_node *const succ = get_Block_cfg_out_ka(frame->tdi->block, --frame->pos);
 		/* can happen for half-optimized dead code */
-		if (!is_Block(pred))
+		if (!is_Block(succ) || Block_block_visited(succ))
 			continue;
 
-		init_tmp_dom_info(pred, tdi, tdi_list, used, n_blocks);
+		assert(tos < n_blocks);
+		mark_Block_block_visited(succ);
+		set_Block_dom_pre_num(succ, *used);
+		stack[tos].tdi = init_tmp_info(succ, frame->tdi, tdi_list, used,
+		                               n_blocks, 0);
+		stack[tos].pos = get_Block_n_cfg_outs_ka(succ);
+		++tos;
 	}
+	free(stack);
 }
 
 /**
- * Walks Blocks along the control flow.  If recursion started with
+ * Walks Blocks along the control flow.  If the search started with
  * End block misses blocks in endless loops.
  */
-static void init_tmp_pdom_info(ir_node *block, tmp_dom_info *parent,
-                               tmp_dom_info *tdi_list, int* used, int n_blocks,
-                               int unreachable)
+static void init_tmp_pdom_info(ir_node *end_block, tmp_dom_info *tdi_list,
+                               int *used, int n_blocks)
 {
-	if (Block_block_visited(block))
-		return;
-	mark_Block_block_visited(block);
-	set_Block_postdom_pre_num(block, *used);
-
-	assert(*used < n_blocks);
-	tmp_dom_info *tdi = &tdi_list[*used];
-	++(*used);
-
-	tdi->block       = block;
-	tdi->semi        = tdi;
-	tdi->parent      = parent;
-	tdi->label       = tdi;
-	tdi->ancestor    = NULL;
-	tdi->dom         = NULL;
-	tdi->bucket      = NULL;
-	tdi->unreachable = unreachable;
-
-	/* Iterate */
-	for (int i = get_Block_n_cfgpreds(block) - 1; i >= 0; --i) {
-		ir_node *pred = get_Block_cfgpred_block(block, i);
-		if (pred == NULL)
+	ir_node *const end = get_irg_end(get_irn_irg(end_block));
+
+	dfs_frame_t *const stack = XMALLOCN(dfs_frame_t, n_blocks);
+	int                tos   = 0;
+
+	mark_Block_block_visited(end_block);
+	set_Block_postdom_pre_num(end_block, *used);
+	stack[tos].tdi = init_tmp_info(end_block, NULL, tdi_list, used, n_blocks, 0);
+	/* the End block visits its keep-alives after its predecessors */
+	stack[tos].pos = get_irn_arity(end) + get_Block_n_cfgpreds(end_block);
+	++tos;
+	while (tos > 0) {
+		dfs_frame_t  *const frame = &stack[tos - 1];
+		tmp_dom_info *const tdi   = frame->tdi;
+		ir_node      *const block = tdi->block;
+		if (frame->pos == 0) {
+			--tos;
 			continue;
-		init_tmp_pdom_info(pred, tdi, tdi_list, used, n_blocks, unreachable);
-	}
+		}
 
-	/* All remaining block keep-alives are edges to endless loops.
-	 * Mark the following unvisited blocks as unreachable.
-	 * Later, we will treat the keep-alive edges as normal control flow. */
-	const ir_graph *irg = get_irn_irg(block);
-	if (block == get_irg_end_block(irg)) {
-		foreach_irn_in_r(get_irg_end(irg), i, pred) {
-			if (is_Block(pred))
-				init_tmp_pdom_info(pred, tdi, tdi_list, used, n_blocks, 1);
+		int const n_kas       = block == end_block ? get_irn_arity(end) : 0;
+		int const pos         = --frame->pos;
+		int       unreachable = tdi->unreachable;
+		ir_node  *pred;
+		if (pos < n_kas) {
+			/* All remaining block keep-alives are edges to endless loops.
+			 * Mark the following unvisited blocks as unreachable.
+			 * Later, we will treat the keep-alive edges as normal control
+			 * flow. */
+			pred = get_irn_n(end, pos);
+			if (!is_Block(pred))
+				continue;
+			unreachable = 1;
+		} else {
+			pred = get_Block_cfgpred_block(block, pos - n_kas);
+			if (pred == NULL)
+				continue;
 		}
+		if (Block_block_visited(pred))
+			continue;
+
+		assert(tos < n_blocks);
+		mark_Block_block_visited(pred);
+		set_Block_postdom_pre_num(pred, *used);
+		stack[tos].tdi = init_tmp_info(pred, tdi, tdi_list, used, n_blocks,
+		                               unreachable);
+		stack[tos].pos = get_Block_n_cfgpreds(pred);
+		++tos;
 	}
+	free(stack);
 }
 
-static void dom_compress(tmp_dom_info *v)
+/**
+ * Compresses the ancestor path of @p v.  @p path must have room for the
+ * longest ancestor path, i.e. for all blocks.
+ */
+static void dom_compress(tmp_dom_info *v, tmp_dom_info **path)
 {
 	assert(v->ancestor);
-	if (v->ancestor->ancestor) {
-		dom_compress(v->ancestor);
-		if (v->ancestor->label->semi < v->label->semi) {
-			v->label = v->ancestor->label;
+	size_t n = 0;
+	for (tmp_dom_info *w = v; w->ancestor->ancestor != NULL; w = w->ancestor)
+		path[n++] = w;
+
+	/* update from the top of the path down, like the recursion would */
+	while (n-- > 0) {
+		tmp_dom_info *const w = path[n];
+		if (w->ancestor->label->semi < w->label->semi) {
+			w->label = w->ancestor->label;
 		}
-		v->ancestor = v->ancestor->ancestor;
+		w->ancestor = w->ancestor->ancestor;
 	}
 }
 
@@ -469,11 +545,11 @@ static void dom_compress(tmp_dom_info *v)
  * if V is a root, return v, else return the vertex u, not being the
  * root, with minimum u->semi on the path from v to its root.
  */
-inline static tmp_dom_info *dom_eval(tmp_dom_info *v)
+inline static tmp_dom_info *dom_eval(tmp_dom_info *v, tmp_dom_info **path)
 {
 	if (!v->ancestor)
 		return v;
-	dom_compress(v);
+	dom_compress(v, path);
 	return v->label;
 }
 
@@ -484,46 +560,36 @@ inline static void dom_link(tmp_dom_info *v, tmp_dom_info *w)
 }
 
 /**
- * Walker: count the number of blocks and clears the dominance info
+ * Marks a block as not reachable from Start.
  */
-static void count_and_init_blocks_dom(ir_node *block, void *env)
+static void clear_dom_info(ir_node *block)
 {
-	unsigned *n_blocks = (unsigned*)env;
-	(*n_blocks)++;
-
 	memset(get_dom_info(block), 0, sizeof(ir_dom_info));
 	set_Block_idom(block, NULL);
 	set_Block_dom_pre_num(block, -1);
 	set_Block_dom_depth(block, -1);
 }
 
-void compute_doms(ir_graph *irg)
+/**
+ * Walker: count the number of blocks and clears the dominance info
+ */
+static void count_and_init_blocks_dom(ir_node *block, void *env)
 {
-	assert(!irg_is_constrained(irg, IR_GRAPH_CONSTRAINT_CONSTRUCTION));
-
-	/* We need the out data structure. */
-	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUTS
-	                         | IR_GRAPH_PROPERTY_NO_TUPLES);
-
-	/* Count the number of blocks in the graph. */
-	int n_blocks = 0;
-	irg_block_walk_graph(irg, count_and_init_blocks_dom, NULL, &n_blocks);
-
-	/* Memory for temporary information. */
-	tmp_dom_info *tdi_list = XMALLOCN(tmp_dom_info, n_blocks);
+	unsigned *n_blocks = (unsigned*)env;
+	(*n_blocks)++;
 
-	/* this with a standard walker as passing the parent to the sons isn't
-	   simple. */
-	ir_reserve_resources(irg, IR_RESOURCE_BLOCK_VISITED);
-	inc_irg_block_visited(irg);
-	int used = 0;
-	init_tmp_dom_info(get_irg_start_block(irg), NULL, tdi_list, &used, n_blocks);
-	ir_free_resources(irg, IR_RESOURCE_BLOCK_VISITED);
-	/* If not all blocks are reachable from Start by out edges this assertion
-	   fails. */
-	assert(used <= n_blocks);
-	n_blocks = used;
+	clear_dom_info(block);
+}
 
+/**
+ * Lengauer/Tarjan steps 2 to 4: Computes the immediate dominators of the
+ * blocks in @p tdi_list, which are numbered in depth-first order starting at
+ * the root tdi_list[0].  Blocks with a pre_num of -1 are ignored as
+ * predecessors.  The dominator information of the root is left untouched.
+ */
+static void compute_idoms(ir_graph *irg, tmp_dom_info *tdi_list, int n_blocks)
+{
+	tmp_dom_info **const path = XMALLOCN(tmp_dom_info*, n_blocks);
 	for (int i = n_blocks; i-- > 1; ) {  /* Don't iterate the root, it's done. */
 		tmp_dom_info  *w     = &tdi_list[i];
 		const ir_node *block = w->block;
@@ -536,7 +602,7 @@ void compute_doms(ir_graph *irg)
 			if (is_Bad(pred) || get_Block_dom_pre_num(pred_block) == -1)
 				continue;    /* unreachable */
 
-			const tmp_dom_info *u = dom_eval(&tdi_list[get_Block_dom_pre_num(pred_block)]);
+			const tmp_dom_info *u = dom_eval(&tdi_list[get_Block_dom_pre_num(pred_block)], path);
 			if (u->semi < w->semi)
 				w->semi = u->semi;
 		}
@@ -547,7 +613,7 @@ void compute_doms(ir_graph *irg)
 				if (!is_Block(pred) || get_Block_dom_pre_num(pred) == -1)
 					continue;   /* unreachable */
 
-				const tmp_dom_info *u = dom_eval(&tdi_list[get_Block_dom_pre_num(pred)]);
+				const tmp_dom_info *u = dom_eval(&tdi_list[get_Block_dom_pre_num(pred)], path);
 				if (u->semi < w->semi)
 					w->semi = u->semi;
 			}
@@ -567,17 +633,17 @@ void compute_doms(ir_graph *irg)
 			w->parent->bucket = v->bucket;
 			v->bucket         = NULL;
 
-			tmp_dom_info *u = dom_eval(v);
+			tmp_dom_info *u = dom_eval(v, path);
 			if (u->semi < v->semi)
 				v->dom = u;
 			else
 				v->dom = w->parent;
 		}
 	}
+	free(path);
+
 	/* Step 4 */
 	tdi_list[0].dom = NULL;
-	set_Block_idom(tdi_list[0].block, NULL);
-	set_Block_dom_depth(tdi_list[0].block, 1);
 	for (int i = 1; i < n_blocks; i++) {
 		tmp_dom_info *w = &tdi_list[i];
 		if (w->dom == NULL)
@@ -593,6 +659,38 @@ void compute_doms(ir_graph *irg)
 			++depth;
 		set_Block_dom_depth(w->block, depth);
 	}
+}
+
+void compute_doms(ir_graph *irg)
+{
+	assert(!irg_is_constrained(irg, IR_GRAPH_CONSTRAINT_CONSTRUCTION));
+
+	/* We need the out data structure. */
+	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUTS
+	                         | IR_GRAPH_PROPERTY_NO_TUPLES);
+
+	/* Count the number of blocks in the graph. */
+	int n_blocks = 0;
+	irg_block_walk_graph(irg, count_and_init_blocks_dom, NULL, &n_blocks);
+
+	/* Memory for temporary information. */
+	tmp_dom_info *tdi_list = XMALLOCN(tmp_dom_info, n_blocks);
+
+	/* this with a standard walker as passing the parent to the sons isn't
+	   simple. */
+	ir_reserve_resources(irg, IR_RESOURCE_BLOCK_VISITED);
+	inc_irg_block_visited(irg);
+	int used = 0;
+	init_tmp_dom_info(get_irg_start_block(irg), tdi_list, &used, n_blocks);
+	ir_free_resources(irg, IR_RESOURCE_BLOCK_VISITED);
+	/* If not all blocks are reachable from Start by out edges this assertion
+	   fails. */
+	assert(used <= n_blocks);
+	n_blocks = used;
+
+	set_Block_idom(tdi_list[0].block, NULL);
+	set_Block_dom_depth(tdi_list[0].block, 1);
+	compute_idoms(irg, tdi_list, n_blocks);
 
 	/* clean up */
 	free(tdi_list);
@@ -605,13 +703,473 @@ void compute_doms(ir_graph *irg)
 	              assign_tree_dom_pre_order_max, &tree_pre_order);
 }
 
-static void update_pdom_semi(tmp_dom_info *tdi_list, tmp_dom_info *w,
-                             ir_node *succ_block)
+/** Verify incremental dominance updates against a full recomputation. */
+static int dom_dbg = 0;
+
+/** A dominator subtree whose dominance information is recomputed. */
+typedef struct dom_region_t {
+	ir_node      *root;       /**< The root of the subtree. */
+	unsigned      base;       /**< The tree pre-order number of the root. */
+	unsigned      size;       /**< The size of the tree pre-order range. */
+	ir_node     **blocks;     /**< The blocks of the subtree indexed by their
+	                               tree pre-order number - base, may contain
+	                               holes. */
+	unsigned     *succ_begin; /**< Start of the successors of each block in
+	                               succs. */
+	unsigned     *succs;      /**< The successors of the blocks inside the
+	                               subtree, as indices into blocks. */
+	tmp_dom_info *tdi_list;
+	int           used;
+} dom_region_t;
+
+/**
+ * Callback for the control flow predecessors of a block as seen by the
+ * dominance computation.
+ */
+typedef void dom_pred_func(void *env, ir_node *block, ir_node *pred_block);
+
+/**
+ * Calls @p func for each control flow predecessor of @p block, including the
+ * keep-alive edges of the end block.
+ */
+static void foreach_dom_pred(void *env, ir_node *block, dom_pred_func *func)
+{
+	foreach_irn_in(block, i, pred) {
+		if (!is_Bad(pred))
+			func(env, block, get_nodes_block(pred));
+	}
+
+	ir_graph *irg = get_irn_irg(block);
+	if (block == get_irg_end_block(irg)) {
+		foreach_irn_in(get_irg_end(irg), i, pred) {
+			if (is_Block(pred))
+				func(env, block, pred);
+		}
+	}
+}
+
+static bool is_in_region(const dom_region_t *region, const ir_node *block)
+{
+	/* blocks created after the dominance computation have depth 0 */
+	return get_Block_dom_depth(block) > 0 && block_dominates(region->root, block);
+}
+
+static unsigned get_region_idx(const dom_region_t *region,
+                               const ir_node *block)
+{
+	return get_dom_info_const(block)->tree_pre_num - region->base;
+}
+
+static void collect_region_block(ir_node *block, void *data)
+{
+	dom_region_t *region = (dom_region_t*)data;
+	region->blocks[get_region_idx(region, block)] = block;
+}
+
+static void count_region_succ(void *env, ir_node *block, ir_node *pred_block)
+{
+	dom_region_t *region = (dom_region_t*)env;
+	(void)block;
+	if (is_in_region(region, pred_block)) {
+		++region->succ_begin[get_region_idx(region, pred_block) + 1];
+	} else {
+		/* all reachable predecessors are inside the region, so this one is
+		 * dead: make sure compute_idoms() ignores it */
+		set_Block_dom_pre_num(pred_block, -1);
+	}
+}
+
+static void add_region_succ(void *env, ir_node *block, ir_node *pred_block)
+{
+	dom_region_t *region = (dom_region_t*)env;
+	if (is_in_region(region, pred_block)) {
+		unsigned const pred_idx = get_region_idx(region, pred_block);
+		region->succs[region->succ_begin[pred_idx]++] = get_region_idx(region, block);
+	}
+}
+
+/**
+ * Numbers the blocks of a region in depth-first order, like
+ * init_tmp_dom_info().
+ */
+static void init_tmp_dom_info_region(dom_region_t *region)
+{
+	int const          n_blocks = (int)region->size;
+	dfs_frame_t *const stack    = XMALLOCN(dfs_frame_t, n_blocks);
+	int                tos      = 0;
+
+	ir_node *const root = region->blocks[0];
+	set_Block_dom_pre_num(root, region->used);
+	stack[tos].tdi = init_tmp_info(root, NULL, region->tdi_list,
+	                               &region->used, n_blocks, 0);
+	stack[tos].pos = (int)region->succ_begin[0];
+	++tos;
+	while (tos > 0) {
+		dfs_frame_t   *const frame = &stack[tos - 1];
+		unsigned const       idx   = get_region_idx(region, frame->tdi->block);
+		int const            begin = idx > 0 ? (int)region->succ_begin[idx - 1] : 0;
+		if (frame->pos == begin) {
+			--tos;
+			continue;
+		}
+
+		ir_node *const succ = region->blocks[region->succs[--frame->pos]];
+		if (get_Block_dom_pre_num(succ) != -1)
+			continue;
+
+		assert(tos < n_blocks);
+		set_Block_dom_pre_num(succ, region->used);
+		unsigned const succ_idx = get_region_idx(region, succ);
+		stack[tos].tdi = init_tmp_info(succ, frame->tdi, region->tdi_list,
+		                               &region->used, n_blocks, 0);
+		stack[tos].pos = (int)region->succ_begin[succ_idx];
+		++tos;
+	}
+	free(stack);
+}
+
+/**
+ * Recomputes the dominance information of the dominator subtree rooted at
+ * @p root after a control flow edge inside it changed.  This relies on all
+ * reachable predecessors of a block strictly dominated by @p root being
+ * dominated by @p root as well, which holds if the old dominator tree is
+ * consistent with the graph up to the changed edge.  The root keeps its
+ * dominator.
+ */
+static void recompute_dom_subtree(ir_node *root)
+{
+	ir_graph     *irg  = get_irn_irg(root);
+	ir_dom_info  *ri   = get_dom_info(root);
+	unsigned      base = ri->tree_pre_num;
+	unsigned      size = ri->max_subtree_pre_num - base + 1;
+	dom_region_t  region = {
+		.root       = root,
+		.base       = base,
+		.size       = size,
+		.blocks     = XMALLOCNZ(ir_node*, size),
+		.succ_begin = XMALLOCNZ(unsigned, size + 1),
+		.tdi_list   = XMALLOCN(tmp_dom_info, size),
+		.used       = 0,
+	};
+	dom_tree_walk(root, collect_region_block, NULL, &region);
+
+	/* Build the successor lists of the subtree from the predecessors, the out
+	 * edges are usually not up to date at this point. */
+	for (unsigned i = 0; i < size; ++i) {
+		if (region.blocks[i] != NULL)
+			foreach_dom_pred(&region, region.blocks[i], count_region_succ);
+	}
+	for (unsigned i = 1; i <= size; ++i)
+		region.succ_begin[i] += region.succ_begin[i - 1];
+	region.succs = XMALLOCN(unsigned, region.succ_begin[size]);
+	/* add_region_succ() advances succ_begin[i] to the end of the successors of
+	 * block i, which is the begin of the successors of block i + 1. */
+	for (unsigned i = 0; i < size; ++i) {
+		if (region.blocks[i] != NULL)
+			foreach_dom_pred(&region, region.blocks[i], add_region_succ);
+	}
+
+	/* Unlink the subtree; the root stays in the child list of its idom. */
+	for (unsigned i = 0; i < size; ++i) {
+		ir_node *block = region.blocks[i];
+		if (block == NULL)
+			continue;
+		set_Block_dom_pre_num(block, -1);
+		get_dom_info(block)->first = NULL;
+	}
+
+	init_tmp_dom_info_region(&region);
+	for (unsigned i = 1; i < size; ++i) {
+		ir_node *block = region.blocks[i];
+		if (block != NULL && get_Block_dom_pre_num(block) == -1)
+			clear_dom_info(block);
+	}
+	compute_idoms(irg, region.tdi_list, region.used);
+
+	unsigned tree_pre_order = base;
+	dom_tree_walk(root, assign_tree_dom_pre_order,
+	              assign_tree_dom_pre_order_max, &tree_pre_order);
+
+	free(region.succs);
+	free(region.tdi_list);
+	free(region.succ_begin);
+	free(region.blocks);
+}
+
+#define NO_IDOM ((unsigned)-1)
+
+/** A block of the reference dominance computation of verify_dom_update(). */
+typedef struct dom_ref_t {
+	ir_node  *block;
+	unsigned *preds; /**< indices of the predecessors */
+	unsigned *succs; /**< indices of the successors */
+	int       rpo;   /**< reverse post-order number, -1 if unreachable */
+	unsigned  idom;  /**< index of the immediate dominator, NO_IDOM if not
+	                      computed yet */
+	int       depth;
+} dom_ref_t;
+
+typedef struct dom_ref_env_t {
+	dom_ref_t  *refs;
+	ir_nodemap  map;
+} dom_ref_env_t;
+
+static void collect_ref_block(ir_node *block, void *data)
+{
+	dom_ref_env_t *env = (dom_ref_env_t*)data;
+	dom_ref_t      ref = {
+		.block = block,
+		.preds = NEW_ARR_F(unsigned, 0),
+		.succs = NEW_ARR_F(unsigned, 0),
+		.rpo   = -1,
+		.idom  = NO_IDOM,
+	};
+	ARR_APP1(dom_ref_t, env->refs, ref);
+}
+
+static void add_ref_edge(void *data, ir_node *block, ir_node *pred_block)
+{
+	dom_ref_env_t *env  = (dom_ref_env_t*)data;
+	dom_ref_t     *ref  = ir_nodemap_get(dom_ref_t, &env->map, block);
+	dom_ref_t     *pred = ir_nodemap_get(dom_ref_t, &env->map, pred_block);
+	ARR_APP1(unsigned, ref->preds, (unsigned)(pred - env->refs));
+	ARR_APP1(unsigned, pred->succs, (unsigned)(ref - env->refs));
+}
+
+/**
+ * Compares the incrementally updated dominance information of @p irg with a
+ * full recomputation.  The reference uses the iterative algorithm of Cooper,
+ * Harvey and Kennedy on the block inputs, so it neither shares code with the
+ * update nor touches the out edges or the node visited flags of a graph that
+ * is being transformed.
+ */
+static void verify_dom_update(ir_graph *irg)
+{
+	dom_ref_env_t env;
+	env.refs = NEW_ARR_F(dom_ref_t, 0);
+	irg_block_walk_graph(irg, collect_ref_block, NULL, &env);
+	/* the walk misses the start block if all its successors are dead */
+	ir_node *const start_block = get_irg_start_block(irg);
+	if (!Block_block_visited(start_block))
+		collect_ref_block(start_block, &env);
+	unsigned const n_refs = ARR_LEN(env.refs);
+	ir_nodemap_init(&env.map, irg);
+	for (unsigned i = 0; i < n_refs; ++i)
+		ir_nodemap_insert(&env.map, env.refs[i].block, &env.refs[i]);
+	for (unsigned i = 0; i < n_refs; ++i)
+		foreach_dom_pred(&env, env.refs[i].block, add_ref_edge);
+
+	/* number the reachable blocks in reverse post-order */
+	dom_ref_t  *start = ir_nodemap_get(dom_ref_t, &env.map, start_block);
+	unsigned   *order = XMALLOCN(unsigned, n_refs);
+	unsigned   *stack = XMALLOCN(unsigned, n_refs);
+	unsigned   *pos   = XMALLOCNZ(unsigned, n_refs);
+	unsigned    n_po  = 0;
+	unsigned    tos   = 0;
+	stack[tos++] = start - env.refs;
+	start->rpo   = 0;
+	while (tos > 0) {
+		unsigned   const idx = stack[tos - 1];
+		dom_ref_t *const ref = &env.refs[idx];
+		if (pos[idx] < ARR_LEN(ref->succs)) {
+			unsigned const succ = ref->succs[pos[idx]++];
+			if (env.refs[succ].rpo < 0) {
+				env.refs[succ].rpo = 0;
+				stack[tos++] = succ;
+			}
+			continue;
+		}
+		order[n_po++] = idx;
+		--tos;
+	}
+	for (unsigned i = 0; i < n_po; ++i)
+		env.refs[order[i]].rpo = n_po - 1 - i;
+
+	/* intersect the dominators of the predecessors until nothing changes */
+	start->idom  = start - env.refs;
+	start->depth = 1;
+	bool changed;
+	do {
+		changed = false;
+		for (unsigned i = n_po - 1; i-- > 0;) {
+			dom_ref_t *const ref  = &env.refs[order[i]];
+			unsigned         idom = NO_IDOM;
+			for (size_t p = 0, n = ARR_LEN(ref->preds); p < n; ++p) {
+				unsigned pred = ref->preds[p];
+				if (env.refs[pred].idom == NO_IDOM)
+					continue;
+				if (idom == NO_IDOM) {
+					idom = pred;
+					continue;
+				}
+				while (pred != idom) {
+					while (env.refs[pred].rpo > env.refs[idom].rpo)
+						pred = env.refs[pred].idom;
+					while (env.refs[idom].rpo > env.refs[pred].rpo)
+						idom = env.refs[idom].idom;
+				}
+			}
+			if (ref->idom != idom) {
+				ref->idom = idom;
+				changed   = true;
+			}
+		}
+	} while (changed);
+	for (unsigned i = n_po - 1; i-- > 0;) {
+		dom_ref_t *const ref = &env.refs[order[i]];
+		ref->depth = env.refs[ref->idom].depth + 1;
+	}
+
+	bool fine = true;
+	for (unsigned i = 0; i < n_refs; ++i) {
+		dom_ref_t const *const ref   = &env.refs[i];
+		ir_node         *const block = ref->block;
+		ir_node         *const idom  = ref->rpo < 0 || ref == start
+		                               ? NULL : env.refs[ref->idom].block;
+		int              const depth = ref->rpo < 0 ? -1 : ref->depth;
+		/* blocks without dominance information count as unreachable */
+		int const actual_depth = get_Block_dom_depth(block) == 0
+		                         ? -1 : get_Block_dom_depth(block);
+		ir_node *const actual_idom = actual_depth < 0
+		                             ? NULL : get_dom_info(block)->idom;
+		if (idom != actual_idom || depth != actual_depth) {
+			ir_fprintf(stderr, "Dominance Verifier: %+F has idom %+F (depth %d), expected %+F (depth %d)\n",
+			           block, actual_idom, actual_depth, idom, depth);
+			fine = false;
+		}
+		DEL_ARR_F(ref->succs);
+		DEL_ARR_F(ref->preds);
+	}
+	free(pos);
+	free(stack);
+	free(order);
+	ir_nodemap_destroy(&env.map);
+	DEL_ARR_F(env.refs);
+
+	if (!fine)
+		panic("incremental dominance update of %+F failed", irg);
+}
+
+/**
+ * Adds the new block @p block without successors as a leaf below @p idom to
+ * the dominator tree.
+ */
+static void add_dom_leaf(ir_node *idom, ir_node *block)
+{
+	clear_dom_info(block);
+	set_Block_idom(block, idom);
+	set_Block_dom_depth(block, get_Block_dom_depth(idom) + 1);
+
+	/* The tree pre-order numbers of all blocks after the leaf move. */
+	ir_graph *irg            = get_irn_irg(block);
+	unsigned  tree_pre_order = 0;
+	dom_tree_walk(get_irg_start_block(irg), assign_tree_dom_pre_order,
+	              assign_tree_dom_pre_order_max, &tree_pre_order);
+}
+
+void ir_dom_insert_edge(ir_node *from, ir_node *to)
+{
+	ir_graph *irg = get_irn_irg(to);
+	assert(irg_has_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE));
+	ir_free_dominance_frontiers(irg);
+
+	if (get_Block_dom_depth(from) <= 0) {
+		/* An edge from dead code does not change anything. */
+		if (get_Block_dom_depth(to) == 0)
+			clear_dom_info(to);
+	} else if (get_Block_dom_depth(to) == 0) {
+		/* A block created after the dominance computation. */
+		add_dom_leaf(from, to);
+	} else if (get_Block_dom_depth(to) < 0) {
+		/* Dead code became reachable, the new blocks are not in the tree. */
+		clear_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUTS);
+		compute_doms(irg);
+		return;
+	} else {
+		/* Only blocks strictly dominated by the nearest common dominator
+		 * can get a new idom, and only if the idom of to changes. */
+		ir_node *nca = ir_deepest_common_dominator(from, to);
+		if (nca != to && nca != get_Block_idom(to))
+			recompute_dom_subtree(nca);
+	}
+
+	if (dom_dbg)
+		verify_dom_update(irg);
+}
+
+/**
+ * Checks whether @p block is still reachable after one of its incoming edges
+ * has been removed, i.e. whether it has a reachable predecessor it does not
+ * dominate.  Sets @p *has_from if @p from is still a predecessor.
+ */
+static bool has_proper_support(ir_node *block, const ir_node *from,
+                               bool *has_from)
+{
+	bool      support  = false;
+	ir_graph *irg      = get_irn_irg(block);
+	bool      is_end   = block == get_irg_end_block(irg);
+	int       n_preds  = get_Block_n_cfgpreds(block);
+	int       n_kas    = is_end ? get_End_n_keepalives(get_irg_end(irg)) : 0;
+	*has_from = false;
+	for (int i = 0; i < n_preds + n_kas; ++i) {
+		ir_node *pred;
+		if (i < n_preds) {
+			pred = get_Block_cfgpred_block(block, i);
+		} else {
+			pred = get_End_keepalive(get_irg_end(irg), i - n_preds);
+			if (!is_Block(pred))
+				continue;
+		}
+		if (pred == NULL || get_Block_dom_depth(pred) <= 0)
+			continue;
+		if (pred == from)
+			*has_from = true;
+		if (!block_dominates(block, pred))
+			support = true;
+	}
+	return support;
+}
+
+void ir_dom_delete_edge(ir_node *from, ir_node *to)
+{
+	ir_graph *irg = get_irn_irg(to);
+	assert(irg_has_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE));
+	assert(to != get_irg_start_block(irg));
+	ir_free_dominance_frontiers(irg);
+
+	bool has_from;
+	if (get_Block_dom_depth(from) <= 0 || get_Block_dom_depth(to) <= 0) {
+		/* Edges in dead code do not matter. */
+	} else if (block_dominates(to, from)) {
+		/* Every path over a back edge already passed to. */
+	} else if (!has_proper_support(to, from, &has_from)) {
+		/* The dominator subtree of to became dead; this may change the
+		 * idoms of blocks anywhere below the successors of the subtree, so
+		 * rebuild the whole tree. No block becomes reachable, hence the
+		 * blocks of the old tree suffice. */
+		recompute_dom_subtree(get_irg_start_block(irg));
+	} else if (!has_from) {
+		/* Only blocks dominated by the nearest common dominator of the edge,
+		 * which is the idom of to, are affected. */
+		recompute_dom_subtree(get_Block_idom(to));
+	}
+
+	if (dom_dbg)
+		verify_dom_update(irg);
+}
+
+void dom_init_dbg(int do_dbg)
+{
+	dom_dbg = do_dbg;
+}
+
+static void update_pdom_semi(tmp_dom_info *tdi_list, tmp_dom_info **path,
+                             tmp_dom_info *w, ir_node *succ_block)
 {
 	assert(is_Block(succ_block));
 	const int           pre_num = get_Block_postdom_pre_num(succ_block);
 	assert(pre_num != -1);
-	const tmp_dom_info *u       = dom_eval(&tdi_list[pre_num]);
+	const tmp_dom_info *u       = dom_eval(&tdi_list[pre_num], path);
 	if (u->semi < w->semi) {
 		w->semi = u->semi;
 	}
@@ -638,11 +1196,13 @@ void compute_postdoms(ir_graph *irg)
 	inc_irg_block_visited(irg);
 	int used = 0;
 	ir_node *end_block = get_irg_end_block(irg);
-	init_tmp_pdom_info(end_block, NULL, tdi_list, &used, n_blocks, 0);
+	init_tmp_pdom_info(end_block, tdi_list, &used, n_blocks);
 	ir_free_resources(irg, IR_RESOURCE_BLOCK_VISITED);
 	assert(used <= n_blocks);
 	n_blocks = used;
 
+	tmp_dom_info **const path = XMALLOCN(tmp_dom_info*, n_blocks);
+
 	for (int i = n_blocks; i-- > 1; ) {  /* Don't iterate the root, it's done. */
 		tmp_dom_info *w = &tdi_list[i];
 
@@ -656,11 +1216,11 @@ void compute_postdoms(ir_graph *irg)
 				if (unreachable && end_block != block)
 					/* Handle keep-alive edges to unreachable
 					 * blocks as normal control flow. */
-					update_pdom_semi(tdi_list, w, end_block);
+					update_pdom_semi(tdi_list, path, w, end_block);
 				continue;
 			}
 			foreach_irn_out(succ, k, succ_block) {
-				update_pdom_semi(tdi_list, w, succ_block);
+				update_pdom_semi(tdi_list, path, w, succ_block);
 			}
 		}
 
@@ -678,13 +1238,15 @@ void compute_postdoms(ir_graph *irg)
 			w->parent->bucket = v->bucket;
 			v->bucket         = NULL;
 
-			tmp_dom_info *u = dom_eval(v);
+			tmp_dom_info *u = dom_eval(v, path);
 			if (u->semi < v->semi)
 				v->dom = u;
 			else
 				v->dom = w->parent;
 		}
 	}
+	free(path);
+
 	/* Step 4 */
 	tdi_list[0].dom = NULL;
 	set_Block_ipostdom(tdi_list[0].block, NULL);
@@ -41,18 +41,26 @@ void add_loop_irg(ir_loop *loop, ir_graph *irg)
 
 void mature_loops(ir_loop *loop, struct obstack *obst)
 {
-	loop_element *new_children = DUP_ARR_D(loop_element, obst, loop->children);
-	DEL_ARR_F(loop->children);
-	loop->children = new_children;
-
-	/* mature child loops */
-	for (size_t i = ARR_LEN(new_children); i-- > 0;) {
-		loop_element child = new_children[i];
-
-		if (*child.kind == k_ir_loop) {
-			mature_loops(child.son, obst);
+	/* loop trees can be deep, so keep the loops to mature on a stack */
+	ir_loop **todo = NEW_ARR_F(ir_loop*, 1);
+	todo[0] = loop;
+	while (ARR_LEN(todo) > 0) {
+		ir_loop *const l = todo[ARR_LEN(todo) - 1];
+		ARR_SHRINKLEN(todo, ARR_LEN(todo) - 1);
+
+		loop_element *new_children = DUP_ARR_D(loop_element, obst, l->children);
+		DEL_ARR_F(l->children);
+		l->children = new_children;
+
+		/* mature child loops */
+		for (size_t i = ARR_LEN(new_children); i-- > 0;) {
+			loop_element child = new_children[i];
+
+			if (*child.kind == k_ir_loop)
+				ARR_APP1(ir_loop*, todo, child.son);
 		}
 	}
+	DEL_ARR_F(todo);
 }
 
 ir_loop *(get_loop_outer_loop)(const ir_loop *loop)
@@ -140,18 +148,13 @@ ir_loop *alloc_loop(ir_loop *father, struct obstack *obst)
 	return son;
 }
 
+/** Returns true if loop @p b is @p l or nested in it. */
 static bool is_loop_variant(ir_loop *l, ir_loop *b)
 {
-	if (l == b)
-		return true;
-
-	for (size_t i = 0, n_elems = get_loop_n_elements(l); i < n_elems; ++i) {
-		loop_element e = get_loop_element(l, i);
-		if (is_ir_loop(e.kind) && is_loop_variant(e.son, b))
-			return true;
-	}
-
-	return false;
+	unsigned const depth = get_loop_depth(l);
+	while (b != NULL && get_loop_depth(b) > depth)
+		b = get_loop_outer_loop(b);
+	return b == l;
 }
 
 int is_loop_invariant(const ir_node *n, const ir_node *block)
@@ -19,10 +19,13 @@
 #include "irgraph_t.h"
 #include "irgwalk.h"
 #include "irnode_t.h"
+#include "irnodemap.h"
 #include "irouts_t.h"
 #include "irprintf.h"
 #include "irprog_t.h"
 #include "panic.h"
+#include "set.h"
+#include "statev_t.h"
 #include "type_t.h"
 #include "typerep.h"
 #include "util.h"
@@ -36,6 +39,12 @@ DEBUG_ONLY(static firm_dbg_module_t *dbgcall = NULL;)
 /** The global memory disambiguator options. */
 static unsigned global_mem_disamgig_opt = aa_opt_none;
 
+/**
+ * Incremented whenever entity usage flags or points-to classes are recomputed,
+ * as the cached alias relations depend on them.
+ */
+static unsigned analysis_epoch;
+
 const char *get_ir_alias_relation_name(ir_alias_relation rel)
 {
 #define X(a) case a: return #a
@@ -294,60 +303,203 @@ follow_ptr:
 	}
 }
 
-static ir_alias_relation _get_alias_relation(const ir_node *addr1, const ir_type *const objt1, unsigned size1,
-                                             const ir_node *addr2, const ir_type *const objt2, unsigned size2)
+/** A decomposed address, as needed to answer alias queries. */
+typedef struct decomposed_address_t {
+	ir_node const           *addr;       /**< the decomposed address */
+	address_info             info;       /**< base, symbolic and constant
+	                                          offset */
+	bool                     classified; /**< base, ent and sc are valid */
+	ir_node const           *base;       /**< info.base with Sels/Members
+	                                          skipped */
+	ir_entity               *ent;        /**< the outermost selected entity */
+	ir_storage_class_class_t sc;         /**< classification of info.base */
+} decomposed_address_t;
+
+static void decompose_address(ir_node const *const addr,
+                              decomposed_address_t *const res)
 {
-	if (addr1 == addr2)
-		return ir_sure_alias;
-	ir_graph *const irg     = get_irn_irg(addr1);
-	unsigned  const options = get_irg_memory_disambiguator_options(irg);
-	if (options & aa_opt_always_alias)
-		return ir_may_alias;
-	/* The Armageddon switch */
-	if (options & aa_opt_no_alias)
-		return ir_no_alias;
+	res->addr       = addr;
+	res->info       = get_address_info(addr);
+	res->classified = false;
+}
 
-	/* do the addresses have constants offsets from the same base?
-	 *  Note: sub X, C is normalized to add X, -C */
-
-	/*
-	 * Currently, only expressions with at most one symbolic
-	 * offset can be handled.  To extend this, change
-	 * sym_offset to be a set, and compare the sets.
-	 */
-	address_info const info1   = get_address_info(addr1);
-	address_info const info2   = get_address_info(addr2);
-	long               offset1 = info1.offset;
-	long               offset2 = info2.offset;
-	addr1 = info1.base;
-	addr2 = info2.base;
-
-	/* same base address -> compare offsets if possible.
-	 * FIXME: type long is not sufficient for this task ... */
-	if (addr1 == addr2 && info1.sym_offset == info2.sym_offset && info1.has_const_offset && info2.has_const_offset) {
-		unsigned long first_offset;
-		unsigned long last_offset;
-		unsigned first_size;
-
-		if (offset1 <= offset2) {
-			first_offset = offset1;
-			last_offset = offset2;
-			first_size = size1;
-		} else {
-			first_offset = offset2;
-			last_offset = offset1;
-			first_size = size2;
-		}
+static void classify_address(decomposed_address_t *const res)
+{
+	if (res->classified)
+		return;
+	res->ent        = NULL;
+	res->base       = find_base_addr(res->info.base, &res->ent);
+	res->sc         = classify_pointer(res->info.base, res->base);
+	res->classified = true;
+}
+
+/** A memoized alias query. */
+typedef struct alias_query_t {
+	ir_node const    *addr1;
+	ir_node const    *addr2;
+	ir_type const    *type1;
+	ir_type const    *type2;
+	unsigned          size1;
+	unsigned          size2;
+	ir_alias_relation rel;
+} alias_query_t;
+
+/**
+ * Per graph cache of decomposed addresses and alias relations. The cache is
+ * valid as long as the graph has IR_GRAPH_PROPERTY_CONSISTENT_ALIAS_INFO.
+ * Transformations replacing nodes by equivalent ones do not change the
+ * relation between two addresses, so the cache survives within a pass.
+ */
+struct ir_alias_info {
+	struct obstack obst;
+	ir_nodemap     addresses;   /**< decomposed_address_t per address */
+	set           *queries;     /**< memoized alias_query_t */
+	unsigned       options;     /**< disambiguator options of the results */
+	unsigned       usage_epoch; /**< analysis_epoch of the results */
+	unsigned long  n_queries;
+	unsigned long  n_query_hits;
+	unsigned long  n_addresses;
+	unsigned long  n_address_hits;
+};
+
+static int alias_query_cmp(void const *const elt, void const *const key,
+                           size_t const size)
+{
+	(void)size;
+	alias_query_t const *const q1 = (alias_query_t const*)elt;
+	alias_query_t const *const q2 = (alias_query_t const*)key;
+	return q1->addr1 != q2->addr1 || q1->addr2 != q2->addr2
+	    || q1->type1 != q2->type1 || q1->type2 != q2->type2
+	    || q1->size1 != q2->size1 || q1->size2 != q2->size2;
+}
+
+static unsigned hash_alias_query(alias_query_t const *const query)
+{
+	unsigned hash = hash_combine(hash_ptr(query->addr1), hash_ptr(query->addr2));
+	hash = hash_combine(hash, hash_ptr(query->type1));
+	hash = hash_combine(hash, hash_ptr(query->type2));
+	return hash_combine(hash, query->size1 * 31 + query->size2);
+}
+
+void free_irg_alias_info(ir_graph *const irg)
+{
+	ir_alias_info *const info = irg->alias_info;
+	if (info == NULL)
+		return;
+	DB((dbg, LEVEL_1, "alias cache of %+F: %lu/%lu queries, %lu/%lu addresses cached\n",
+	    irg, info->n_query_hits, info->n_queries, info->n_address_hits,
+	    info->n_addresses));
+	stat_ev_ull("alias_cache_queries",      info->n_queries);
+	stat_ev_ull("alias_cache_query_hits",   info->n_query_hits);
+	stat_ev_ull("alias_cache_addresses",    info->n_addresses);
+	stat_ev_ull("alias_cache_address_hits", info->n_address_hits);
+
+	del_set(info->queries);
+	ir_nodemap_destroy(&info->addresses);
+	obstack_free(&info->obst, NULL);
+	free(info);
+	irg->alias_info = NULL;
+	clear_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_ALIAS_INFO);
+}
+
+void assure_irg_alias_info(ir_graph *const irg)
+{
+	unsigned const options = get_irg_memory_disambiguator_options(irg);
+	ir_alias_info *info    = irg->alias_info;
+	if (info != NULL
+	    && irg_has_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_ALIAS_INFO)
+	    && info->options == options && info->usage_epoch == analysis_epoch)
+		return;
+
+	free_irg_alias_info(irg);
+	info = XMALLOCZ(ir_alias_info);
+	obstack_init(&info->obst);
+	ir_nodemap_init(&info->addresses, irg);
+	info->queries     = new_set(alias_query_cmp, 64);
+	info->options     = options;
+	info->usage_epoch = analysis_epoch;
+	irg->alias_info   = info;
+	add_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_ALIAS_INFO);
+}
+
+static decomposed_address_t *get_decomposed_address(ir_alias_info *const info,
+                                                    ir_node const *const addr)
+{
+	++info->n_addresses;
+	decomposed_address_t *res
+		= ir_nodemap_get(decomposed_address_t, &info->addresses, addr);
+	if (res != NULL && res->addr == addr) {
+		++info->n_address_hits;
+		return res;
+	}
+	if (res == NULL) {
+		res = OALLOC(&info->obst, decomposed_address_t);
+		ir_nodemap_insert(&info->addresses, addr, res);
+	}
+	decompose_address(addr, res);
+	return res;
+}
+
+/**
+ * Returns whether the addresses have constant offsets from the same base.
+ * Note: sub X, C is normalized to add X, -C
+ *
+ * Currently, only expressions with at most one symbolic offset can be
+ * handled.  To extend this, change sym_offset to be a set, and compare the
+ * sets.
+ */
+static bool have_same_base(address_info const *const info1,
+                           address_info const *const info2)
+{
+	return info1->base == info2->base
+	    && info1->sym_offset == info2->sym_offset
+	    && info1->has_const_offset && info2->has_const_offset;
+}
 
-		return first_offset + first_size <= last_offset
-		     ? ir_no_alias : ir_sure_alias;
+/**
+ * Compares the accessed ranges of two addresses with the same base.
+ * FIXME: type long is not sufficient for this task ...
+ */
+static ir_alias_relation compare_offsets(address_info const *const info1,
+                                         unsigned const size1,
+                                         address_info const *const info2,
+                                         unsigned const size2)
+{
+	unsigned long first_offset;
+	unsigned long last_offset;
+	unsigned      first_size;
+	if (info1->offset <= info2->offset) {
+		first_offset = info1->offset;
+		last_offset  = info2->offset;
+		first_size   = size1;
+	} else {
+		first_offset = info2->offset;
+		last_offset  = info1->offset;
+		first_size   = size2;
 	}
 
+	return first_offset + first_size <= last_offset
+	     ? ir_no_alias : ir_sure_alias;
+}
+
+/**
+ * Determines the alias relation of two classified addresses, which are not
+ * constant offsets from the same base.
+ */
+static ir_alias_relation _get_alias_relation(decomposed_address_t const *const addr_info1,
+                                             const ir_type *const objt1, unsigned size1,
+                                             decomposed_address_t const *const addr_info2,
+                                             const ir_type *const objt2, unsigned size2,
+                                             unsigned const options)
+{
+	long offset1 = addr_info1->info.offset;
+	long offset2 = addr_info2->info.offset;
+
 	/* skip Sels/Members */
-	ir_entity     *ent1  = NULL;
-	ir_entity     *ent2  = NULL;
-	const ir_node *base1 = find_base_addr(addr1, &ent1);
-	const ir_node *base2 = find_base_addr(addr2, &ent2);
+	ir_entity     *ent1  = addr_info1->ent;
+	ir_entity     *ent2  = addr_info2->ent;
+	const ir_node *base1 = addr_info1->base;
+	const ir_node *base2 = addr_info2->base;
 
 	/* two struct accesses -> compare entities */
 	if (ent1 != NULL && ent2 != NULL) {
@@ -380,8 +532,8 @@ static ir_alias_relation _get_alias_relation(const ir_node *addr1, const ir_type
 
 check_classes:;
 	/* no alias if 1 is a primitive object and the other a compound object */
-	const ir_storage_class_class_t mod1 = classify_pointer(addr1, base1);
-	const ir_storage_class_class_t mod2 = classify_pointer(addr2, base2);
+	const ir_storage_class_class_t mod1 = addr_info1->sc;
+	const ir_storage_class_class_t mod2 = addr_info2->sc;
 	if (((mod1 | mod2) & (ir_sc_modifier_obj_comp | ir_sc_modifier_obj_prim))
 	    == (ir_sc_modifier_obj_comp | ir_sc_modifier_obj_prim))
 		return ir_no_alias;
@@ -474,10 +626,74 @@ leave_type_based_alias:;
 	return ir_may_alias;
 }
 
+static ir_alias_relation get_cached_alias_relation(
+		const ir_node *addr1, const ir_type *type1, unsigned size1,
+		const ir_node *addr2, const ir_type *type2, unsigned size2)
+{
+	if (addr1 == addr2)
+		return ir_sure_alias;
+	ir_graph *const irg     = get_irn_irg(addr1);
+	unsigned  const options = get_irg_memory_disambiguator_options(irg);
+	if (options & aa_opt_always_alias)
+		return ir_may_alias;
+	/* The Armageddon switch */
+	if (options & aa_opt_no_alias)
+		return ir_no_alias;
+
+	assure_irg_alias_info(irg);
+	ir_alias_info        *const info       = irg->alias_info;
+	decomposed_address_t *      addr_info1 = get_decomposed_address(info, addr1);
+	decomposed_address_t *      addr_info2 = get_decomposed_address(info, addr2);
+
+	/* same base address -> compare offsets, this is cheap enough to not
+	 * memoize it */
+	if (have_same_base(&addr_info1->info, &addr_info2->info))
+		return compare_offsets(&addr_info1->info, size1, &addr_info2->info, size2);
+
+	/* the relation is symmetric, so order the query to find both */
+	if (get_irn_idx(addr1) > get_irn_idx(addr2)) {
+		decomposed_address_t *const addr_info = addr_info1;
+		addr_info1 = addr_info2;
+		addr_info2 = addr_info;
+		const ir_type *const type = type1;
+		type1 = type2;
+		type2 = type;
+		unsigned const size = size1;
+		size1 = size2;
+		size2 = size;
+	}
+	alias_query_t query = {
+		.addr1 = addr_info1->addr, .addr2 = addr_info2->addr,
+		.type1 = type1,            .type2 = type2,
+		.size1 = size1,            .size2 = size2,
+	};
+	unsigned const hash = hash_alias_query(&query);
+	++info->n_queries;
+	alias_query_t const *const cached
+		= set_find(alias_query_t, info->queries, &query, sizeof(query), hash);
+	if (cached != NULL) {
+		++info->n_query_hits;
+		return cached->rel;
+	}
+
+	classify_address(addr_info1);
+	classify_address(addr_info2);
+	query.rel = _get_alias_relation(addr_info1, type1, size1, addr_info2, type2, size2, options);
+	if (query.rel == ir_may_alias && (options & aa_opt_points_to))
+		query.rel = get_points_to_relation(addr_info1->addr, addr_info2->addr);
+	(void)set_insert(alias_query_t, info->queries, &query, sizeof(query), hash);
+	return query.rel;
+}
+
+void invalidate_irp_alias_info(void)
+{
+	++analysis_epoch;
+}
+
 ir_alias_relation get_alias_relation(const ir_node *const addr1, const ir_type *const type1, unsigned size1,
                                      const ir_node *const addr2, const ir_type *const type2, unsigned size2)
 {
-	ir_alias_relation rel = _get_alias_relation(addr1, type1, size1, addr2, type2, size2);
+	ir_alias_relation rel = get_cached_alias_relation(addr1, type1, size1, addr2, type2, size2);
 	DB((dbg, LEVEL_1, "alias(%+F, %+F) = %s\n", addr1, addr2,
 	    get_ir_alias_relation_name(rel)));
 	return rel;
@@ -664,6 +880,7 @@ static void analyse_irg_entity_usage(ir_graph *irg)
 
 	/* now computed */
 	add_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE);
+	++analysis_epoch;
 }
 
 void assure_irg_entity_usage_computed(ir_graph *irg)
@@ -847,6 +1064,7 @@ static void analyse_irp_globals_entity_usage(void)
 
 	/* now computed */
 	irp->globals_entity_usage_state = ir_entity_usage_computed;
+	++analysis_epoch;
 }
 
 ir_entity_usage_computed_state get_irp_globals_entity_usage_state(void)
@@ -22,6 +22,34 @@ void firm_init_memory_disambiguator(void);
 
 bool is_partly_volatile(ir_node *ptr);
 
+/**
+ * Makes sure the alias query cache of @p irg exists and is valid for the
+ * current disambiguator options and entity usage information.
+ */
+void assure_irg_alias_info(ir_graph *irg);
+
+/** Frees the alias query cache of @p irg. */
+void free_irg_alias_info(ir_graph *irg);
+
+/**
+ * Invalidates the memoized alias queries of all graphs, needed when
+ * information they depend on is recomputed.
+ */
+void invalidate_irp_alias_info(void);
+
+/**
+ * Returns ir_no_alias if the points-to analysis shows that @p addr1 and
+ * @p addr2 point to different objects, ir_may_alias otherwise.
+ */
+ir_alias_relation get_points_to_relation(const ir_node *addr1,
+                                         const ir_node *addr2);
+
+/**
+ * Frees the points-to classes of the nodes of @p irg, needed when its nodes
+ * are renumbered.
+ */
+void free_irg_points_to(ir_graph *irg);
+
 /**
  * Classify storage locations.
  * Except ir_sc_pointer they are all disjoint.
@@ -11,6 +11,7 @@
  */
 #include "irouts_t.h"
 
+#include "array.h"
 #include "ircons.h"
 #include "irgraph_t.h"
 #include "irgwalk.h"
@@ -227,21 +228,50 @@ void irg_out_block_walk(ir_node *node, irg_walk_func *pre, irg_walk_func *post,
 /*--------------------------------------------------------------------*/
 
 
-/** Returns the amount of out edges for not yet visited successors. */
-static void count_outs_node(ir_node *n)
+/**
+ * A node on the explicit stack of the out edge construction with the input
+ * to handle next.
+ */
+typedef struct outs_frame_t {
+	ir_node *node;
+	int      pos;
+	bool     descended; /**< the input at pos was already descended into */
+} outs_frame_t;
+
+static outs_frame_t *push_outs_frame(outs_frame_t *stack, ir_node *node)
 {
-	if (irn_visited_else_mark(n))
-		return;
+	outs_frame_t const frame = { node, is_Block(node) ? 0 : -1, false };
+	ARR_APP1(outs_frame_t, stack, frame);
+	return stack;
+}
 
-	/* initialize our counter */
+/** Counts the out edges of all nodes reachable from n, which is not yet
+ *  visited. */
+static void count_outs_node(ir_node *n)
+{
+	mark_irn_visited(n);
 	n->o.n_outs = 0;
 
-	int start = is_Block(n) ? 0 : -1;
-	for (int i = start, irn_arity = get_irn_arity(n); i < irn_arity; ++i) {
-		ir_node *def = get_irn_n(n, i);
-		count_outs_node(def);
+	/* the walk keeps its path on an explicit stack, the depth of the graph
+	 * is not limited by the C stack */
+	outs_frame_t *stack = push_outs_frame(NEW_ARR_F(outs_frame_t, 0), n);
+	while (ARR_LEN(stack) > 0) {
+		outs_frame_t *const frame = &stack[ARR_LEN(stack) - 1];
+		ir_node      *const node  = frame->node;
+		if (frame->pos == get_irn_arity(node)) {
+			ARR_SHRINKLEN(stack, ARR_LEN(stack) - 1);
+			continue;
+		}
+
+		ir_node *const def = get_irn_n(node, frame->pos++);
+		if (!irn_visited_else_mark(def)) {
+			/* initialize our counter */
+			def->o.n_outs = 0;
+			stack = push_outs_frame(stack, def);
+		}
 		++def->o.n_outs;
 	}
+	DEL_ARR_F(stack);
 }
 
 
@@ -258,29 +288,52 @@ static void count_outs(ir_graph *irg)
 	}
 }
 
-static void set_out_edges_node(ir_node *node, struct obstack *obst)
+static void alloc_out_edges(ir_node *node, struct obstack *obst)
 {
-	if (irn_visited_else_mark(node))
-		return;
-
 	/* Allocate my array */
 	unsigned n_outs = node->o.n_outs;
 	node->o.out          = OALLOCF(obst, ir_def_use_edges, edges, n_outs);
 	node->o.out->n_edges = 0;
+}
 
-	/* add def->use edges from my predecessors to me */
-	int start = is_Block(node) ? 0 : -1;
-	for (int i = start, irn_arity = get_irn_arity(node); i < irn_arity; ++i) {
-		ir_node *def = get_irn_n(node, i);
+/** Sets the out edges of all nodes reachable from node, which is not yet
+ *  visited. The edges to a node are added in the order of a recursive
+ *  post-order walk. */
+static void set_out_edges_node(ir_node *node, struct obstack *obst)
+{
+	mark_irn_visited(node);
+	alloc_out_edges(node, obst);
+
+	outs_frame_t *stack = push_outs_frame(NEW_ARR_F(outs_frame_t, 0), node);
+	while (ARR_LEN(stack) > 0) {
+		outs_frame_t *const frame = &stack[ARR_LEN(stack) - 1];
+		ir_node      *const use   = frame->node;
+		int           const pos   = frame->pos;
+		if (pos == get_irn_arity(use)) {
+			ARR_SHRINKLEN(stack, ARR_LEN(stack) - 1);
+			continue;
+		}
 
-		/* recurse, ensures that out array of pred is already allocated */
-		set_out_edges_node(def, obst);
+		/* descend first, ensures that out array of pred is already allocated
+		 * and that the edges of its inputs are added before this one */
+		ir_node *const def = get_irn_n(use, pos);
+		if (!frame->descended) {
+			frame->descended = true;
+			if (!irn_visited_else_mark(def)) {
+				alloc_out_edges(def, obst);
+				stack = push_outs_frame(stack, def);
+				continue;
+			}
+		}
 
 		/* Remember this Def-Use edge */
-		unsigned pos = def->o.out->n_edges++;
-		def->o.out->edges[pos].use = node;
-		def->o.out->edges[pos].pos = i;
+		unsigned const edge = def->o.out->n_edges++;
+		def->o.out->edges[edge].use = use;
+		def->o.out->edges[edge].pos = pos;
+		frame->pos       = pos + 1;
+		frame->descended = false;
 	}
+	DEL_ARR_F(stack);
 }
 
 static void set_out_edges(ir_graph *irg)
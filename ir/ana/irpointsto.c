@@ -0,0 +1,734 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2012 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Whole program points-to analysis.
+ *
+ * A flow- and context-insensitive, unification based (Steensgaard style)
+ * points-to analysis over all graphs of the program. Every value carrying a
+ * pointer gets a class, which stands for the set of memory locations the value
+ * may point to. Each class of locations has at most one pointee class, which
+ * stands for the locations the pointers stored there may point to. Assignments
+ * unify classes, so the analysis runs in almost linear time and space in the
+ * size of the program: classes are kept in union-find arrays and every node is
+ * visited once.
+ *
+ * After solving, all classes are replaced by their representatives, so queries
+ * only need a lookup in the per graph class array. Two addresses in different
+ * classes cannot point to the same object.
+ *
+ * Values leaving the analyzed program (arguments of external functions,
+ * externally visible entities, pointers forged from integers, asm) are unified
+ * with the "unknown" class, whose pointee is itself.
+ */
+#include "irmemory_t.h"
+
+#include "array.h"
+#include "cgana.h"
+#include "debug.h"
+#include "irgraph_t.h"
+#include "irgwalk.h"
+#include "irnode_t.h"
+#include "irprog_t.h"
+#include "obst.h"
+#include "pmap.h"
+#include "statev_t.h"
+#include "type_t.h"
+#include "unionfind.h"
+#include "util.h"
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
+
+/** Points-to information about a method. */
+typedef struct pta_method_t {
+	ir_entity *entity;   /**< the method entity */
+	int        params;   /**< class of the first parameter */
+	int        results;  /**< class of the first result */
+	size_t     n_params; /**< number of parameter classes */
+	size_t     n_ress;   /**< number of result classes */
+	bool       escaped;  /**< unknown code may call the method */
+} pta_method_t;
+
+static bool            computed;     /**< the analysis results are valid */
+static int             unknown;      /**< the class of unknown locations */
+static pmap           *locations;    /**< maps entities to their class + 1 */
+/* only valid while solving */
+static int            *classes;      /**< union-find array of all classes */
+static int            *pointees;     /**< pointee class per class or -1 */
+static int            *pending;      /**< pairs of classes still to unify */
+static pmap           *methods;      /**< maps entities to pta_method_t */
+static pta_method_t  **method_list;  /**< all pta_method_t */
+static struct obstack  obst;
+
+static int new_class(void)
+{
+	int const cls = (int)ARR_LEN(classes);
+	ARR_APP1(int, classes, -1);
+	ARR_APP1(int, pointees, -1);
+	return cls;
+}
+
+static int find_class(int const cls)
+{
+	return uf_find(classes, cls);
+}
+
+/**
+ * Unifies two classes and, recursively, their pointees.
+ */
+static void join(int const cls1, int const cls2)
+{
+	ARR_APP1(int, pending, cls1);
+	ARR_APP1(int, pending, cls2);
+	while (ARR_LEN(pending) > 0) {
+		size_t const len = ARR_LEN(pending);
+		int    const a   = find_class(pending[len - 2]);
+		int    const b   = find_class(pending[len - 1]);
+		ARR_SHRINKLEN(pending, len - 2);
+		if (a == b)
+			continue;
+
+		int const pointee_a = pointees[a];
+		int const pointee_b = pointees[b];
+		int const repr      = uf_union(classes, a, b);
+		if (pointee_a < 0) {
+			pointees[repr] = pointee_b;
+		} else {
+			pointees[repr] = pointee_a;
+			if (pointee_b >= 0) {
+				ARR_APP1(int, pending, pointee_a);
+				ARR_APP1(int, pending, pointee_b);
+			}
+		}
+	}
+}
+
+/**
+ * Returns the class of the locations, pointers stored in class @p cls may
+ * point to.
+ */
+static int deref(int const cls)
+{
+	int const repr = find_class(cls);
+	if (pointees[repr] < 0) {
+		int const pointee = new_class();
+		pointees[repr] = pointee;
+	}
+	return pointees[repr];
+}
+
+static int *get_irg_classes(ir_graph *const irg)
+{
+	int *irg_classes = irg->points_to;
+	if (irg_classes == NULL) {
+		size_t const n = get_irg_last_idx(irg);
+		irg_classes = NEW_ARR_F(int, n);
+		for (size_t i = 0; i < n; ++i)
+			irg_classes[i] = -1;
+		irg->points_to = irg_classes;
+	}
+	return irg_classes;
+}
+
+/**
+ * Returns the class of the locations @p node may point to.
+ */
+static int get_node_class(ir_node const *const node)
+{
+	int     *const irg_classes = get_irg_classes(get_irn_irg(node));
+	unsigned const idx         = get_irn_idx(node);
+	assert(idx < ARR_LEN(irg_classes));
+	if (irg_classes[idx] < 0)
+		irg_classes[idx] = new_class();
+	return irg_classes[idx];
+}
+
+/**
+ * Checks whether @p node may carry (the bits of) a pointer.
+ */
+static bool is_carrier(ir_node const *const node)
+{
+	ir_mode *const mode = get_irn_mode(node);
+	if (!mode_is_data(mode))
+		return false;
+
+	switch (get_irn_opcode(node)) {
+	case iro_Const:
+		return mode_is_reference(mode) && !is_Const_null(node);
+	case iro_Align:
+	case iro_Offset:
+	case iro_Size:
+		return false;
+	case iro_Add:
+	case iro_Minus:
+	case iro_Mul:
+	case iro_Sub:
+		/* arithmetic destroys pointer bits stored in floats */
+		return !mode_is_float(mode);
+	default:
+		return true;
+	}
+}
+
+static void join_node(ir_node const *const node, ir_node const *const other)
+{
+	if (is_carrier(other))
+		join(get_node_class(node), get_node_class(other));
+}
+
+static void escape_node(ir_node const *const node)
+{
+	if (is_carrier(node))
+		join(get_node_class(node), unknown);
+}
+
+static void escape_method(pta_method_t *const info)
+{
+	info->escaped = true;
+	for (size_t i = 0; i < info->n_params; ++i)
+		join(info->params + (int)i, unknown);
+	for (size_t i = 0; i < info->n_ress; ++i)
+		join(info->results + (int)i, unknown);
+}
+
+/**
+ * Returns the classes of the parameters and results of method @p entity.
+ */
+static pta_method_t *get_method_info(ir_entity *const entity)
+{
+	pta_method_t *info = pmap_get(pta_method_t, methods, entity);
+	if (info == NULL) {
+		ir_type *const mtp = get_entity_type(entity);
+		info = OALLOCZ(&obst, pta_method_t);
+		info->entity   = entity;
+		info->n_params = get_method_n_params(mtp);
+		info->n_ress   = get_method_n_ress(mtp);
+		info->params   = (int)ARR_LEN(classes);
+		for (size_t i = 0; i < info->n_params; ++i)
+			(void)new_class();
+		info->results  = (int)ARR_LEN(classes);
+		for (size_t i = 0; i < info->n_ress; ++i)
+			(void)new_class();
+		pmap_insert(methods, entity, info);
+		ARR_APP1(pta_method_t*, method_list, info);
+
+		/* the body of methods without a (definitive) graph is unknown */
+		if (get_entity_linktime_irg(entity) == NULL)
+			escape_method(info);
+	}
+	return info;
+}
+
+/**
+ * Returns the class of the memory location of entity @p entity.
+ */
+static int get_entity_class(ir_entity *const entity)
+{
+	int cls = PTR_TO_INT(pmap_get(void, locations, entity)) - 1;
+	if (cls < 0) {
+		cls = new_class();
+		pmap_insert(locations, entity, INT_TO_PTR(cls + 1));
+		if (entity_is_externally_visible(entity))
+			join(cls, unknown);
+	}
+	return cls;
+}
+
+static bool is_malloc_callee(ir_entity const *const callee)
+{
+	return get_entity_additional_properties(callee) & mtp_property_malloc;
+}
+
+/**
+ * Returns the number of callees of @p call or 0 if they are unknown.
+ */
+static size_t get_n_callees(ir_node const *const call)
+{
+	if (get_Call_callee(call) != NULL)
+		return 1;
+
+	ir_graph *const irg = get_irn_irg(call);
+	if (get_irg_callee_info_state(irg) != irg_callee_info_consistent
+	    || !cg_call_has_callees(call))
+		return 0;
+	size_t const n = cg_get_call_n_callees(call);
+	/* cgana puts the unknown entity first */
+	if (n == 0 || is_unknown_entity(cg_get_call_callee(call, 0)))
+		return 0;
+	return n;
+}
+
+static ir_entity *get_callee(ir_node const *const call, size_t const pos)
+{
+	ir_entity *const callee = get_Call_callee(call);
+	return callee != NULL ? callee : cg_get_call_callee(call, pos);
+}
+
+static void visit_Call(ir_node *const call)
+{
+	size_t const n_callees = get_n_callees(call);
+	if (n_callees == 0) {
+		/* unknown code may see the callee and all arguments */
+		escape_node(get_Call_ptr(call));
+		foreach_irn_in(call, i, param) {
+			escape_node(param);
+		}
+		return;
+	}
+
+	for (size_t c = 0; c < n_callees; ++c) {
+		pta_method_t *const info = get_method_info(get_callee(call, c));
+		for (int i = 0, n = get_Call_n_params(call); i < n; ++i) {
+			ir_node *const param = get_Call_param(call, i);
+			if (!is_carrier(param))
+				continue;
+			int const cls = (size_t)i < info->n_params ? info->params + i : unknown;
+			join(cls, get_node_class(param));
+		}
+	}
+}
+
+static void visit_call_result(ir_node *const proj, ir_node *const call)
+{
+	unsigned const num       = get_Proj_num(proj);
+	size_t   const n_callees = get_n_callees(call);
+	if (n_callees == 0) {
+		escape_node(proj);
+		return;
+	}
+
+	for (size_t c = 0; c < n_callees; ++c) {
+		ir_entity *const callee = get_callee(call, c);
+		if (is_malloc_callee(callee)) {
+			/* every call site allocates a new object */
+			join(get_node_class(proj), get_node_class(call));
+			continue;
+		}
+		pta_method_t *const info = get_method_info(callee);
+		int const cls = num < info->n_ress ? info->results + (int)num : unknown;
+		join(get_node_class(proj), cls);
+	}
+}
+
+static void visit_Proj(ir_node *const proj)
+{
+	ir_node *const pred = get_Proj_pred(proj);
+	switch (get_irn_opcode(pred)) {
+	case iro_Load:
+		if (get_Proj_num(proj) == pn_Load_res)
+			join(get_node_class(proj), deref(get_node_class(get_Load_ptr(pred))));
+		return;
+	case iro_Alloc:
+		/* the Alloc node represents the allocated object */
+		if (get_Proj_num(proj) == pn_Alloc_res)
+			join(get_node_class(proj), get_node_class(pred));
+		return;
+	case iro_Div:
+	case iro_Mod:
+		join_node(proj, get_binop_left(pred));
+		join_node(proj, get_binop_right(pred));
+		return;
+	case iro_Start:
+		/* only the frame, which is handled by Member */
+		return;
+	case iro_Proj: {
+		ir_node *const pred_pred = get_Proj_pred(pred);
+		if (is_Start(pred_pred) && get_Proj_num(pred) == pn_Start_T_args) {
+			ir_entity    *const entity = get_irg_entity(get_irn_irg(proj));
+			pta_method_t *const info   = get_method_info(entity);
+			unsigned      const num    = get_Proj_num(proj);
+			int const cls = num < info->n_params ? info->params + (int)num : unknown;
+			join(get_node_class(proj), cls);
+			return;
+		} else if (is_Call(pred_pred) && get_Proj_num(pred) == pn_Call_T_result) {
+			visit_call_result(proj, pred_pred);
+			return;
+		}
+		break;
+	}
+	default:
+		break;
+	}
+	/* Builtin, ASM and anything unexpected */
+	escape_node(proj);
+}
+
+static void visit_Return(ir_node *const ret)
+{
+	ir_entity    *const entity = get_irg_entity(get_irn_irg(ret));
+	pta_method_t *const info   = get_method_info(entity);
+	for (size_t i = 0, n = get_Return_n_ress(ret); i < n; ++i) {
+		ir_node *const res = get_Return_res(ret, i);
+		if (!is_carrier(res))
+			continue;
+		int const cls = i < info->n_ress ? info->results + (int)i : unknown;
+		join(cls, get_node_class(res));
+	}
+}
+
+/**
+ * Collects the constraints of @p node.
+ */
+static void visit_node(ir_node *const node, void *const env)
+{
+	(void)env;
+	switch (get_irn_opcode(node)) {
+	case iro_Store: {
+		ir_node *const value = get_Store_value(node);
+		if (is_carrier(value))
+			join(deref(get_node_class(get_Store_ptr(node))), get_node_class(value));
+		return;
+	}
+	case iro_CopyB:
+		join(deref(get_node_class(get_CopyB_dst(node))),
+		     deref(get_node_class(get_CopyB_src(node))));
+		return;
+	case iro_Call:
+		visit_Call(node);
+		return;
+	case iro_Return:
+		visit_Return(node);
+		return;
+	case iro_ASM:
+	case iro_Builtin:
+		foreach_irn_in(node, i, op) {
+			escape_node(op);
+		}
+		return;
+	case iro_Proj:
+		if (is_carrier(node))
+			visit_Proj(node);
+		return;
+	default:
+		break;
+	}
+
+	if (!is_carrier(node))
+		return;
+
+	switch (get_irn_opcode(node)) {
+	case iro_Address:
+		join(get_node_class(node), get_entity_class(get_Address_entity(node)));
+		return;
+
+	case iro_Member: {
+		ir_node *const ptr = get_Member_ptr(node);
+		if (ptr == get_irg_frame(get_irn_irg(node))) {
+			join(get_node_class(node), get_entity_class(get_Member_entity(node)));
+		} else {
+			join_node(node, ptr);
+		}
+		return;
+	}
+
+	case iro_Sel:
+		join_node(node, get_Sel_ptr(node));
+		return;
+
+	case iro_Add:
+	case iro_Sub:
+		if (mode_is_reference(get_irn_mode(node))) {
+			/* pointer arithmetic stays inside the object */
+			ir_node *const left = get_binop_left(node);
+			join_node(node, mode_is_reference(get_irn_mode(left))
+			                ? left : get_binop_right(node));
+			return;
+		}
+		/* FALLTHROUGH */
+	case iro_And:
+	case iro_Bitcast:
+	case iro_Eor:
+	case iro_Id:
+	case iro_Minus:
+	case iro_Mul:
+	case iro_Mulh:
+	case iro_Not:
+	case iro_Or:
+	case iro_Phi:
+	case iro_Pin:
+	case iro_Shl:
+	case iro_Shr:
+	case iro_Shrs:
+		foreach_irn_in(node, i, op) {
+			join_node(node, op);
+		}
+		return;
+
+	case iro_Conv: {
+		ir_node *const op = get_Conv_op(node);
+		if (mode_is_reference(get_irn_mode(node))
+		    && !mode_is_reference(get_irn_mode(op))) {
+			/* pointer forged from an integer */
+			escape_node(node);
+		} else {
+			join_node(node, op);
+		}
+		return;
+	}
+
+	case iro_Confirm:
+		join_node(node, get_Confirm_value(node));
+		return;
+
+	case iro_Mux:
+		join_node(node, get_Mux_false(node));
+		join_node(node, get_Mux_true(node));
+		return;
+
+	case iro_Bad:
+	case iro_Dummy:
+	case iro_Unknown:
+		/* undefined values do not point anywhere */
+		return;
+
+	default:
+		/* non-null constant pointers and anything unexpected */
+		escape_node(node);
+		return;
+	}
+}
+
+static void visit_const_value(ir_node *const node)
+{
+	foreach_irn_in(node, i, op) {
+		visit_const_value(op);
+	}
+	visit_node(node, NULL);
+}
+
+static void visit_initializer(int const location,
+                              ir_initializer_t const *const initializer)
+{
+	switch (get_initializer_kind(initializer)) {
+	case IR_INITIALIZER_CONST: {
+		ir_node *const value = get_initializer_const_value(initializer);
+		visit_const_value(value);
+		if (is_carrier(value))
+			join(deref(location), get_node_class(value));
+		return;
+	}
+	case IR_INITIALIZER_TARVAL:
+	case IR_INITIALIZER_NULL:
+		return;
+	case IR_INITIALIZER_COMPOUND:
+		for (size_t i = 0, n = get_initializer_compound_n_entries(initializer);
+		     i < n; ++i) {
+			visit_initializer(location, get_initializer_compound_value(initializer, i));
+		}
+		return;
+	}
+	panic("invalid initializer found");
+}
+
+static void visit_irg(ir_graph *const irg)
+{
+	/* parameter entities are initialized by the caller, compound ones are
+	 * copied from unknown memory */
+	pta_method_t *const info       = get_method_info(get_irg_entity(irg));
+	ir_type      *const frame_type = get_irg_frame_type(irg);
+	for (size_t i = 0, n = get_compound_n_members(frame_type); i < n; ++i) {
+		ir_entity *const entity = get_compound_member(frame_type, i);
+		if (!is_parameter_entity(entity))
+			continue;
+		size_t const num = get_entity_parameter_number(entity);
+		int          cls = unknown;
+		if (num < info->n_params && !is_compound_type(get_entity_type(entity)))
+			cls = info->params + (int)num;
+		join(deref(get_entity_class(entity)), cls);
+	}
+
+	irg_walk_graph(irg, NULL, visit_node, NULL);
+
+	/* if the frame itself is used, it may point to any frame entity */
+	ir_node   *const frame       = get_irg_frame(irg);
+	int const *const irg_classes = get_irg_classes(irg);
+	if (irg_classes[get_irn_idx(frame)] >= 0) {
+		int const cls = irg_classes[get_irn_idx(frame)];
+		for (size_t i = 0, n = get_compound_n_members(frame_type); i < n; ++i) {
+			join(cls, get_entity_class(get_compound_member(frame_type, i)));
+		}
+	}
+}
+
+/**
+ * Methods whose address reached unknown code may be called with unknown
+ * arguments.
+ */
+static void escape_methods(void)
+{
+	bool changed;
+	do {
+		changed = false;
+		for (size_t i = 0, n = ARR_LEN(method_list); i < n; ++i) {
+			pta_method_t *const info = method_list[i];
+			if (info->escaped)
+				continue;
+			int const cls = get_entity_class(info->entity);
+			if (find_class(cls) != find_class(unknown))
+				continue;
+			escape_method(info);
+			changed = true;
+		}
+	} while (changed);
+}
+
+/**
+ * Replaces all classes by their representatives.
+ */
+static void normalize_classes(ir_graph *const irg)
+{
+	int *const irg_classes = irg->points_to;
+	if (irg_classes == NULL)
+		return;
+	for (size_t i = 0, n = ARR_LEN(irg_classes); i < n; ++i) {
+		if (irg_classes[i] >= 0)
+			irg_classes[i] = find_class(irg_classes[i]);
+	}
+}
+
+void free_irg_points_to(ir_graph *const irg)
+{
+	if (irg->points_to != NULL) {
+		DEL_ARR_F(irg->points_to);
+		irg->points_to = NULL;
+	}
+}
+
+void free_irp_points_to(void)
+{
+	if (!computed)
+		return;
+	foreach_irp_irg(i, irg) {
+		free_irg_points_to(irg);
+	}
+	free_irg_points_to(get_const_code_irg());
+	pmap_destroy(locations);
+	computed = false;
+	invalidate_irp_alias_info();
+}
+
+void compute_irp_points_to(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.ana.pointsto");
+	free_irp_points_to();
+
+	classes     = NEW_ARR_F(int, 0);
+	pointees    = NEW_ARR_F(int, 0);
+	pending     = NEW_ARR_F(int, 0);
+	method_list = NEW_ARR_F(pta_method_t*, 0);
+	locations   = pmap_create();
+	methods     = pmap_create();
+	obstack_init(&obst);
+
+	unknown = new_class();
+	pointees[unknown] = unknown;
+
+	for (ir_segment_t s = IR_SEGMENT_FIRST; s <= IR_SEGMENT_LAST; ++s) {
+		ir_type *const type = get_segment_type(s);
+		for (size_t i = 0, n = get_compound_n_members(type); i < n; ++i) {
+			ir_entity *const entity = get_compound_member(type, i);
+			if (get_entity_kind(entity) != IR_ENTITY_NORMAL)
+				continue;
+			ir_initializer_t const *const init = get_entity_initializer(entity);
+			if (init != NULL)
+				visit_initializer(get_entity_class(entity), init);
+		}
+	}
+	foreach_irp_irg(i, irg) {
+		visit_irg(irg);
+	}
+	escape_methods();
+
+	/* keep only the representatives */
+	int const unknown_repr = find_class(unknown);
+	foreach_pmap(locations, entry) {
+		int const cls = PTR_TO_INT(entry->value) - 1;
+		entry->value = INT_TO_PTR(find_class(cls) + 1);
+	}
+	foreach_irp_irg(i, irg) {
+		normalize_classes(irg);
+	}
+	normalize_classes(get_const_code_irg());
+	DB((dbg, LEVEL_1, "%zu points-to classes\n", ARR_LEN(classes)));
+	stat_ev_ull("pointsto_classes", ARR_LEN(classes));
+
+	unknown = unknown_repr;
+	DEL_ARR_F(classes);
+	DEL_ARR_F(pointees);
+	DEL_ARR_F(pending);
+	DEL_ARR_F(method_list);
+	pmap_destroy(methods);
+	obstack_free(&obst, NULL);
+	computed = true;
+	invalidate_irp_alias_info();
+}
+
+void assure_irp_points_to_computed(void)
+{
+	if (!computed)
+		compute_irp_points_to();
+}
+
+/**
+ * Returns the class of the objects @p addr may point to or -1 if unknown.
+ * Nodes created after the analysis inherit the class of their operands.
+ */
+static int get_address_class(ir_node const *addr)
+{
+	for (;;) {
+		ir_graph  *const irg         = get_irn_irg(addr);
+		int const *const irg_classes = irg->points_to;
+		unsigned   const idx         = get_irn_idx(addr);
+		if (irg_classes != NULL && idx < ARR_LEN(irg_classes)
+		    && irg_classes[idx] >= 0)
+			return irg_classes[idx];
+
+		switch (get_irn_opcode(addr)) {
+		case iro_Address:
+			return PTR_TO_INT(pmap_get(void, locations, get_Address_entity(addr))) - 1;
+		case iro_Member:
+			if (get_Member_ptr(addr) == get_irg_frame(irg))
+				return PTR_TO_INT(pmap_get(void, locations, get_Member_entity(addr))) - 1;
+			addr = get_Member_ptr(addr);
+			break;
+		case iro_Sel:
+			addr = get_Sel_ptr(addr);
+			break;
+		case iro_Add: {
+			ir_node *const left = get_Add_left(addr);
+			addr = mode_is_reference(get_irn_mode(left)) ? left : get_Add_right(addr);
+			break;
+		}
+		case iro_Sub:
+			addr = get_Sub_left(addr);
+			break;
+		case iro_Confirm:
+			addr = get_Confirm_value(addr);
+			break;
+		case iro_Id:
+			addr = get_Id_pred(addr);
+			break;
+		default:
+			return -1;
+		}
+		if (!mode_is_reference(get_irn_mode(addr)))
+			return -1;
+	}
+}
+
+ir_alias_relation get_points_to_relation(ir_node const *const addr1,
+                                         ir_node const *const addr2)
+{
+	if (!computed)
+		return ir_may_alias;
+	int const cls1 = get_address_class(addr1);
+	if (cls1 < 0 || cls1 == unknown)
+		return ir_may_alias;
+	int const cls2 = get_address_class(addr2);
+	if (cls2 < 0 || cls2 == unknown || cls1 == cls2)
+		return ir_may_alias;
+	return ir_no_alias;
+}
@@ -23,10 +23,13 @@
 #include "besched.h"
 #include "bespillslots.h"
 #include "bestack.h"
+#include "betranshlp.h"
 #include "beutil.h"
+#include "execfreq.h"
 #include "gen_amd64_regalloc_if.h"
 #include "irarch.h"
 #include "ircons.h"
+#include "irdom.h"
 #include "iredges_t.h"
 #include "irgmod.h"
 #include "irgopt.h"
@@ -37,16 +40,20 @@
 #include "lower_alloc.h"
 #include "lower_builtins.h"
 #include "lower_calls.h"
+#include "lower_copyb.h"
 #include "lower_mode_b.h"
 #include "lowering.h"
 #include "panic.h"
 #include "platform_t.h"
+#include "statev_t.h"
 #include "target_t.h"
 
 pmap *amd64_constants;
 
 ir_mode *amd64_mode_xmm;
 
+static bool amd64_post_ra_sched;
+
 static ir_node *create_push(ir_node *node, ir_node *schedpoint, ir_node *sp,
                             ir_node *mem, ir_entity *ent, x86_insn_size_t size)
 {
@@ -372,10 +379,15 @@ static void amd64_handle_intrinsics(ir_graph *irg)
 static void amd64_set_frame_entity(ir_node *node, ir_entity *entity,
                                    unsigned size, unsigned po2align)
 {
-	(void)size;
 	(void)po2align;
 	amd64_addr_attr_t *attr = get_amd64_addr_attr(node);
 	attr->addr.immediate.entity = entity;
+
+	/* gp spills only store as many bytes as the reloads of their spill web
+	 * read */
+	if (is_amd64_mov_store(node) && arch_irn_is(node, spill)
+	 && 0 < size && size < AMD64_REGISTER_SIZE)
+		attr->base.size = x86_size_from_bytes(size);
 }
 
 /**
@@ -398,6 +410,9 @@ static void amd64_collect_frame_entity_nodes(ir_node *node, void *data)
 			po2align = 2;
 		} else {
 			size     = x86_bytes_from_size(attr->base.size);
+			/* MemPerms copy the slots of memory Phis with 64bit push/pop */
+			if (is_Phi(get_irn_n(node, attr->addr.mem_input)))
+				size = MAX(size, AMD64_REGISTER_SIZE);
 			po2align = log2_floor(size);
 		}
 		be_load_needs_frame_entity(env, node, size, po2align);
@@ -422,7 +437,7 @@ static void amd64_select_instructions(ir_graph *irg)
 	be_dump(DUMP_BE, irg, "opt");
 }
 
-static void introduce_epilogue(ir_node *ret, bool omit_fp)
+static void introduce_epilogue(ir_node *ret, bool omit_fp, bool red_zone)
 {
 	ir_graph *irg      = get_irn_irg(ret);
 	ir_node  *block    = get_nodes_block(ret);
@@ -443,7 +458,7 @@ static void introduce_epilogue(ir_node *ret, bool omit_fp)
 
 		set_irn_n(ret, n_amd64_ret_mem, curr_mem);
 		set_irn_n(ret, n_rbp,           curr_bp);
-	} else {
+	} else if (!red_zone) {
 		ir_type *frame_type = get_irg_frame_type(irg);
 		unsigned frame_size = get_type_size(frame_type);
 		ir_node *incsp = amd64_new_IncSP(block, curr_sp, -(int)frame_size,
@@ -459,7 +474,8 @@ static void introduce_epilogue(ir_node *ret, bool omit_fp)
 	}
 }
 
-static void introduce_prologue(ir_graph *const irg, bool omit_fp)
+static void introduce_prologue(ir_graph *const irg, bool omit_fp,
+                               bool red_zone)
 {
 	const arch_register_t *sp         = &amd64_registers[REG_RSP];
 	const arch_register_t *bp         = &amd64_registers[REG_RBP];
@@ -485,13 +501,19 @@ static void introduce_prologue(ir_graph *const irg, bool omit_fp)
 		arch_copy_irn_out_info(curr_bp, 0, initial_bp);
 		edges_reroute_except(initial_bp, curr_bp, push);
 
+		if (red_zone) {
+			/* the frame lies in the red zone below rbp */
+			edges_reroute_except(initial_sp, curr_sp, push);
+			return;
+		}
+
 		ir_node *incsp = amd64_new_IncSP(block, curr_sp, frame_size, false);
 		sched_add_after(curr_bp, incsp);
 		edges_reroute_except(initial_sp, incsp, push);
 
 		/* make sure the initial IncSP is really used by someone */
 		be_keep_if_unused(incsp);
-	} else {
+	} else if (!red_zone) {
 		ir_node *const incsp = amd64_new_IncSP(block, initial_sp,
 		                                       frame_size, false);
 		sched_add_after(start, incsp);
@@ -499,15 +521,44 @@ static void introduce_prologue(ir_graph *const irg, bool omit_fp)
 	}
 }
 
-static void introduce_prologue_epilogue(ir_graph *irg, bool omit_fp)
+static void introduce_prologue_epilogue(ir_graph *irg, bool omit_fp,
+                                        bool red_zone)
 {
 	/* introduce epilogue for every return node */
 	foreach_irn_in(get_irg_end_block(irg), i, ret) {
 		assert(is_amd64_ret(ret));
-		introduce_epilogue(ret, omit_fp);
+		introduce_epilogue(ret, omit_fp, red_zone);
 	}
 
-	introduce_prologue(irg, omit_fp);
+	introduce_prologue(irg, omit_fp, red_zone);
+}
+
+static void check_red_zone(ir_node *const node, void *const data)
+{
+	bool *const usable = (bool*)data;
+	/* anything that moves the stack pointer would clobber the red zone */
+	if (be_is_IncSP(node) || be_is_Asm(node) || is_amd64_call(node)
+	 || is_amd64_push_am(node) || is_amd64_push_reg(node)
+	 || is_amd64_pop_am(node) || is_amd64_sub_sp(node))
+		*usable = false;
+}
+
+/**
+ * Leaf functions whose frame fits into the red zone do not need to allocate
+ * it. This has to be decided after the MemPerms have been lowered, as they
+ * may produce pushes and pops.
+ */
+static bool can_use_red_zone(ir_graph *const irg)
+{
+	if (amd64_no_red_zone || ir_platform.amd64_x64abi)
+		return false;
+	unsigned const frame_size = get_type_size(get_irg_frame_type(irg));
+	if (frame_size == 0 || frame_size > AMD64_RED_ZONE_SIZE)
+		return false;
+
+	bool usable = true;
+	irg_walk_graph(irg, check_red_zone, NULL, &usable);
+	return usable;
 }
 
 static bool node_has_sp_base(ir_node const *const node,
@@ -575,6 +626,8 @@ static void amd64_sp_sim(ir_node *const node, stack_pointer_state_t *state)
 	} else if (is_amd64_push_reg(node)) {
 		/* 64-bit register size */
 		state->offset       += AMD64_REGISTER_SIZE;
+	} else if (is_amd64_pop_reg(node)) {
+		state->offset       -= AMD64_REGISTER_SIZE;
 	} else if (is_amd64_leave(node)) {
 		state->offset        = 0;
 		state->align_padding = 0;
@@ -602,8 +655,8 @@ int amd64_get_sp_change(ir_node *const node)
  */
 static void amd64_finish_and_emit(ir_graph *irg)
 {
-	amd64_irg_data_t const *const irg_data = amd64_get_irg_data(irg);
-	bool                    const omit_fp  = irg_data->omit_fp;
+	amd64_irg_data_t *const irg_data = amd64_get_irg_data(irg);
+	bool              const omit_fp  = irg_data->omit_fp;
 
 	/* create and coalesce frame entities */
 	be_fec_env_t *fec_env = be_new_frame_entity_coalescer(irg);
@@ -616,10 +669,13 @@ static void amd64_finish_and_emit(ir_graph *irg)
 	unsigned const misalign = AMD64_REGISTER_SIZE; /* return address on stack */
 	int      const begin    = omit_fp ? 0 : -AMD64_REGISTER_SIZE;
 	be_layout_frame_type(frame, begin, misalign);
+	stat_ev_int("amd64_frame_size", get_type_size(frame));
 
 	irg_block_walk_graph(irg, NULL, amd64_after_ra_walker, NULL);
 
-	introduce_prologue_epilogue(irg, omit_fp);
+	irg_data->red_zone = can_use_red_zone(irg);
+	stat_ev_int("amd64_red_zone", irg_data->red_zone);
+	introduce_prologue_epilogue(irg, omit_fp, irg_data->red_zone);
 
 	/* fix stack entity offsets */
 	be_fix_stack_nodes(irg, &amd64_registers[REG_RSP]);
@@ -630,6 +686,9 @@ static void amd64_finish_and_emit(ir_graph *irg)
 	/* Fix 2-address code constraints. */
 	amd64_finish_irg(irg);
 
+	if (amd64_post_ra_sched)
+		be_schedule_post_ra(irg, &amd64_reg_classes[CLASS_amd64_flags]);
+
 	amd64_simulate_graph_x87(irg);
 
 	amd64_peephole_optimization(irg);
@@ -643,13 +702,15 @@ static void amd64_finish_and_emit(ir_graph *irg)
 static void amd64_finish(void)
 {
 	amd64_free_opcodes();
+	obstack_free(&amd64_opcodes_obst, NULL);
 }
 
 static const regalloc_if_t amd64_regalloc_if = {
-	.spill_cost  = 7,
-	.reload_cost = 5,
-	.new_spill   = amd64_new_spill,
-	.new_reload  = amd64_new_reload,
+	.spill_cost             = 7,
+	.reload_cost            = 5,
+	.new_spill              = amd64_new_spill,
+	.new_reload             = amd64_new_reload,
+	.perform_memory_operand = amd64_perform_memory_operand,
 };
 
 static void amd64_generate_code(FILE *output, const char *cup_name)
@@ -731,17 +792,6 @@ static void amd64_lower_for_target(void)
 		/* lower for mode_b stuff */
 		ir_lower_mode_b(irg, mode_Lu);
 		be_after_transform(irg, "lower-modeb");
-		lower_alloc(irg, AMD64_PO2_STACK_ALIGNMENT);
-		be_after_transform(irg, "lower-alloc");
-	}
-
-	foreach_irp_irg(i, irg) {
-		/* Turn all small CopyBs into loads/stores, and turn all bigger
-		 * CopyBs into memcpy calls, because we cannot handle CopyB nodes
-		 * during code generation yet.
-		 * TODO:  Adapt this once custom CopyB handling is implemented. */
-		lower_CopyB(irg, 64, 65, true);
-		be_after_transform(irg, "lower-copyb");
 	}
 
 	ir_builtin_kind supported[6];
@@ -752,10 +802,23 @@ static void amd64_lower_for_target(void)
 	supported[s++] = ir_bk_compare_swap;
 	supported[s++] = ir_bk_saturating_increment;
 	supported[s++] = ir_bk_va_start;
-
 	assert(s <= ARRAY_SIZE(supported));
-	lower_builtins(s, supported, amd64_lower_va_arg);
-	be_after_irp_transform("lower-builtins");
+
+	/* Alloc, CopyB and Builtin lowering only look at single nodes, so run
+	 * them together in one traversal per graph.
+	 * Turn all small CopyBs into loads/stores, and turn all bigger
+	 * CopyBs into memcpy calls, because we cannot handle CopyB nodes
+	 * during code generation yet.
+	 * TODO:  Adapt this once custom CopyB handling is implemented. */
+	lower_nodes_t *lower = lower_nodes_new();
+	lower_alloc_register(lower, AMD64_PO2_STACK_ALIGNMENT);
+	lower_CopyB_register(lower, 64, 65, true);
+	lower_builtins_register(lower, s, supported, amd64_lower_va_arg);
+	foreach_irp_irg(i, irg) {
+		lower_nodes_irg(lower, irg);
+		be_after_transform(irg, "lower-nodes");
+	}
+	lower_nodes_free(lower);
 }
 
 static void amd64_init_types(void)
@@ -768,23 +831,145 @@ static void amd64_init_types(void)
 	ir_platform.va_list_type = amd64_build_va_list_type();
 }
 
+/** Cycles lost by a mispredicted branch. */
+#define AMD64_BRANCH_MISS_PENALTY 15
+/** Maximum number of nodes counted as speculatively executed per value. */
+#define AMD64_MAX_SPECULATED      16
+
+/**
+ * Returns true if @p block is only executed on one side of the branch in
+ * @p cond_block and would be speculated by if-conversion.
+ */
+static bool is_branch_arm(ir_node const *const cond_block,
+                          ir_node const *const block)
+{
+	if (block == cond_block)
+		return false;
+	ir_graph *const irg = get_irn_irg(block);
+	if (!irg_has_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE))
+		return false;
+	return block_dominates(cond_block, block);
+}
+
+/**
+ * Counts the nodes computing @p value which would be executed unconditionally
+ * after if-conversion, up to @p budget.
+ */
+static unsigned count_speculated(ir_node const *const cond_block,
+                                 ir_node const *const value,
+                                 unsigned const budget)
+{
+	if (budget == 0 || !is_branch_arm(cond_block, get_nodes_block(value)))
+		return 0;
+	unsigned n = 1;
+	foreach_irn_in(value, i, pred) {
+		if (n >= budget)
+			break;
+		n += count_speculated(cond_block, pred, budget - n);
+	}
+	return n;
+}
+
+/**
+ * Returns the probability that the arm computing @p value is taken, or a
+ * negative value if no execution frequencies are known.
+ */
+static double get_arm_probability(ir_node const *const cond_block,
+                                  ir_node const *const value)
+{
+	ir_node const *const block = get_nodes_block(value);
+	if (!is_branch_arm(cond_block, block))
+		return -1.0;
+	double const cond_freq = get_block_execfreq(cond_block);
+	double const arm_freq  = get_block_execfreq(block);
+	if (cond_freq <= 0.0 || arm_freq <= 0.0)
+		return -1.0;
+	return MIN(arm_freq / cond_freq, 1.0);
+}
+
+static int amd64_is_mux_allowed(ir_node const *const sel,
+                                ir_node const *const mux_false,
+                                ir_node const *const mux_true)
+{
+	/* middleend can handle some things */
+	if (ir_is_optimizable_mux(sel, mux_false, mux_true))
+		return true;
+	/* no xmm blend or min/max support yet */
+	ir_mode *const mode = get_irn_mode(mux_true);
+	if (!be_mode_needs_gp_reg(mode) && mode != mode_b)
+		return false;
+	/* float compares need an additional parity check */
+	if (is_Cmp(sel) && mode_is_float(get_irn_mode(get_Cmp_left(sel))))
+		return false;
+
+	/* Weigh the work executed in vain against the expected cost of
+	 * mispredictions. Without frequencies the branch is assumed to be
+	 * unpredictable. */
+	ir_node const *const cond_block = get_nodes_block(sel);
+	double               p_true     = get_arm_probability(cond_block, mux_true);
+	if (p_true < 0.0) {
+		double const p_false = get_arm_probability(cond_block, mux_false);
+		p_true = p_false < 0.0 ? 0.5 : 1.0 - p_false;
+	}
+	unsigned const n_true  = count_speculated(cond_block, mux_true,
+	                                          AMD64_MAX_SPECULATED);
+	unsigned const n_false = count_speculated(cond_block, mux_false,
+	                                          AMD64_MAX_SPECULATED);
+	double const cmov_cost   = 1.0 + n_true * (1.0 - p_true) + n_false * p_true;
+	double const branch_cost = MIN(p_true, 1.0 - p_true)
+	                         * AMD64_BRANCH_MISS_PENALTY;
+	return cmov_cost <= branch_cost;
+}
+
 static void amd64_init(void)
 {
 	amd64_init_types();
 	amd64_register_init();
+	obstack_init(&amd64_opcodes_obst);
 	amd64_create_opcodes();
 	amd64_cconv_init();
 	x86_set_be_asm_constraint_support(&amd64_asm_constraints);
 
 	ir_target.experimental = "the amd64 backend is experimental and unfinished (consider the ia32 backend)";
 	ir_target.fast_unaligned_memaccess = true;
+	ir_target.allow_ifconv             = amd64_is_mux_allowed;
 	ir_target.float_int_overflow       = ir_overflow_indefinite;
 }
 
+/** Additional latency of an instruction reading memory. */
+#define AMD64_LOAD_LATENCY 4
+/** Execution ports of the load units. */
+#define AMD64_LOAD_PORTS   0x0C
+
+static void amd64_get_machine_op(ir_node const *const node,
+                                 be_machine_op_t *const op)
+{
+	if (!is_amd64_irn(node)) {
+		op->latency = be_is_Keep(node) ? 0 : 1;
+		op->ports   = 0;
+		op->busy    = 1;
+		return;
+	}
+
+	amd64_op_attr_t const *const attr = amd64_get_op_attr(node);
+	op->latency = attr->latency;
+	op->ports   = attr->ports;
+	op->busy    = attr->busy;
+	/* Memory operands are executed by the load units first. */
+	if (amd64_loads(node)) {
+		op->latency += AMD64_LOAD_LATENCY;
+		op->ports    = AMD64_LOAD_PORTS;
+	}
+}
+
 static unsigned amd64_get_op_estimated_cost(const ir_node *node)
 {
-	(void)node;/* TODO */
-	return 1;
+	if (!is_amd64_irn(node))
+		return 1;
+
+	be_machine_op_t op;
+	amd64_get_machine_op(node, &op);
+	return op.latency;
 }
 
 /** we don't have a concept of aliasing registers, so enumerate them
@@ -827,13 +1012,16 @@ arch_isa_if_t const amd64_isa_if = {
 	.additional_reg_names  = amd64_additional_reg_names,
 	.handle_intrinsics     = amd64_handle_intrinsics,
 	.get_op_estimated_cost = amd64_get_op_estimated_cost,
+	.issue_width           = 4,
+	.get_machine_op        = amd64_get_machine_op,
 };
 
 BE_REGISTER_MODULE_CONSTRUCTOR(be_init_arch_amd64)
 void be_init_arch_amd64(void)
 {
 	static const lc_opt_table_entry_t options[] = {
-		LC_OPT_ENT_BOOL("no-red-zone", "gcc compatibility",                &amd64_use_red_zone),
+		LC_OPT_ENT_BOOL("no-red-zone",   "do not use the stack red zone in leaf functions", &amd64_no_red_zone),
+		LC_OPT_ENT_BOOL("post-ra-sched", "schedule again after register allocation",        &amd64_post_ra_sched),
 		LC_OPT_LAST
 	};
 	lc_opt_entry_t *be_grp    = lc_opt_get_grp(firm_opt_get_root(), "be");
@@ -16,15 +16,20 @@
 
 typedef struct amd64_irg_data_t {
 	bool omit_fp;
+	bool red_zone; /**< locals live in the red zone below rsp, no frame
+	                    is allocated */
 } amd64_irg_data_t;
 
 extern pmap *amd64_constants; /**< A map of entities that store const tarvals */
 
 extern ir_mode *amd64_mode_xmm;
 
-extern bool amd64_use_red_zone;
+extern bool amd64_no_red_zone;
 
 #define AMD64_REGISTER_SIZE   8
+/** size of the area below rsp which leaf functions may use without
+ * adjusting the stack pointer (System V ABI only) */
+#define AMD64_RED_ZONE_SIZE   128
 /** power of two stack alignment on calls */
 #define AMD64_PO2_STACK_ALIGNMENT 4
 
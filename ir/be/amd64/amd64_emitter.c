@@ -857,7 +857,8 @@ void amd64_emit_function(ir_graph *irg)
 
 	if (omit_fp) {
 		ir_type *frame_type = get_irg_frame_type(irg);
-		frame_type_size = get_type_size(frame_type);
+		/* a frame in the red zone does not move the CFA */
+		frame_type_size = irg_data->red_zone ? 0 : get_type_size(frame_type);
 		be_dwarf_callframe_register(&amd64_registers[REG_RSP]);
 	} else {
 		/* well not entirely correct here, we should emit this after the
@@ -181,6 +181,17 @@ swap:
 				return true;
 			}
 		}
+	} else if (is_amd64_cmovcc(node)) {
+		/* select the other input by negating the condition */
+		if (arch_get_irn_register_in(node, n_amd64_cmovcc_val_true) == out_reg) {
+			ir_node *const val_false = get_irn_n(node, n_amd64_cmovcc_val_false);
+			ir_node *const val_true  = get_irn_n(node, n_amd64_cmovcc_val_true);
+			set_irn_n(node, n_amd64_cmovcc_val_false, val_true);
+			set_irn_n(node, n_amd64_cmovcc_val_true,  val_false);
+			amd64_cc_attr_t *const cc_attr = get_amd64_cc_attr(node);
+			cc_attr->cc = x86_negate_condition_code(cc_attr->cc);
+			return true;
+		}
 	}
 
 	return false;
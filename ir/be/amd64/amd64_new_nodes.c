@@ -20,6 +20,7 @@
 #include "irgraph_t.h"
 #include "irmode_t.h"
 #include "irnode_t.h"
+#include "irop_t.h"
 #include "iropt_t.h"
 #include "irprintf.h"
 #include "irprog_t.h"
@@ -28,6 +29,8 @@
 #include <inttypes.h>
 #include <stdlib.h>
 
+struct obstack amd64_opcodes_obst;
+
 x87_attr_t *amd64_get_x87_attr(ir_node *const node)
 {
 	amd64_attr_t const *const attr = get_amd64_attr_const(node);
@@ -252,3 +255,19 @@ int amd64_x87_binop_addr_attrs_equal(const ir_node *const a,
 	/* ignore x87 part for now */
 	return amd64_binop_addr_attrs_equal(a, b);
 }
+
+amd64_op_attr_t const *amd64_get_op_attr(ir_node const *const node)
+{
+	assert(is_amd64_irn(node));
+	return (amd64_op_attr_t const*)get_op_attr(get_irn_op(node));
+}
+
+void amd64_init_op(ir_op *const op, unsigned const latency,
+                   unsigned const ports, unsigned const busy)
+{
+	amd64_op_attr_t *const attr = OALLOCZ(&amd64_opcodes_obst, amd64_op_attr_t);
+	attr->latency = latency;
+	attr->ports   = ports;
+	attr->busy    = busy;
+	set_op_attr(op, attr);
+}
@@ -13,6 +13,13 @@
 #include "amd64_nodes_attr.h"
 #include "gen_amd64_new_nodes.h"
 
+extern struct obstack amd64_opcodes_obst;
+
+/**
+ * Returns the machine model of the opcode of an amd64 node.
+ */
+amd64_op_attr_t const *amd64_get_op_attr(ir_node const *node);
+
 static inline amd64_attr_t *get_amd64_attr(ir_node *node)
 {
 	assert(is_amd64_irn(node));
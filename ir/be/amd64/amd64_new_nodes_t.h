@@ -23,6 +23,8 @@ void init_amd64_movimm_attributes(ir_node *node, const amd64_imm64_t *imm);
 
 void init_amd64_copyb_attributes(ir_node *node, unsigned size);
 
+void amd64_init_op(ir_op *op, unsigned latency, unsigned ports, unsigned busy);
+
 int amd64_attrs_equal(const ir_node *a, const ir_node *b);
 int amd64_addr_attrs_equal(const ir_node *a, const ir_node *b);
 int amd64_binop_addr_attrs_equal(const ir_node *a, const ir_node *b);
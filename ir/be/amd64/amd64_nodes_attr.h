@@ -48,6 +48,13 @@ typedef struct amd64_imm64_t {
 	ENUMBF(x86_immediate_kind_t) kind : 8;
 } amd64_imm64_t;
 
+/** Machine model of an amd64 opcode, see amd64_spec.pl. */
+typedef struct amd64_op_attr_t {
+	unsigned latency; /**< cycles until the results are available */
+	unsigned ports;   /**< bitset of the execution ports */
+	unsigned busy;    /**< cycles a port is occupied */
+} amd64_op_attr_t;
+
 typedef struct amd64_attr_t {
 	except_attr exc; /**< the exception attribute. MUST be the first one. */
 	ENUMBF(amd64_op_mode_t) op_mode : 5;
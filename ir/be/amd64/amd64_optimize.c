@@ -9,6 +9,7 @@
  */
 #include "amd64_optimize.h"
 
+#include "amd64_bearch_t.h"
 #include "amd64_new_nodes.h"
 #include "amd64_transform.h"
 #include "benode.h"
@@ -185,9 +186,190 @@ static void peephole_amd64_cvtsi2sX(ir_node *const node)
 	sched_add_after(pxor, keep);
 }
 
+/* only optimize up to 16 slots at the top of an IncSP area */
+#define MAXPUSH_OPTIMIZE 16
+
+/**
+ * Returns the slot a stack access at @p offset behind an IncSP of @p inc_ofs
+ * bytes uses, counted in registers from the top of the area, or -1 if the
+ * access is out of reach.
+ */
+static int get_top_slot(int const inc_ofs, int32_t const offset)
+{
+	int const dist = inc_ofs - offset;
+	if (dist < AMD64_REGISTER_SIZE
+	 || dist > MAXPUSH_OPTIMIZE * AMD64_REGISTER_SIZE)
+		return -1;
+	return dist / AMD64_REGISTER_SIZE - 1;
+}
+
+/**
+ * Tries to create pushes from IncSP, mov_store combinations.
+ * Stores filling the top of the allocated area are replaced by pushes in
+ * front of the IncSP, the IncSP is modified (possibly into IncSP 0, but not
+ * removed).
+ */
+static void peephole_IncSP_store_to_push(ir_node *const irn)
+{
+	int inc_ofs = be_get_IncSP_offset(irn);
+	if (inc_ofs < AMD64_REGISTER_SIZE)
+		return;
+
+	ir_node *stores[MAXPUSH_OPTIMIZE];
+	memset(stores, 0, sizeof(stores));
+
+	/* Collect the stores directly behind the IncSP which write a register into
+	 * the freshly allocated area, sorted by their slot. */
+	arch_register_t const *const rsp = &amd64_registers[REG_RSP];
+	sched_foreach_after(irn, node) {
+		if (!is_amd64_mov_store(node))
+			break;
+
+		amd64_binop_addr_attr_t const *const attr = get_amd64_binop_addr_attr_const(node);
+		x86_addr_t              const *const addr = &attr->base.addr;
+		if (attr->base.base.op_mode != AMD64_OP_ADDR_REG
+		 || addr->variant != X86_ADDR_BASE
+		 || get_irn_n(node, addr->base_input) != irn)
+			continue;
+		if (addr->immediate.kind != X86_IMM_VALUE)
+			break;
+
+		/* the pushes happen before the IncSP and change rsp */
+		ir_node *const val = get_irn_n(node, attr->u.reg_input);
+		if (arch_get_irn_register(val) == rsp)
+			break;
+
+		/* a push always writes 8 bytes, the upper half of a 32bit store is
+		 * either unused or overwritten by a later store */
+		x86_insn_size_t const size = attr->base.base.size;
+		if (size != X86_SIZE_32 && size != X86_SIZE_64)
+			break;
+
+		int32_t const offset = addr->immediate.offset;
+		if (offset < 0 || (inc_ofs - offset) % AMD64_REGISTER_SIZE != 0)
+			break;
+		int const storeslot = get_top_slot(inc_ofs, offset);
+		if (storeslot < 0)
+			continue;
+		if (stores[storeslot] != NULL)
+			break;
+		stores[storeslot] = node;
+	}
+
+	ir_node *const block   = get_nodes_block(irn);
+	ir_node       *curr_sp = be_get_IncSP_pred(irn);
+	for (int i = 0; i < MAXPUSH_OPTIMIZE && stores[i] != NULL; ++i) {
+		ir_node                       *const store = stores[i];
+		amd64_binop_addr_attr_t const *const attr  = get_amd64_binop_addr_attr_const(store);
+		dbg_info                      *const dbgi  = get_irn_dbg_info(store);
+		ir_node                       *const mem   = get_irn_n(store, attr->base.addr.mem_input);
+		ir_node                       *const val   = get_irn_n(store, attr->u.reg_input);
+		ir_node                       *const push  = new_bd_amd64_push_reg(dbgi, block, curr_sp, mem, val, X86_SIZE_64);
+		assert(get_irn_mode(mem) == mode_M);
+		sched_add_before(irn, push);
+		curr_sp = be_new_Proj_reg(push, pn_amd64_push_reg_stack, rsp);
+
+		ir_node *const push_mem = be_new_Proj(push, pn_amd64_push_reg_M);
+		be_peephole_exchange(store, push_mem);
+
+		inc_ofs -= AMD64_REGISTER_SIZE;
+	}
+
+	be_set_IncSP_pred(irn, curr_sp);
+	be_set_IncSP_offset(irn, inc_ofs);
+}
+
+/**
+ * Tries to create pops from mov_gp, IncSP combinations.
+ * 64bit loads from the top of the freed area are replaced by pops behind the
+ * IncSP, the IncSP is modified (possibly into IncSP 0, but not removed).
+ */
+static void peephole_load_IncSP_to_pop(ir_node *const irn)
+{
+	int inc_ofs = -be_get_IncSP_offset(irn);
+	if (inc_ofs < AMD64_REGISTER_SIZE)
+		return;
+
+	ir_node  *loads[MAXPUSH_OPTIMIZE];
+	unsigned  regmask = 0;
+	memset(loads, 0, sizeof(loads));
+
+	ir_node *const pred_sp = be_get_IncSP_pred(irn);
+	sched_foreach_reverse_before(irn, node) {
+		if (!is_amd64_mov_gp(node))
+			break;
+
+		/* a pop always loads 64bit, mov_gp zero extends smaller values */
+		amd64_addr_attr_t const *const attr = get_amd64_addr_attr_const(node);
+		x86_addr_t        const *const addr = &attr->addr;
+		if (attr->base.op_mode != AMD64_OP_ADDR
+		 || attr->base.size != X86_SIZE_64
+		 || addr->variant != X86_ADDR_BASE
+		 || addr->immediate.kind != X86_IMM_VALUE
+		 || get_irn_n(node, addr->base_input) != pred_sp)
+			break;
+
+		/* the pops are moved behind all loads we walk over */
+		arch_register_t const *const dreg = arch_get_irn_register_out(node, pn_amd64_mov_gp_res);
+		if (regmask & (1u << dreg->index))
+			break;
+		regmask |= 1u << dreg->index;
+
+		int32_t const offset = addr->immediate.offset;
+		if (offset < 0 || (inc_ofs - offset) % AMD64_REGISTER_SIZE != 0)
+			break;
+		int const loadslot = get_top_slot(inc_ofs, offset);
+		if (loadslot < 0)
+			continue;
+		if (loads[loadslot] != NULL)
+			break;
+		loads[loadslot] = node;
+	}
+
+	int n_pops = 0;
+	while (n_pops < MAXPUSH_OPTIMIZE && loads[n_pops] != NULL)
+		++n_pops;
+	if (n_pops == 0)
+		return;
+
+	/* free the area below the pops first */
+	inc_ofs -= n_pops * AMD64_REGISTER_SIZE;
+	be_set_IncSP_offset(irn, -inc_ofs);
+
+	ir_node *const block     = get_nodes_block(irn);
+	ir_node       *curr_sp   = irn;
+	ir_node       *first_pop = NULL;
+	for (int i = n_pops; i-- > 0;) {
+		ir_node                 *const load = loads[i];
+		amd64_addr_attr_t const *const attr = get_amd64_addr_attr_const(load);
+		dbg_info                *const dbgi = get_irn_dbg_info(load);
+		ir_node                 *const mem  = get_irn_n(load, attr->addr.mem_input);
+		arch_register_t   const *const reg  = arch_get_irn_register_out(load, pn_amd64_mov_gp_res);
+		ir_node                 *const pop  = new_bd_amd64_pop_reg(dbgi, block, mem, curr_sp, X86_SIZE_64);
+		arch_set_irn_register_out(pop, pn_amd64_pop_reg_res, reg);
+		if (first_pop == NULL)
+			first_pop = pop;
+
+		sched_add_after(skip_Proj(curr_sp), pop);
+		curr_sp = be_new_Proj_reg(pop, pn_amd64_pop_reg_stack, &amd64_registers[REG_RSP]);
+
+		be_peephole_exchange(load, pop);
+	}
+
+	edges_reroute_except(irn, curr_sp, first_pop);
+}
+
 static void peephole_be_IncSP(ir_node *const node)
 {
-	be_peephole_IncSP_IncSP(node);
+	/* first optimize incsp->incsp combinations */
+	if (be_peephole_IncSP_IncSP(node))
+		return;
+
+	/* transform IncSP->mov_store combinations to push where possible */
+	peephole_IncSP_store_to_push(node);
+
+	/* transform mov_gp->IncSP combinations to pop where possible */
+	peephole_load_IncSP_to_pop(node);
 }
 
 void amd64_peephole_optimization(ir_graph *const irg)
@@ -118,6 +118,8 @@ my $binop = {
 	attr_type => "amd64_binop_addr_attr_t",
 	attr      => "const amd64_binop_addr_attr_t *attr_init",
 	emit      => "{name}%M %AM",
+	latency   => 1,
+	ports     => "0156",
 };
 
 my $binop_commutative = {
@@ -129,6 +131,23 @@ my $binop_commutative = {
 	attr_type => "amd64_binop_addr_attr_t",
 	attr      => "const amd64_binop_addr_attr_t *attr_init",
 	emit      => "{name}%M %AM",
+	latency   => 1,
+	ports     => "0156",
+};
+
+# read-modify-write operations on memory (destination address mode)
+my $binop_mem = {
+	op_flags  => [ "uses_memory" ],
+	irn_flags => [ "modify_flags" ],
+	state     => "exc_pinned",
+	in_reqs   => "...",
+	out_reqs  => [ "mem" ],
+	outs      => [ "M" ],
+	attr_type => "amd64_binop_addr_attr_t",
+	attr      => "const amd64_binop_addr_attr_t *attr_init",
+	emit      => "{name}%M %AM",
+	latency   => 6,
+	ports     => "0156",
 };
 
 my $cmpop = {
@@ -140,6 +159,8 @@ my $cmpop = {
 	attr_type => "amd64_binop_addr_attr_t",
 	attr      => "const amd64_binop_addr_attr_t *attr_init",
 	emit      => "{name}%M %AM",
+	latency   => 1,
+	ports     => "0156",
 };
 
 my $sextop = {
@@ -148,6 +169,8 @@ my $sextop = {
 	ins      => [ "val" ],
 	init     => "arch_set_additional_pressure(res, &amd64_reg_classes[CLASS_amd64_gp], 1);",
 	emit     => "{name}",
+	latency  => 1,
+	ports    => "06",
 };
 
 my $divop = {
@@ -161,6 +184,9 @@ my $divop = {
 	            ."amd64_op_mode_t op_mode = AMD64_OP_REG;\n",
 	attr      => "x86_insn_size_t size",
 	emit      => "{name}%M %AM",
+	latency   => 26,
+	ports     => "0",
+	busy      => 6,
 };
 
 my $mulop = {
@@ -176,6 +202,8 @@ my $mulop = {
 	attr_type => "amd64_addr_attr_t",
 	attr      => "x86_insn_size_t size, amd64_op_mode_t op_mode, x86_addr_t addr",
 	emit      => "{name}%M %AM",
+	latency   => 3,
+	ports     => "1",
 };
 
 my $shiftop = {
@@ -186,6 +214,8 @@ my $shiftop = {
 	attr_type => "amd64_shift_attr_t",
 	attr      => "const amd64_shift_attr_t *attr_init",
 	emit      => "{name}%M %SO",
+	latency   => 1,
+	ports     => "06",
 };
 
 my $unop = {
@@ -199,6 +229,8 @@ my $unop = {
 	fixed     => "amd64_op_mode_t op_mode = AMD64_OP_REG;\n"
 	            ."x86_addr_t addr = { .base_input = 0, .variant = X86_ADDR_REG };",
 	emit      => "{name}%M %AM",
+	latency   => 1,
+	ports     => "0156",
 };
 
 my $unop_out = {
@@ -209,6 +241,8 @@ my $unop_out = {
 	attr_type => "amd64_addr_attr_t",
 	attr      => "x86_insn_size_t size, amd64_op_mode_t op_mode, x86_addr_t addr",
 	emit      => "{name}%M %AM, %D0",
+	latency   => 3,
+	ports     => "1",
 };
 
 my $binopx = {
@@ -220,6 +254,8 @@ my $binopx = {
 	attr_type => "amd64_binop_addr_attr_t",
 	attr      => "const amd64_binop_addr_attr_t *attr_init",
 	emit      => "{name} %AM",
+	latency   => 4,
+	ports     => "01",
 };
 
 my $binopx_commutative = {
@@ -231,6 +267,8 @@ my $binopx_commutative = {
 	attr_type => "amd64_binop_addr_attr_t",
 	attr      => "const amd64_binop_addr_attr_t *attr_init",
 	emit      => "{name}%MX %AM",
+	latency   => 4,
+	ports     => "01",
 };
 
 my $cvtop2x = {
@@ -241,6 +279,8 @@ my $cvtop2x = {
 	attr_type => "amd64_addr_attr_t",
 	attr      => "x86_insn_size_t size, amd64_op_mode_t op_mode, x86_addr_t addr",
 	emit      => "{name} %AM, %^D0",
+	latency   => 5,
+	ports     => "01",
 };
 
 my $cvtopx2i = {
@@ -251,6 +291,8 @@ my $cvtopx2i = {
 	attr_type => "amd64_addr_attr_t",
 	attr      => "x86_insn_size_t size, amd64_op_mode_t op_mode, x86_addr_t addr",
 	emit      => "{name} %AM, %D0",
+	latency   => 6,
+	ports     => "01",
 };
 
 my $movopx = {
@@ -261,6 +303,8 @@ my $movopx = {
 	attr_type => "amd64_addr_attr_t",
 	attr      => "amd64_op_mode_t op_mode, x86_addr_t addr",
 	emit      => "{name} %AM, %D0",
+	latency   => 1,
+	ports     => "015",
 };
 
 my $x87const = {
@@ -271,6 +315,8 @@ my $x87const = {
 	fixed     => "amd64_op_mode_t op_mode = AMD64_OP_X87;\n"
 	            ."x86_insn_size_t size    = X86_SIZE_80;\n",
 	emit      => "{name}",
+	latency   => 1,
+	ports     => "05",
 };
 
 my $x87unop = {
@@ -280,6 +326,8 @@ my $x87unop = {
 	ins       => [ "value" ],
 	attr_type => "amd64_x87_attr_t",
 	emit      => "{name}",
+	latency   => 1,
+	ports     => "0",
 };
 
 my $x87binop = {
@@ -289,6 +337,8 @@ my $x87binop = {
 	out_reqs  => [ "x87" ],
 	ins       => [ "left", "right" ],
 	attr_type => "amd64_x87_attr_t",
+	latency   => 3,
+	ports     => "5",
 };
 
 my $x87store = {
@@ -299,6 +349,8 @@ my $x87store = {
 	outs      => [ "M" ],
 	attr_type => "amd64_x87_binop_addr_attr_t",
 	attr      => "const amd64_binop_addr_attr_t *attr_init",
+	latency   => 1,
+	ports     => "4",
 };
 
 %nodes = (
@@ -312,6 +364,8 @@ push_am => {
 	attr      => "x86_insn_size_t size, x86_addr_t addr",
 	fixed     => "amd64_op_mode_t op_mode = AMD64_OP_ADDR;\n",
 	emit      => "push%M %A",
+	latency   => 1,
+	ports     => "4",
 },
 
 push_reg => {
@@ -323,6 +377,8 @@ push_reg => {
 	fixed     => "amd64_op_mode_t op_mode = AMD64_OP_NONE;\n",
 	attr      => "x86_insn_size_t size",
 	emit      => "push%M %^S2",
+	latency   => 1,
+	ports     => "4",
 },
 
 pop_am => {
@@ -335,6 +391,21 @@ pop_am => {
 	attr      => "x86_insn_size_t size, x86_addr_t addr",
 	fixed     => "amd64_op_mode_t op_mode = AMD64_OP_ADDR;\n",
 	emit      => "pop%M %A",
+	latency   => 1,
+	ports     => "23",
+},
+
+pop_reg => {
+	state     => "exc_pinned",
+	in_reqs   => [ "mem", "rsp"   ],
+	ins       => [ "mem", "stack" ],
+	out_reqs  => [ "gp",  "none",   "mem", "rsp:I" ],
+	outs      => [ "res", "unused", "M",   "stack" ],
+	fixed     => "amd64_op_mode_t op_mode = AMD64_OP_NONE;\n",
+	attr      => "x86_insn_size_t size",
+	emit      => "pop%M %D0",
+	latency   => 1,
+	ports     => "23",
 },
 
 sub_sp => {
@@ -348,6 +419,8 @@ sub_sp => {
 	attr      => "const amd64_binop_addr_attr_t *attr_init",
 	emit      => "subq %AM\n".
 	             "movq %%rsp, %D1",
+	latency   => 1,
+	ports     => "0156",
 },
 
 leave => {
@@ -358,6 +431,8 @@ leave => {
 	fixed     => "amd64_op_mode_t op_mode = AMD64_OP_NONE;\n"
 	            ."x86_insn_size_t size    = X86_SIZE_64;\n",
 	emit      => "leave",
+	latency   => 1,
+	ports     => "0156",
 },
 
 add => { template => $binop_commutative },
@@ -380,7 +455,11 @@ div => { template => $divop },
 
 idiv => { template => $divop },
 
-imul => { template => $binop_commutative },
+imul => {
+	template => $binop_commutative,
+	latency  => 3,
+	ports    => "1",
+},
 
 imul_1op => {
 	template => $mulop,
@@ -410,6 +489,31 @@ not => { template => $unop },
 
 xor => { template => $binop_commutative },
 
+add_mem => {
+	template => $binop_mem,
+	name     => "add",
+},
+
+and_mem => {
+	template => $binop_mem,
+	name     => "and",
+},
+
+or_mem => {
+	template => $binop_mem,
+	name     => "or",
+},
+
+sub_mem => {
+	template => $binop_mem,
+	name     => "sub",
+},
+
+xor_mem => {
+	template => $binop_mem,
+	name     => "xor",
+},
+
 xor_0 => {
 	op_flags  => [ "constlike" ],
 	irn_flags => [ "modify_flags", "rematerializable" ],
@@ -418,6 +522,8 @@ xor_0 => {
 	fixed     => "amd64_op_mode_t op_mode = AMD64_OP_NONE;",
 	attr      => "x86_insn_size_t size",
 	emit      => "xor%M %3D0, %3D0",
+	latency   => 1,
+	ports     => "0156",
 },
 
 mov_imm => {
@@ -428,6 +534,8 @@ mov_imm => {
 	attr_type => "amd64_movimm_attr_t",
 	attr      => "x86_insn_size_t size, const amd64_imm64_t *imm",
 	emit      => 'mov%M $%C, %D0',
+	latency   => 1,
+	ports     => "0156",
 },
 
 movs => {
@@ -438,6 +546,8 @@ movs => {
 	attr_type => "amd64_addr_attr_t",
 	attr      => "x86_insn_size_t size, amd64_op_mode_t op_mode, x86_addr_t addr",
 	emit      => "movs%Mq %AM, %^D0",
+	latency   => 1,
+	ports     => "0156",
 },
 
 mov_gp => {
@@ -447,6 +557,8 @@ mov_gp => {
 	outs      => [ "res", "unused", "M" ],
 	attr_type => "amd64_addr_attr_t",
 	attr      => "x86_insn_size_t size, amd64_op_mode_t op_mode, x86_addr_t addr",
+	latency   => 1,
+	ports     => "0156",
 },
 
 ijmp => {
@@ -458,6 +570,8 @@ ijmp => {
 	attr_type => "amd64_addr_attr_t",
 	attr      => "x86_insn_size_t size, amd64_op_mode_t op_mode, x86_addr_t addr",
 	emit      => "jmp %*AM",
+	latency   => 1,
+	ports     => "6",
 },
 
 jmp => {
@@ -467,6 +581,8 @@ jmp => {
 	out_reqs  => [ "exec" ],
 	fixed     => "amd64_op_mode_t op_mode = AMD64_OP_NONE;\n"
 	            ."x86_insn_size_t size    = X86_SIZE_64;\n",
+	latency   => 1,
+	ports     => "6",
 },
 
 cmp => { template => $cmpop },
@@ -482,6 +598,8 @@ cmpxchg => {
 	attr_type => "amd64_binop_addr_attr_t",
 	attr      => "const amd64_binop_addr_attr_t *attr_init",
 	emit      => "lock cmpxchg%M %AM",
+	latency   => 18,
+	ports     => "0156",
 },
 
 # TODO Setcc can also operate on memory
@@ -495,6 +613,20 @@ setcc => {
 	attr      => "x86_condition_code_t cc",
 	fixed     => "x86_insn_size_t size = X86_SIZE_8;",
 	emit      => "set%P0 %D0",
+	latency   => 1,
+	ports     => "06",
+},
+
+cmovcc => {
+	in_reqs   => [ "gp", "gp", "flags" ],
+	out_reqs  => [ "gp" ],
+	ins       => [ "val_false", "val_true", "eflags" ],
+	outs      => [ "res" ],
+	attr_type => "amd64_cc_attr_t",
+	attr      => "x86_insn_size_t size, x86_condition_code_t cc",
+	emit      => "cmov%P0 %S1, %D0",
+	latency   => 1,
+	ports     => "06",
 },
 
 lea => {
@@ -506,6 +638,8 @@ lea => {
 	attr      => "x86_insn_size_t size, x86_addr_t addr",
 	fixed     => "amd64_op_mode_t op_mode = AMD64_OP_ADDR;\n",
 	emit      => "lea%M %A, %D0",
+	latency   => 1,
+	ports     => "15",
 },
 
 jcc => {
@@ -518,6 +652,8 @@ jcc => {
 	attr_type => "amd64_cc_attr_t",
 	attr      => "x86_condition_code_t cc",
 	fixed     => "x86_insn_size_t size = X86_SIZE_64;",
+	latency   => 1,
+	ports     => "06",
 },
 
 mov_store => {
@@ -529,6 +665,8 @@ mov_store => {
 	attr_type => "amd64_binop_addr_attr_t",
 	attr      => "const amd64_binop_addr_attr_t *attr_init",
 	emit      => "mov%M %AM",
+	latency   => 1,
+	ports     => "4",
 },
 
 jmp_switch => {
@@ -538,6 +676,8 @@ jmp_switch => {
 	out_reqs  => "...",
 	attr_type => "amd64_switch_jmp_attr_t",
 	attr      => "amd64_op_mode_t op_mode, x86_insn_size_t size, const x86_addr_t *addr, const ir_switch_table *table, ir_entity *table_entity",
+	latency   => 1,
+	ports     => "6",
 },
 
 call => {
@@ -549,6 +689,8 @@ call => {
 	attr_type => "amd64_call_addr_attr_t",
 	attr      => "const amd64_call_addr_attr_t *attr_init",
 	emit      => "call %*AM",
+	latency   => 1,
+	ports     => "6",
 },
 
 ret => {
@@ -560,6 +702,8 @@ ret => {
 	fixed    => "amd64_op_mode_t op_mode = AMD64_OP_NONE;\n"
 	           ."x86_insn_size_t size    = X86_SIZE_64;\n",
 	emit     => "ret",
+	latency  => 1,
+	ports    => "6",
 },
 
 bsf => { template => $unop_out },
@@ -573,6 +717,9 @@ adds => { template => $binopx_commutative },
 divs => {
 	template => $binopx,
 	emit     => "divs%MX %AM",
+	latency  => 11,
+	ports    => "0",
+	busy     => 4,
 },
 
 movs_xmm => {
@@ -592,6 +739,8 @@ movs_store_xmm => {
 	attr_type => "amd64_binop_addr_attr_t",
 	attr      => "const amd64_binop_addr_attr_t *attr_init",
 	emit      => "movs%MX %^S0, %A",
+	latency   => 1,
+	ports     => "4",
 },
 
 subs => {
@@ -608,6 +757,8 @@ ucomis => {
 	attr_type => "amd64_binop_addr_attr_t",
 	attr      => "const amd64_binop_addr_attr_t *attr_init",
 	emit      => "ucomis%MX %AM",
+	latency   => 2,
+	ports     => "0",
 },
 
 xorp_0 => {
@@ -618,9 +769,15 @@ xorp_0 => {
 	fixed     => "amd64_op_mode_t op_mode = AMD64_OP_NONE;",
 	attr      => "x86_insn_size_t size",
 	emit      => "xorp%MX %^D0, %^D0",
+	latency   => 1,
+	ports     => "015",
 },
 
-xorp => { template => $binopx_commutative },
+xorp => {
+	template => $binopx_commutative,
+	latency  => 1,
+	ports    => "015",
+},
 
 movd_xmm_gp => {
 	state     => "exc_pinned",
@@ -630,7 +787,9 @@ movd_xmm_gp => {
 	out_reqs  => [ "gp" ],
 	attr_type => "amd64_addr_attr_t",
 	attr      => "x86_insn_size_t size, amd64_op_mode_t op_mode, x86_addr_t addr",
-	emit      => "movd %S0, %D0"
+	emit      => "movd %S0, %D0",
+	latency   => 2,
+	ports     => "0",
 },
 
 movd_gp_xmm => {
@@ -641,7 +800,9 @@ movd_gp_xmm => {
 	out_reqs  => [ "xmm" ],
 	attr_type => "amd64_addr_attr_t",
 	attr      => "x86_insn_size_t size, amd64_op_mode_t op_mode, x86_addr_t addr",
-	emit      => "movd %S0, %D0"
+	emit      => "movd %S0, %D0",
+	latency   => 2,
+	ports     => "5",
 },
 
 pxor_0 => {
@@ -652,6 +813,8 @@ pxor_0 => {
 	fixed     => "amd64_op_mode_t op_mode = AMD64_OP_NONE;",
 	attr      => "x86_insn_size_t size",
 	emit      => "pxor %^D0, %^D0",
+	latency   => 1,
+	ports     => "015",
 },
 
 # Conversion operations
@@ -696,6 +859,8 @@ movdqu_store => {
 	attr_type => "amd64_binop_addr_attr_t",
 	attr      => "const amd64_binop_addr_attr_t *attr_init",
 	emit      => "movdqu %^S0, %A",
+	latency   => 1,
+	ports     => "4",
 },
 
 copyB => {
@@ -706,6 +871,7 @@ copyB => {
 	attr_type => "amd64_copyb_attr_t",
 	attr      => "unsigned size",
 	latency   => 250,
+	ports     => "0156",
 },
 
 copyB_i => {
@@ -716,6 +882,7 @@ copyB_i => {
 	attr_type => "amd64_copyb_attr_t",
 	attr      => "unsigned size",
 	latency   => 3,
+	ports     => "0156",
 },
 
 l_punpckldq => {
@@ -724,6 +891,7 @@ l_punpckldq => {
 	attr_type => "",
 	dump_func => "NULL",
 	mode      => $mode_xmm,
+	latency   => 0,
 },
 
 l_subpd => {
@@ -732,6 +900,7 @@ l_subpd => {
 	attr_type => "",
 	dump_func => "NULL",
 	mode      => $mode_xmm,
+	latency   => 0,
 },
 
 l_haddpd => {
@@ -740,6 +909,7 @@ l_haddpd => {
 	attr_type => "",
 	dump_func => "NULL",
 	mode      => $mode_xmm,
+	latency   => 0,
 },
 
 punpckldq => { template => $binopx },
@@ -762,6 +932,8 @@ fld => {
 	attr_type => "amd64_x87_addr_attr_t",
 	attr      => "x86_insn_size_t size, amd64_op_mode_t op_mode, x86_addr_t addr",
 	emit      => "fld%FM %AM",
+	latency   => 1,
+	ports     => "05",
 },
 
 fild => {
@@ -774,6 +946,8 @@ fild => {
 	attr_type => "amd64_x87_addr_attr_t",
 	attr      => "x86_insn_size_t size, amd64_op_mode_t op_mode, x86_addr_t addr",
 	emit      => "fild%M %AM",
+	latency   => 1,
+	ports     => "05",
 },
 
 fisttp => {
@@ -799,11 +973,16 @@ fadd => {
 fdiv => {
 	template => $x87binop,
 	emit     => "fdiv%FR%FP %AF",
+	latency  => 15,
+	ports    => "0",
+	busy     => 4,
 },
 
 fmul => {
 	template => $x87binop,
 	emit     => "fmul%FP %AF",
+	latency  => 5,
+	ports    => "0",
 },
 
 fsub => {
@@ -821,6 +1000,8 @@ fucomi => {
 	outs      => [ "flags" ],
 	attr_type => "amd64_x87_attr_t",
 	emit      => "fucom%FPi %F0",
+	latency   => 2,
+	ports     => "0",
 },
 
 fdup => {
@@ -832,6 +1013,8 @@ fdup => {
 	attr        => "const arch_register_t *reg",
 	init        => "attr->x87.reg = reg;",
 	emit        => "fld %F0",
+	latency     => 1,
+	ports       => "05",
 },
 
 fxch => {
@@ -842,6 +1025,7 @@ fxch => {
 	attr        => "const arch_register_t *reg",
 	init        => "attr->x87.reg = reg;",
 	emit        => "fxch %F0",
+	latency     => 0,
 },
 
 fpop => {
@@ -852,6 +1036,29 @@ fpop => {
 	attr        => "const arch_register_t *reg",
 	init        => "attr->x87.reg = reg;",
 	emit        => "fstp %F0",
+	latency     => 1,
+	ports       => "05",
 },
 
 );
+
+# Transform the machine model into op attributes: latency is the number of
+# cycles until the results are available, ports lists the execution ports
+# (Intel numbering) able to execute the instruction and busy is the number of
+# cycles the instruction occupies its port.
+foreach my $op (keys(%nodes)) {
+	my $node     = $nodes{$op};
+	my $template = $node->{template} // {};
+
+	my $latency = $node->{latency} // $template->{latency};
+	die("Latency missing for op $op") if !defined($latency);
+	my $ports = $node->{ports} // $template->{ports} // "";
+	my $busy  = $node->{busy}  // $template->{busy}  // 1;
+
+	my $port_mask = 0;
+	$port_mask |= 1 << $_ foreach split(//, $ports);
+	$node->{op_attr_init} = sprintf("amd64_init_op(op, %u, 0x%X, %u);",
+	                                $latency, $port_mask, $busy);
+}
+
+print "";
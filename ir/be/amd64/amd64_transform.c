@@ -1936,6 +1936,7 @@ no_call_mem:;
 
 			attr.base.addr.base_input = arity;
 			in[arity++]               = callframe;
+			attr.base.addr.mem_input  = arity;
 			in[arity++]               = sync1;
 			sync_ins[sync_arity++]    = make_store_for_mode(mode, dbgi, new_block, arity, in, &attr, false);
 		}
@@ -2135,6 +2136,62 @@ static ir_node *gen_Cond(ir_node *const node)
 	return new_bd_amd64_jcc(dbgi, block, flags, cc);
 }
 
+/**
+ * Creates a setcc whose result is zero extended to 32 bits.
+ */
+static ir_node *create_set_32bit(dbg_info *const dbgi, ir_node *const block,
+                                 ir_node *const flags,
+                                 x86_condition_code_t const cc)
+{
+	ir_node *const setcc = new_bd_amd64_setcc(dbgi, block, flags, cc);
+
+	/* movzbl temp, temp */
+	ir_node *const movzbl_in[] = { setcc };
+	x86_addr_t movzbl_addr = {
+		.base_input = 0,
+		.variant    = X86_ADDR_REG,
+	};
+	ir_node *const movzbl
+		= new_bd_amd64_mov_gp(dbgi, block, ARRAY_SIZE(movzbl_in), movzbl_in,
+		                      reg_reqs, X86_SIZE_8, AMD64_OP_REG, movzbl_addr);
+	return be_new_Proj(movzbl, pn_amd64_mov_gp_res);
+}
+
+static ir_node *gen_Mux(ir_node *const node)
+{
+	ir_node *const sel  = get_Mux_sel(node);
+	ir_mode *const mode = get_irn_mode(node);
+	if (!mode_needs_gp_reg(mode))
+		panic("Mux %+F with non-gp mode not supported", node);
+	/* lower_mode_b guarantees a Cmp selector */
+	ir_mode *const cmp_mode = get_irn_mode(get_Cmp_left(sel));
+	if (mode_is_float(cmp_mode))
+		panic("Mux %+F with float compare not supported", node);
+
+	x86_condition_code_t        cc;
+	ir_node              *const flags     = get_flags_node(sel, &cc);
+	dbg_info             *const dbgi      = get_irn_dbg_info(node);
+	ir_node              *const new_block = be_transform_nodes_block(node);
+	ir_node              *const val_true  = get_Mux_true(node);
+	ir_node              *const val_false = get_Mux_false(node);
+
+	/* Mux(sel, 0, 1) and Mux(sel, 1, 0) are a setcc */
+	if (is_irn_null(val_false) && is_irn_one(val_true))
+		return create_set_32bit(dbgi, new_block, flags, cc);
+	if (is_irn_one(val_false) && is_irn_null(val_true))
+		return create_set_32bit(dbgi, new_block, flags,
+		                        x86_negate_condition_code(cc));
+
+	ir_node        *const new_false = be_transform_node(val_false);
+	ir_node        *const new_true  = be_transform_node(val_true);
+	x86_insn_size_t const size      = get_mode_size_bits(mode) > 32
+	                                ? X86_SIZE_64 : X86_SIZE_32;
+	ir_node        *const cmov      = new_bd_amd64_cmovcc(dbgi, new_block,
+		new_false, new_true, flags, size, cc);
+	arch_set_irn_register_req_out(cmov, 0, &amd64_requirement_gp_same_0);
+	return cmov;
+}
+
 static ir_node *gen_ASM(ir_node *const node)
 {
 	return x86_match_ASM(node, &amd64_asm_constraints);
@@ -2591,8 +2648,100 @@ static ir_node *gen_Conv(ir_node *const node)
 	return be_new_Proj(conv, pn_res);
 }
 
+/**
+ * Checks whether the Load producing @p op can be merged with @p store into a
+ * read-modify-write operation and returns it.
+ */
+static ir_node *dest_am_possible(ir_node *const store, ir_node *const op,
+                                 ir_node *const other)
+{
+	ir_node *const block = get_nodes_block(store);
+	ir_node *const load  = source_am_possible(block, op);
+	if (load == NULL)
+		return NULL;
+	/* store must write to the location the load reads */
+	if (get_Load_ptr(load) != get_Store_ptr(store))
+		return NULL;
+	if (get_Load_volatility(load) == volatility_is_volatile
+	 || ir_throws_exception(load))
+		return NULL;
+	/* the store must directly follow the load in the memory chain */
+	ir_node *const mem = get_Store_mem(store);
+	if (!is_Proj(mem) || get_Proj_pred(mem) != load
+	 || get_irn_n_edges(mem) != 1)
+		return NULL;
+	if (other != NULL && input_depends_on_load(load, other))
+		return NULL;
+	return load;
+}
+
+static ir_node *try_create_dest_am(ir_node *const node)
+{
+	ir_node *const val  = get_Store_value(node);
+	ir_mode *const mode = get_irn_mode(val);
+	if (!mode_needs_gp_reg(mode) || get_mode_size_bits(mode) < 32)
+		return NULL;
+	if (get_Store_volatility(node) == volatility_is_volatile
+	 || ir_throws_exception(node))
+		return NULL;
+	/* store must be the only user of the value */
+	if (get_irn_n_edges(val) != 1
+	 || get_nodes_block(val) != get_nodes_block(node))
+		return NULL;
+
+	construct_binop_func cons;
+	bool                 commutative = true;
+	switch (get_irn_opcode(val)) {
+	case iro_Add: cons = &new_bd_amd64_add_mem; break;
+	case iro_And: cons = &new_bd_amd64_and_mem; break;
+	case iro_Eor: cons = &new_bd_amd64_xor_mem; break;
+	case iro_Or:  cons = &new_bd_amd64_or_mem;  break;
+	case iro_Sub:
+		cons        = &new_bd_amd64_sub_mem;
+		commutative = false;
+		break;
+	default:
+		return NULL;
+	}
+
+	ir_node *op1  = get_binop_left(val);
+	ir_node *op2  = get_binop_right(val);
+	ir_node *load = dest_am_possible(node, op1, op2);
+	if (load == NULL) {
+		if (!commutative)
+			return NULL;
+		load = dest_am_possible(node, op2, op1);
+		if (load == NULL)
+			return NULL;
+		op2 = op1;
+	}
+
+	amd64_binop_addr_attr_t attr;
+	memset(&attr, 0, sizeof(attr));
+
+	ir_node *in[4];
+	int      arity = make_store_value(&attr, mode, op2, in);
+	perform_address_matching(get_Store_ptr(node), &arity, in, &attr.base.addr);
+
+	/* the load and store are merged, so take the memory of the load */
+	attr.base.addr.mem_input = arity;
+	in[arity++]              = be_transform_node(get_Load_mem(load));
+	assert((size_t)arity <= ARRAY_SIZE(in));
+	attr.base.base.size = x86_size_from_mode(mode);
+
+	dbg_info *const dbgi     = get_irn_dbg_info(node);
+	ir_node  *const block    = be_transform_nodes_block(node);
+	ir_node  *const new_node = cons(dbgi, block, arity, in, gp_am_reqs[arity - 1], &attr);
+	set_irn_pinned(new_node, get_irn_pinned(node));
+	return new_node;
+}
+
 static ir_node *gen_Store(ir_node *const node)
 {
+	ir_node *const rmw = try_create_dest_am(node);
+	if (rmw != NULL)
+		return rmw;
+
 	dbg_info *const dbgi  = get_irn_dbg_info(node);
 	ir_node  *const block = be_transform_nodes_block(node);
 	ir_node  *const val   = get_Store_value(node);
@@ -2653,6 +2802,7 @@ ir_node *amd64_new_spill(ir_node *const value, ir_node *const after)
 				.immediate.kind = X86_IMM_FRAMEENT,
 				.variant        = X86_ADDR_BASE,
 				.base_input     = 1,
+				.mem_input      = 2,
 			},
 		},
 		.u.reg_input = 0,
@@ -2679,6 +2829,43 @@ static ir_node *create_sse_spill(dbg_info *const dbgi, ir_node *const block,
 	return new_bd_amd64_movdqu(dbgi, block, arity, in, in_reqs, op_mode, addr);
 }
 
+/**
+ * Returns the size of the low part of the gp value @p value which has to be
+ * saved. All bits above it are known to be zero, or copies of its sign bit if
+ * @p sign_extended is set.
+ */
+static x86_insn_size_t get_gp_value_size(ir_node const *const value,
+                                         bool *const sign_extended)
+{
+	*sign_extended = false;
+	ir_node const *const node = skip_Proj_const(value);
+	if (!is_amd64_irn(node))
+		return X86_SIZE_64;
+	/* all nodes below have their result at output 0 */
+	if (is_Proj(value) && get_Proj_num(value) != 0)
+		return X86_SIZE_64;
+
+	x86_insn_size_t const size = get_amd64_attr_const(node)->size;
+	if (is_amd64_mov_gp(node)) {
+		/* zero extends to 64bit */
+		return size;
+	} else if (is_amd64_movs(node)) {
+		/* sign extends to 64bit */
+		*sign_extended = true;
+		return size;
+	} else if (size == X86_SIZE_32
+	        && (is_amd64_add(node) || is_amd64_and(node) || is_amd64_or(node)
+	         || is_amd64_xor(node) || is_amd64_sub(node) || is_amd64_sbb(node)
+	         || is_amd64_imul(node) || is_amd64_neg(node) || is_amd64_not(node)
+	         || is_amd64_shl(node) || is_amd64_shr(node) || is_amd64_sar(node)
+	         || is_amd64_lea(node) || is_amd64_mov_imm(node)
+	         || is_amd64_xor_0(node) || is_amd64_cmovcc(node))) {
+		/* writing a 32bit register clears the upper half */
+		return X86_SIZE_32;
+	}
+	return X86_SIZE_64;
+}
+
 ir_node *amd64_new_reload(ir_node *value, ir_node *spill, ir_node *before)
 {
 	ir_node  *const block = get_block(before);
@@ -2698,9 +2885,12 @@ ir_node *amd64_new_reload(ir_node *value, ir_node *spill, ir_node *before)
 	create_mov_func cons;
 	x86_insn_size_t size;
 	if (amd64_mode_needs_gp_reg(mode)) {
-		size   = X86_SIZE_64;
-		cons   = &new_bd_amd64_mov_gp;
-		pn_res = pn_amd64_mov_gp_res;
+		/* reload only the bytes carrying information, the coalescer reports
+		 * the final slot size back to the spill in amd64_set_frame_entity */
+		bool sign_extended;
+		size   = get_gp_value_size(value, &sign_extended);
+		cons   = sign_extended ? &new_bd_amd64_movs : &new_bd_amd64_mov_gp;
+		pn_res = sign_extended ? pn_amd64_movs_res : pn_amd64_mov_gp_res;
 	} else if (mode == x86_mode_E) {
 		size   = X86_SIZE_80;
 		cons   = &new_bd_amd64_fld;
@@ -2719,6 +2909,68 @@ ir_node *amd64_new_reload(ir_node *value, ir_node *spill, ir_node *before)
 	return be_new_Proj(load, pn_res);
 }
 
+static bool amd64_possible_memory_operand(ir_node const *const irn,
+                                          unsigned const i)
+{
+	if (!is_amd64_irn(irn))
+		return false;
+	if (get_amd64_attr_const(irn)->op_mode != AMD64_OP_REG_REG)
+		return false;
+	if (!is_amd64_add(irn) && !is_amd64_and(irn) && !is_amd64_or(irn)
+	 && !is_amd64_xor(irn) && !is_amd64_sub(irn) && !is_amd64_imul(irn)
+	 && !is_amd64_cmp(irn) && !is_amd64_test(irn))
+		return false;
+
+	/* only the right operand may be a memory operand, the left one only after
+	 * swapping the inputs of a commutative operation */
+	if (i == 0) {
+		if (!(arch_get_irn_flags(irn) & amd64_arch_irn_flag_commutative_binop))
+			return false;
+	} else if (i != 1) {
+		return false;
+	}
+
+	arch_register_req_t const *const req = arch_get_irn_register_req_in(irn, i);
+	if (req->cls != &amd64_reg_classes[CLASS_amd64_gp] || req->limited != NULL)
+		return false;
+
+	/* only gp reloads are folded, the operation reads as many bytes from the
+	 * slot as its size says */
+	ir_node const *const load = get_Proj_pred(get_irn_n(irn, i));
+	return is_amd64_mov_gp(load);
+}
+
+bool amd64_perform_memory_operand(ir_node *const irn, unsigned const i)
+{
+	if (!amd64_possible_memory_operand(irn, i))
+		return false;
+
+	ir_node *const op    = get_irn_n(irn, i);
+	ir_node *const load  = get_Proj_pred(op);
+	ir_node *const other = get_irn_n(irn, 1 - i);
+	ir_node *const frame = get_irn_n(load, 0);
+	ir_node *const spill = get_irn_n(load, 1);
+
+	amd64_binop_addr_attr_t *const attr = get_amd64_binop_addr_attr(irn);
+	attr->base.base.op_mode    = AMD64_OP_REG_ADDR;
+	attr->base.addr            = get_amd64_addr_attr_const(load)->addr;
+	attr->base.addr.base_input = 1;
+	attr->base.addr.mem_input  = 2;
+	attr->u.reg_input          = 0;
+
+	ir_node *const in[] = { other, frame, spill };
+	set_irn_in(irn, ARRAY_SIZE(in), in);
+	arch_set_irn_register_reqs_in(irn, reg_reg_mem_reqs);
+
+	/* kill the reload */
+	assert(get_irn_n_edges(op) == 0);
+	assert(get_irn_n_edges(load) == 1);
+	sched_remove(load);
+	kill_node(op);
+	kill_node(load);
+	return true;
+}
+
 static ir_node *gen_Load(ir_node *const node)
 {
 
@@ -2951,22 +3203,12 @@ static ir_node *gen_ffs(ir_node *const node)
 	                                       new_bd_amd64_bsf, pn_amd64_bsf_res);
 	ir_node  *const bsf     = skip_Proj(bsf_res);
 
-	/* seteq temp */
-	dbg_info *const dbgi    = get_irn_dbg_info(bsf);
-	ir_node  *const block   = get_nodes_block(bsf);
-	ir_node  *const flags   = be_new_Proj(bsf, pn_amd64_bsf_flags);
-	ir_node  *const setcc   = new_bd_amd64_setcc(dbgi, block, flags, x86_cc_equal);
-
-	/* movzbl temp, temp */
-	ir_node  *const movzbl_in[] = { setcc };
-	x86_addr_t movzbl_addr = {
-		.base_input = 0,
-		.variant    = X86_ADDR_REG,
-	};
-	ir_node *const movzbl
-		= new_bd_amd64_mov_gp(dbgi, block, ARRAY_SIZE(movzbl_in), movzbl_in,
-		                      reg_reqs, X86_SIZE_8, AMD64_OP_REG, movzbl_addr);
-	ir_node *const movzbl_res = be_new_Proj(movzbl, pn_amd64_mov_gp_res);
+	/* seteq temp; movzbl temp, temp */
+	dbg_info *const dbgi       = get_irn_dbg_info(bsf);
+	ir_node  *const block      = get_nodes_block(bsf);
+	ir_node  *const flags      = be_new_Proj(bsf, pn_amd64_bsf_flags);
+	ir_node  *const movzbl_res = create_set_32bit(dbgi, block, flags,
+	                                              x86_cc_equal);
 
 	/* neg temp */
 	x86_insn_size_t size    = get_amd64_attr_const(bsf)->size;
@@ -3261,6 +3503,7 @@ static void amd64_register_transformers(void)
 	be_set_transform_function(op_Mod,               gen_Mod);
 	be_set_transform_function(op_Mul,               gen_Mul);
 	be_set_transform_function(op_Mulh,              gen_Mulh);
+	be_set_transform_function(op_Mux,               gen_Mux);
 	be_set_transform_function(op_Not,               gen_Not);
 	be_set_transform_function(op_Or,                gen_Or);
 	be_set_transform_function(op_Phi,               gen_Phi);
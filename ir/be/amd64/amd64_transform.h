@@ -32,6 +32,11 @@ ir_node *amd64_new_spill(ir_node *value, ir_node *after);
 
 ir_node *amd64_new_reload(ir_node *value, ir_node *spill, ir_node *before);
 
+/**
+ * Folds the reload at input @p i of @p irn into a memory operand if possible.
+ */
+bool amd64_perform_memory_operand(ir_node *irn, unsigned i);
+
 void amd64_transform_graph(ir_graph *irg);
 
 ir_node *amd64_new_IncSP(ir_node *block, ir_node *old_sp, int offset,
@@ -20,6 +20,7 @@
 #include "pmap.h"
 #include "timing.h"
 #include "irdump.h"
+#include "irtrace_t.h"
 
 typedef enum be_dump_flags_t {
 	DUMP_NONE     = 0,
@@ -39,6 +40,7 @@ struct be_options_t {
 	bool opt_profile_use;      /**< use existing profile data */
 	bool omit_fp;              /**< try to omit the frame pointer */
 	bool do_verify;            /**< backend verify option */
+	int verify_sample;         /**< verify only every n-th graph */
 	char ilp_solver[128];      /**< the ilp solver name */
 	bool verbose_asm;          /**< dump verbose assembler */
 };
@@ -67,6 +69,13 @@ void be_after_irp_transform(const char *name);
 
 void be_check_verify_result(bool fine, ir_graph *irg);
 
+/**
+ * Returns true if the backend verifiers should check @p irg. With the option
+ * verifysample=n only every n-th graph is checked, but all of its verifiers
+ * run.
+ */
+bool be_verify_due(const ir_graph *irg);
+
 /**
  * Initialize the backend. Must be run first in init_firm();
  */
@@ -104,9 +113,13 @@ typedef enum {
 ENUM_COUNTABLE(be_timer_id_t)
 extern ir_timer_t *be_timers[T_LAST+1];
 
+/** Returns the name of timer @p id (used for statistics and traces). */
+const char *be_get_timer_name(be_timer_id_t id);
+
 static inline void be_timer_push(be_timer_id_t id)
 {
 	assert(id <= T_LAST);
+	ir_trace_push(be_get_timer_name(id), NULL);
 	if (!be_timing)
 		return;
 	ir_timer_push(be_timers[id]);
@@ -115,6 +128,7 @@ static inline void be_timer_push(be_timer_id_t id)
 static inline void be_timer_pop(be_timer_id_t id)
 {
 	assert(id <= T_LAST);
+	ir_trace_pop();
 	if (!be_timing)
 		return;
 	ir_timer_pop(be_timers[id]);
@@ -256,6 +256,16 @@ static inline bool reg_req_has_constraint(const arch_register_req_t *req)
 	return req->limited || req->must_be_different != 0 || req->ignore || req->width != 1;
 }
 
+/**
+ * Execution resources of an instruction, used by the schedulers.
+ */
+typedef struct be_machine_op_t {
+	unsigned latency; /**< cycles until the results are available */
+	unsigned ports;   /**< bitset of the execution ports able to execute the
+	                       instruction, 0 if it needs none */
+	unsigned busy;    /**< cycles the instruction occupies its port */
+} be_machine_op_t;
+
 /**
  * Architecture interface.
  */
@@ -322,6 +332,18 @@ struct arch_isa_if_t {
 	 * number of cycles necessary to execute the instruction.
 	 */
 	unsigned (*get_op_estimated_cost)(const ir_node *irn);
+
+	/**
+	 * Number of instructions the processor can issue per cycle. 0 is treated
+	 * as 1.
+	 */
+	unsigned issue_width;
+
+	/**
+	 * Get the execution resources of node @p irn. May be NULL, then the
+	 * schedulers use get_op_estimated_cost() as latency.
+	 */
+	void (*get_machine_op)(const ir_node *irn, be_machine_op_t *op);
 };
 
 static inline bool arch_irn_is_ignore(const ir_node *irn)
@@ -117,14 +117,19 @@ void be_chordal_dump(unsigned const mask, ir_graph *const irg, arch_register_cla
 	}
 }
 
+typedef struct memory_operand_env_t {
+	const regalloc_if_t *regif;
+	unsigned long        n_folded;
+} memory_operand_env_t;
+
 /**
  * Post-Walker: Checks for the given reload if has only one user that can
  * perform the reload as part of its address mode.
  * Fold the reload into the user it that is possible.
  */
-static void memory_operand_walker(ir_node *irn, void *env)
+static void memory_operand_walker(ir_node *irn, void *data)
 {
-	const regalloc_if_t *regif = (const regalloc_if_t*)env;
+	memory_operand_env_t *const env = (memory_operand_env_t*)data;
 	foreach_irn_in(irn, i, in) {
 		if (!arch_irn_is(skip_Proj(in), reload))
 			continue;
@@ -133,7 +138,11 @@ static void memory_operand_walker(ir_node *irn, void *env)
 		/* only use memory operands, if the reload is only used by 1 node */
 		if (get_irn_n_edges(in) > 1)
 			continue;
-		regif->perform_memory_operand(irn, i);
+		if (env->regif->perform_memory_operand(irn, i)) {
+			++env->n_folded;
+			/* the inputs of irn may have been rearranged */
+			return;
+		}
 	}
 }
 
@@ -144,7 +153,9 @@ void check_for_memory_operands(ir_graph *irg, const regalloc_if_t *regif)
 {
 	if (regif->perform_memory_operand == NULL)
 		return;
-	irg_walk_graph(irg, NULL, memory_operand_walker, (void*)regif);
+	memory_operand_env_t env = { .regif = regif, .n_folded = 0 };
+	irg_walk_graph(irg, NULL, memory_operand_walker, &env);
+	stat_ev_ull("be_folded_reloads", env.n_folded);
 }
 
 static be_node_stats_t last_node_stats;
@@ -178,7 +189,7 @@ static void post_spill(be_chordal_env_t *const chordal_env, ir_graph *const irg,
 	be_timer_pop(T_RA_SPILL_APPLY);
 
 	/* verify schedule and register pressure */
-	if (be_options.do_verify) {
+	if (be_verify_due(irg)) {
 		be_timer_push(T_VERIFY);
 		bool check_schedule = be_verify_schedule(irg);
 		be_check_verify_result(check_schedule, irg);
@@ -17,6 +17,7 @@
 #include "bemodule.h"
 #include "besched.h"
 #include "debug.h"
+#include "iredges_t.h"
 #include "irloop_t.h"
 #include "irnode_t.h"
 #include "set.h"
@@ -63,6 +64,17 @@ static unsigned be_compute_block_pressure(ir_node *const block, arch_register_cl
 	unsigned max_live = (unsigned)ir_nodeset_size(&live_nodes);
 
 	sched_foreach_non_phi_reverse(block, irn) {
+		/* values defined by irn occupy a register at irn even if they are
+		 * never used (think of registers clobbered by a call) */
+		be_add_pressure_t const add = arch_get_additional_pressure(irn, cls);
+		unsigned n_defs = MAX(add, 0);
+		be_foreach_definition(irn, cls, value, req,
+			if (!ir_nodeset_contains(&live_nodes, value))
+				n_defs += req->width;
+		);
+		unsigned const n_live = (unsigned)ir_nodeset_size(&live_nodes);
+		max_live = MAX(n_live + n_defs, max_live);
+
 		be_liveness_transfer(cls, irn, &live_nodes);
 		unsigned cnt = (unsigned)ir_nodeset_size(&live_nodes);
 		max_live = MAX(cnt, max_live);
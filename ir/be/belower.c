@@ -18,6 +18,7 @@
 #include "beirg.h"
 #include "belive.h"
 #include "benode.h"
+#include "beparcopy.h"
 #include "besched.h"
 #include "bessaconstr.h"
 #include "bestat.h"
@@ -46,15 +47,6 @@ typedef struct lower_env_t {
 	                                 at end of Perm's block (used=0, free=1) */
 } lower_env_t;
 
-/** Holds a Perm register pair. */
-typedef struct reg_pair_t {
-	const arch_register_t *in_reg;    /**< a perm IN register */
-	ir_node               *in_node;   /**< the in node to which the register belongs */
-
-	const arch_register_t *out_reg;   /**< a perm OUT register */
-	ir_node               *out_node;  /**< the out node to which the register belongs */
-} reg_pair_t;
-
 static void set_reg_free(unsigned *free_regs, ir_node const *irn, bool const reg_is_free)
 {
 	if (!mode_is_data(get_irn_mode(irn)))
@@ -136,6 +128,39 @@ static arch_register_t const *get_free_register(ir_node *const perm, lower_env_t
 	return NULL;
 }
 
+/** Environment for the parallel copy callbacks of lower_perm_node(). */
+typedef struct lower_perm_env_t {
+	ir_node                     *perm;
+	arch_register_class_t const *cls;
+	ir_node                    **values; /**< node holding each register */
+} lower_perm_env_t;
+
+static void lower_perm_copy(void *const data, unsigned const dst,
+                            unsigned const src, bool const last_read)
+{
+	(void)last_read;
+	lower_perm_env_t      *const env  = (lower_perm_env_t*)data;
+	arch_register_t const *const reg  = arch_register_for_index(env->cls, dst);
+	ir_node               *const copy = be_new_Copy_before_reg(env->values[src], env->perm, reg);
+	DBG((dbg, LEVEL_2, "%+F: inserting %+F for %+F from %s to %s\n", env->perm, copy, env->values[src], arch_register_for_index(env->cls, src)->name, reg->name));
+	env->values[dst] = copy;
+}
+
+static void lower_perm_swap(void *const data, unsigned const reg0,
+                            unsigned const reg1)
+{
+	lower_perm_env_t *const env   = (lower_perm_env_t*)data;
+	ir_node          *const block = get_nodes_block(env->perm);
+	ir_node          *const in[]  = { env->values[reg0], env->values[reg1] };
+	ir_node          *const xchg  = be_new_Perm(block, ARRAY_SIZE(in), in);
+	DBG((dbg, LEVEL_2, "%+F: inserting %+F for %+F (%s) and %+F (%s)\n", env->perm, xchg, in[0], arch_get_irn_register(in[0]), in[1], arch_get_irn_register(in[1])));
+	env->values[reg1] = be_new_Proj_reg(xchg, 0, arch_register_for_index(env->cls, reg1));
+	env->values[reg0] = be_new_Proj_reg(xchg, 1, arch_register_for_index(env->cls, reg0));
+	sched_add_before(env->perm, xchg);
+	/* Prevent that the broken down Perm is visited by the walker. */
+	mark_irn_visited(xchg);
+}
+
 /**
  * Lowers a perm node.  Resolves cycles and creates a bunch of
  * copy and swap operations to permute registers.
@@ -148,15 +173,14 @@ static void lower_perm_node(ir_node *const perm, arch_register_class_t const *co
 {
 	DBG((dbg, LEVEL_1, "lowering %+F\n", perm));
 
-	bool             const use_copies = env->use_copies;
-	unsigned         const n_regs     = cls->n_regs;
-	/* Registers used as inputs of the Perm. */
-	unsigned        *const inregs     = rbitset_alloca(n_regs);
-	/* Map from register index to pair with this register as output. */
-	reg_pair_t     **const oregmap    = ALLOCANZ(reg_pair_t*, n_regs);
-	reg_pair_t      *const pairs      = ALLOCAN(reg_pair_t, arity);
-	reg_pair_t            *pair       = pairs;
-	arch_register_t const *free_reg   = NULL;
+	unsigned  const n_regs  = cls->n_regs;
+	/* parcopy[r] is the input register of the Perm result in register r. */
+	unsigned *const parcopy = ALLOCAN(unsigned, n_regs);
+	ir_node **const outs    = ALLOCANZ(ir_node*, n_regs);
+	ir_node **const values  = ALLOCANZ(ir_node*, n_regs);
+	unsigned        n_pairs = 0;
+	for (unsigned r = 0; r != n_regs; ++r)
+		parcopy[r] = n_regs;
 
 	/* Collect all input-output pairs of the Perm. */
 	for (unsigned pos = 0; pos != arity; ++pos) {
@@ -174,145 +198,54 @@ static void lower_perm_node(ir_node *const perm, arch_register_class_t const *co
 			continue;
 		}
 
-		pair->in_reg   = ireg;
-		pair->in_node  = in;
-		pair->out_reg  = oreg;
-		pair->out_node = out;
-
-		oregmap[oreg->index] = pair++;
-		rbitset_set(inregs, ireg->index);
+		parcopy[oreg->index] = ireg->index;
+		outs[oreg->index]    = out;
+		values[ireg->index]  = in;
+		++n_pairs;
 	}
 
-	if (pair == pairs) {
+	if (n_pairs == 0) {
 		DBG((dbg, LEVEL_1, "%+F is identity\n", perm));
 		goto done;
 	}
 
-	DBG((dbg, LEVEL_1, "%+F has %d unresolved constraints\n", perm, (int)(pair - pairs)));
-
-	/* Build Copy chains. */
-	for (unsigned i = 0; i != n_regs; ++i) {
-		if (rbitset_is_set(inregs, i))
-			continue;
-		/* Found end of chain, i.e. register which is written to, but not read.
-		 * Generate copies by following the chain backwards. */
-		unsigned k = i;
-		for (reg_pair_t const *p; (p = oregmap[k]);) {
-			oregmap[k] = NULL;
-			ir_node *const copy = be_new_Copy_before_reg(p->in_node, perm, p->out_reg);
-			DBG((dbg, LEVEL_2, "%+F: inserting %+F for %+F from %s to %s\n", perm, copy, p->in_node, p->in_reg, p->out_reg));
-			exchange(p->out_node, copy);
-
-			const unsigned new_k = p->in_reg->index;
-			if (!oregmap[new_k] && !free_reg) {
-				/* The invariant of Perm nodes allows us to overwrite
-				 * the first register in a chain with an arbitrary value.
-				 * Only consider this source register if it is allocatable, otherwise it
-				 * might be a special register, e.g. a null register. */
-				be_irg_t const *const birg = be_birg_from_irg(get_irn_irg(perm));
-				if (rbitset_is_set(birg->allocatable_regs, p->in_reg->global_index))
-					free_reg = p->in_reg;
+	DBG((dbg, LEVEL_1, "%+F has %u unresolved constraints\n", perm, n_pairs));
+
+	lower_perm_env_t perm_env = { perm, cls, values };
+
+	/* Build Copy chains. The invariant of Perm nodes allows us to overwrite
+	 * the first register in a chain with an arbitrary value. */
+	unsigned *const freed = rbitset_alloca(n_regs);
+	if (be_parcopy_emit_chains(n_regs, parcopy, freed, lower_perm_copy, &perm_env)) {
+		unsigned temp = n_regs;
+		if (env->use_copies) {
+			/* Only consider a freed register if it is allocatable, otherwise
+			 * it might be a special register, e.g. a null register. */
+			be_irg_t const *const birg = be_birg_from_irg(get_irn_irg(perm));
+			rbitset_foreach(freed, n_regs, r) {
+				if (rbitset_is_set(birg->allocatable_regs, cls->regs[r].global_index)) {
+					temp = r;
+					break;
+				}
 			}
-			k = new_k;
-
-			rbitset_clear(inregs, k);
-		}
-	}
-
-	if (rbitset_is_empty(inregs, n_regs)) {
-		goto done;
-	}
-
-	if (use_copies && free_reg == NULL) {
-		free_reg = get_free_register(perm, env);
-	}
-
-	if (use_copies && free_reg != NULL) {
-		/* Implement cycles using copies and the free register. */
-		for (unsigned i = 0; i != n_regs; /* empty */) {
-			if (!rbitset_is_set(inregs, i)) {
-				++i;
-				continue;
+			if (temp == n_regs) {
+				arch_register_t const *const free_reg = get_free_register(perm, env);
+				if (free_reg != NULL)
+					temp = free_reg->index;
 			}
-			reg_pair_t *start = oregmap[i];
-
-			ir_node *const save_copy = be_new_Copy_before_reg(start->in_node, perm, free_reg);
-
-			reg_pair_t *p = oregmap[start->in_reg->index];
-			do {
-				ir_node *const copy = be_new_Copy_before_reg(p->in_node, perm, p->out_reg);
-				exchange(p->out_node, copy);
-				unsigned const in_idx = p->in_reg->index;
-				rbitset_clear(inregs, in_idx);
-				p = oregmap[in_idx];
-			} while (p != start);
-
-			rbitset_clear(inregs, start->in_reg->index);
-			ir_node *const restore_copy = be_new_Copy_before_reg(save_copy, perm, start->out_reg);
-			exchange(start->out_node, restore_copy);
 		}
-	} else {
-		if (arity == 2) {
+
+		if (temp == n_regs && arity == 2) {
 			DBG((dbg, LEVEL_1, "%+F is transposition\n", perm));
 			return;
 		}
 
-		/* Decompose cycles into transpositions.
-		 *
-		 * Use as many independent transpositions as possible and do not thread
-		 * one value through all transpositions.
-		 * I.e., for the first level of decomposition of a n-Perm do floor(n/2)
-		 * transpositions. This puts floor(n/2) values into the right registers.
-		 * Repeat this for all remaining values until all have the right
-		 * register.
-		 * This way no value is threaded through more than ceil(ld(n/2))
-		 * transpositions (compared to one value being threaded through all
-		 * transpositions using a naive decomposition).
-		 *
-		 * good:            bad:
-		 * r1 r2 r3 r4 r5   r1 r2 r3 r4 r5
-		 * +---+ +---+      +---+
-		 *    +------+         +---+
-		 *          +---+         +---+
-		 * r2 r3 r4 r5 r1            +---+
-		 *                  r2 r3 r4 r5 r1
-		 */
-		ir_node *const block = get_nodes_block(perm);
-		for (unsigned i = 0; i != n_regs;) {
-			if (!rbitset_is_set(inregs, i)) {
-				++i;
-				continue;
-			}
-			reg_pair_t             *p     = oregmap[i];
-			reg_pair_t const *const start = p;
-			for (;;) {
-				reg_pair_t const *const q = oregmap[p->in_reg->index];
-				if (q == start)
-					break;
+		be_parcopy_emit_cycles(n_regs, parcopy, temp, 2, lower_perm_copy, lower_perm_swap, &perm_env);
+	}
 
-				rbitset_clear(inregs, q->out_reg->index);
-				p->in_reg = q->in_reg;
-
-				ir_node *const in[] = { p->in_node, q->in_node };
-				ir_node *const xchg = be_new_Perm(block, ARRAY_SIZE(in), in);
-				DBG((dbg, LEVEL_2, "%+F: inserting %+F for %+F (%s) and %+F (%s)\n", perm, xchg, in[0], arch_get_irn_register(in[0]), in[1], arch_get_irn_register(in[1])));
-				p->in_node           = be_new_Proj_reg(xchg, 0, q->in_reg);
-				ir_node *const new_q = be_new_Proj_reg(xchg, 1, q->out_reg);
-				exchange(q->out_node, new_q);
-				sched_add_before(perm, xchg);
-				/* Prevent that the broken down Perm is visited by the walker. */
-				mark_irn_visited(xchg);
-
-				p = oregmap[q->in_reg->index];
-				if (p == start) {
-					if (start->in_reg == start->out_reg) {
-						rbitset_clear(inregs, q->in_reg->index);
-						exchange(start->out_node, start->in_node);
-					}
-					break;
-				}
-			}
-		}
+	for (unsigned r = 0; r != n_regs; ++r) {
+		if (outs[r] != NULL)
+			exchange(outs[r], values[r]);
 	}
 
 done:
@@ -62,6 +62,7 @@ be_options_t be_options = {
 	.opt_profile_use      = false,
 	.omit_fp              = false,
 	.do_verify            = true,
+	.verify_sample        = 0,
 	.ilp_solver           = "",
 	.verbose_asm          = true,
 };
@@ -87,6 +88,7 @@ static const lc_opt_table_entry_t be_main_options[] = {
 	LC_OPT_ENT_ENUM_MASK("dump",       "dump irg on several occasions",                       &dump_var),
 	LC_OPT_ENT_BOOL     ("omitfp",     "omit frame pointer",                                  &be_options.omit_fp),
 	LC_OPT_ENT_BOOL     ("verify",     "verify the backend irg",                              &be_options.do_verify),
+	LC_OPT_ENT_INT      ("verifysample", "run the backend verifiers only on every n-th graph",   &be_options.verify_sample),
 	LC_OPT_ENT_BOOL     ("time",       "get backend timing statistics",                       &be_options.timing),
 	LC_OPT_ENT_BOOL     ("profilegenerate", "instrument the code for execution count profiling", &be_options.opt_profile_generate),
 	LC_OPT_ENT_BOOL     ("profileuse",      "use existing profile data",                         &be_options.opt_profile_use),
@@ -218,10 +220,15 @@ void be_check_verify_result(bool fine, ir_graph *irg)
 	}
 }
 
+bool be_verify_due(const ir_graph *irg)
+{
+	return be_birg_from_irg(irg)->verify;
+}
+
 /* Perform schedule verification if requested. */
 static void be_sched_verify(ir_graph *irg)
 {
-	if (be_options.do_verify) {
+	if (be_verify_due(irg)) {
 		be_timer_push(T_VERIFY);
 		bool fine = be_verify_schedule(irg);
 		be_check_verify_result(fine, irg);
@@ -231,7 +238,7 @@ static void be_sched_verify(ir_graph *irg)
 
 static void be_regalloc_verify(ir_graph *const irg)
 {
-	if (be_options.do_verify) {
+	if (be_verify_due(irg)) {
 		be_timer_push(T_VERIFY);
 		bool const fine = be_verify_register_allocation(irg);
 		be_check_verify_result(fine, irg);
@@ -272,10 +279,16 @@ static void initialize_birg(be_irg_t *birg, ir_graph *irg, be_main_env_t *env)
 	be_info_init_irg(irg);
 	birg->lv = be_liveness_new(irg);
 
+	/* sample whole graphs, so every verifier checks some of them */
+	static unsigned n_graphs;
+	birg->verify = be_options.do_verify
+	            && (be_options.verify_sample <= 1
+	                || n_graphs++ % (unsigned)be_options.verify_sample == 0);
+
 	/* Verify the initial graph */
 	if (be_options.do_verify) {
 		be_timer_push(T_VERIFY);
-		bool fine = irg_verify(irg);
+		bool fine = irg_verify_sampled(irg);
 		be_check_verify_result(fine, irg);
 		be_timer_pop(T_VERIFY);
 	}
@@ -393,7 +406,7 @@ void firm_be_finish(void)
 
 int be_timing;
 
-static const char *get_timer_name(be_timer_id_t id)
+const char *be_get_timer_name(be_timer_id_t id)
 {
 	switch (id) {
 	case T_ABI:            return "abi";
@@ -449,7 +462,9 @@ void be_after_irp_transform(const char *name)
 void be_lower_for_target(void)
 {
 	assert(ir_target.isa_initialized);
+	ir_trace_push("lower_for_target", NULL);
 	ir_target.isa->lower_for_target();
+	ir_trace_pop();
 	/* set the phase to low */
 	foreach_irp_irg_r(i, irg) {
 		assert(!irg_is_constrained(irg, IR_GRAPH_CONSTRAINT_TARGET_LOWERED));
@@ -465,6 +480,7 @@ bool be_step_first(ir_graph *irg)
 	if (get_entity_linkage(entity) & IR_LINKAGE_NO_CODEGEN)
 		return false;
 
+	ir_trace_push("backend", irg);
 	be_timer_push(T_OTHER);
 	if (stat_ev_enabled) {
 		stat_ev_ctx_push_fmt("bemain_irg", "%+F", irg);
@@ -522,20 +538,21 @@ void be_step_last(ir_graph *irg)
 	be_regalloc_verify(irg);
 
 	be_timer_pop(T_OTHER);
+	ir_trace_pop();
 
 	if (be_timing) {
 		if (stat_ev_enabled) {
 			for (be_timer_id_t t = T_FIRST; t < T_LAST+1; ++t) {
 				char buf[128];
 				snprintf(buf, sizeof(buf), "bemain_time_%s",
-				         get_timer_name(t));
+				         be_get_timer_name(t));
 				stat_ev_dbl(buf, ir_timer_elapsed_usec(be_timers[t]));
 			}
 		} else {
 			printf("==>> IRG %s <<==\n", get_entity_name(get_irg_entity(irg)));
 			for (be_timer_id_t t = T_FIRST; t < T_LAST+1; ++t) {
 				double val = ir_timer_elapsed_usec(be_timers[t]) / 1000.0;
-				printf("%-20s: %10.3f msec\n", get_timer_name(t), val);
+				printf("%-20s: %10.3f msec\n", be_get_timer_name(t), val);
 			}
 		}
 		for (be_timer_id_t t = T_FIRST; t < T_LAST+1; ++t) {
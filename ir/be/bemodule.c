@@ -48,6 +48,7 @@ void be_init_peephole(void);
 void be_init_pref_alloc(void);
 void be_init_ra(void);
 void be_init_sched(void);
+void be_init_sched_latency(void);
 void be_init_sched_normal(void);
 void be_init_sched_rand(void);
 void be_init_sched_trivial(void);
@@ -99,6 +100,7 @@ void be_init_modules(void)
 
 	be_init_listsched();
 	be_init_sched_normal();
+	be_init_sched_latency();
 	be_init_sched_rand();
 	be_init_sched_trivial();
 
@@ -0,0 +1,130 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2012 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       Sequentialization of parallel copies.
+ */
+#include "beparcopy.h"
+
+#include "raw_bitset.h"
+#include "xmalloc.h"
+#include <assert.h>
+
+static bool is_pending(unsigned const *const parcopy, unsigned const n_regs,
+                       unsigned const dst)
+{
+	unsigned const src = parcopy[dst];
+	return src != n_regs && src != dst;
+}
+
+bool be_parcopy_emit_chains(unsigned const n_regs, unsigned *const parcopy,
+                            unsigned *const freed,
+                            be_parcopy_copy_func const copy, void *const env)
+{
+	/* Count how often each register still has to be read. */
+	unsigned *const n_used = ALLOCANZ(unsigned, n_regs);
+	for (unsigned dst = 0; dst < n_regs; ++dst) {
+		if (is_pending(parcopy, n_regs, dst))
+			++n_used[parcopy[dst]];
+	}
+
+	/* Destinations whose old value is not needed can be written right away. */
+	unsigned *const ready   = ALLOCAN(unsigned, n_regs);
+	unsigned        n_ready = 0;
+	for (unsigned dst = n_regs; dst-- != 0;) {
+		if (is_pending(parcopy, n_regs, dst) && n_used[dst] == 0)
+			ready[n_ready++] = dst;
+	}
+
+	bool cycles = false;
+	while (n_ready != 0) {
+		unsigned const dst = ready[--n_ready];
+		unsigned const src = parcopy[dst];
+		assert(n_used[src] > 0);
+		--n_used[src];
+		/* A fixpoint keeps its value, so its register is still read. */
+		bool const last_read = n_used[src] == 0 && parcopy[src] != src;
+		copy(env, dst, src, last_read);
+		parcopy[dst] = dst;
+
+		if (last_read) {
+			/* This copy may have enabled the copy into src. */
+			if (is_pending(parcopy, n_regs, src)) {
+				ready[n_ready++] = src;
+			} else if (freed != NULL) {
+				rbitset_set(freed, src);
+			}
+		}
+	}
+
+	for (unsigned dst = 0; dst < n_regs; ++dst) {
+		if (is_pending(parcopy, n_regs, dst)) {
+			/* Only cycles may be left. */
+			assert(n_used[dst] == 1);
+			cycles = true;
+		}
+	}
+	return cycles;
+}
+
+void be_parcopy_emit_cycles(unsigned const n_regs, unsigned *const parcopy,
+                            unsigned const temp, unsigned const min_temp_len,
+                            be_parcopy_copy_func const copy,
+                            be_parcopy_swap_func const swap, void *const env)
+{
+	/* readers[src] is the destination reading src. */
+	unsigned *const readers = ALLOCAN(unsigned, n_regs);
+	for (unsigned dst = 0; dst < n_regs; ++dst) {
+		if (is_pending(parcopy, n_regs, dst))
+			readers[parcopy[dst]] = dst;
+	}
+
+	for (unsigned start = 0; start < n_regs; ++start) {
+		if (!is_pending(parcopy, n_regs, start))
+			continue;
+
+		unsigned len = 1;
+		for (unsigned r = parcopy[start]; r != start; r = parcopy[r])
+			++len;
+
+		if (temp != n_regs && len >= min_temp_len) {
+			assert(!is_pending(parcopy, n_regs, temp));
+			/* Save the value of start, then move the values along the cycle
+			 * and finally restore the saved value. */
+			copy(env, temp, start, true);
+			for (unsigned dst = start;;) {
+				unsigned const src = parcopy[dst];
+				parcopy[dst] = dst;
+				if (src == start) {
+					copy(env, dst, temp, true);
+					break;
+				}
+				copy(env, dst, src, true);
+				dst = src;
+			}
+			continue;
+		}
+
+		/* Decompose the cycle into transpositions. Each swap puts the value
+		 * of dst into place and moves the old value of dst into src. The next
+		 * swap continues with the register src has to read, which is not
+		 * touched by this swap. So consecutive swaps are independent where
+		 * possible and no value is threaded through all of them. */
+		for (unsigned dst = start; is_pending(parcopy, n_regs, dst);) {
+			unsigned const src = parcopy[dst];
+			swap(env, dst, src);
+			parcopy[dst] = dst;
+
+			/* src now contains the old value of dst. */
+			unsigned const reader = readers[dst];
+			parcopy[reader] = src;
+			readers[src]    = reader;
+			dst = parcopy[src];
+		}
+		/* The remaining part of the cycle is found by the outer loop, as all
+		 * its registers come after start. */
+	}
+}
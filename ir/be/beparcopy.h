@@ -0,0 +1,82 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2012 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       Sequentialization of parallel copies.
+ *
+ * A parallel copy of a register class with n_regs registers is represented
+ * by an array parcopy, where parcopy[dst] is the register whose value has to
+ * end up in register dst. parcopy[dst] == n_regs means that dst is not
+ * written, parcopy[dst] == dst that dst already contains its value. Every
+ * destination has at most one source, but a source may be copied into several
+ * destinations.
+ *
+ * The parallel copy is implemented with the minimal number of operations:
+ * Destinations whose old value is not needed anymore are written by copies.
+ * This leaves disjoint cycles, a cycle of n registers is implemented with
+ * n-1 swaps or, if a temporary register is available, with n+1 copies.
+ *
+ * The functions only decide on the operations, the caller creates the nodes
+ * in the order the callbacks are invoked.
+ */
+#ifndef FIRM_BE_BEPARCOPY_H
+#define FIRM_BE_BEPARCOPY_H
+
+#include <stdbool.h>
+
+/**
+ * Called to copy register @p src into register @p dst.
+ * @p last_read is true if the value in @p src is neither read by a following
+ * operation nor kept in @p src by the parallel copy.
+ */
+typedef void (*be_parcopy_copy_func)(void *env, unsigned dst, unsigned src,
+                                     bool last_read);
+
+/**
+ * Called to exchange the contents of the registers @p reg0 and @p reg1.
+ */
+typedef void (*be_parcopy_swap_func)(void *env, unsigned reg0, unsigned reg1);
+
+/**
+ * Emits copies for all destinations which are not part of a cycle.
+ *
+ * Afterwards every entry of @p parcopy is either n_regs, a fixpoint or part
+ * of a cycle.
+ *
+ * @param n_regs   number of registers
+ * @param parcopy  the parallel copy, resolved destinations become fixpoints
+ * @param freed    if not NULL, the registers which were read for the last
+ *                 time and are not written are added to this raw bitset,
+ *                 they may serve as temporary register for the cycles
+ * @param copy     callback creating a copy
+ * @param env      environment for the callback
+ * @return true if cycles remain
+ */
+bool be_parcopy_emit_chains(unsigned n_regs, unsigned *parcopy,
+                            unsigned *freed, be_parcopy_copy_func copy,
+                            void *env);
+
+/**
+ * Emits the cycles left by be_parcopy_emit_chains().
+ *
+ * Cycles with at least @p min_temp_len registers are implemented with copies
+ * through register @p temp, shorter cycles with swaps. The swaps of a cycle
+ * are chosen such that no value is threaded through all of them.
+ *
+ * @param n_regs        number of registers
+ * @param parcopy       the parallel copy, contains only cycles, fixpoints and
+ *                      unwritten registers
+ * @param temp          a register which may be clobbered, n_regs if none
+ * @param min_temp_len  minimal length of a cycle implemented with @p temp
+ * @param copy          callback creating a copy
+ * @param swap          callback creating a swap
+ * @param env           environment for the callbacks
+ */
+void be_parcopy_emit_cycles(unsigned n_regs, unsigned *parcopy, unsigned temp,
+                            unsigned min_temp_len, be_parcopy_copy_func copy,
+                            be_parcopy_swap_func swap, void *env);
+
+#endif
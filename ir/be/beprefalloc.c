@@ -18,9 +18,6 @@
  * 2. Walk blocks and assigns registers in a greedy fashion. Preferring
  *    registers with high preferences. When register constraints are not met,
  *    add copies and split live-ranges.
- *
- * TODO:
- *  - make use of free registers in the permute_values code
  */
 #include "be.h"
 #include "bechordal_t.h"
@@ -28,6 +25,7 @@
 #include "belive.h"
 #include "bemodule.h"
 #include "benode.h"
+#include "beparcopy.h"
 #include "bera.h"
 #include "besched.h"
 #include "bespill.h"
@@ -731,6 +729,77 @@ static void assign_reg(ir_node const *const block, ir_node *const node, arch_reg
 	DB((dbg, LEVEL_2, "Assign %+F -> %s\n", node, arch_get_irn_register(node)->name));
 }
 
+/** Environment for the parallel copy callbacks of permute_values(). */
+typedef struct permute_env_t {
+	ir_nodeset_t *live_nodes;
+	ir_node      *before;
+	ir_node      *block;
+} permute_env_t;
+
+static void permute_copy(void *const data, unsigned const dst,
+                         unsigned const src, bool const last_read)
+{
+	permute_env_t *const env  = (permute_env_t*)data;
+	ir_node       *const val  = assignments[src];
+	ir_node       *const copy = be_new_Copy(env->block, val);
+	sched_add_before(env->before, copy);
+	mark_as_copy_of(copy, val);
+	unsigned width = 1; /* TODO */
+	use_reg_idx(copy, dst, width);
+	DB((dbg, LEVEL_2, "Copy %+F (from %+F, before %+F) -> %s\n", copy, val, env->before, arch_get_irn_register(copy)->name));
+
+	if (env->live_nodes != NULL)
+		ir_nodeset_insert(env->live_nodes, copy);
+
+	/* the old register is free if nobody reads it anymore */
+	assert(arch_get_irn_register(val)->index == src);
+	if (last_read) {
+		if (env->live_nodes != NULL)
+			ir_nodeset_remove(env->live_nodes, val);
+		free_reg_of_value(val);
+	}
+}
+
+static void permute_swap(void *const data, unsigned const reg0,
+                         unsigned const reg1)
+{
+	permute_env_t *const env  = (permute_env_t*)data;
+	ir_node       *const in[] = { assignments[reg0], assignments[reg1] };
+	ir_node       *const perm = be_new_Perm(env->block, ARRAY_SIZE(in), in);
+	sched_add_before(env->before, perm);
+	DB((dbg, LEVEL_2, "Perm %+F (perm %+F,%+F, before %+F)\n",
+	    perm, in[0], in[1], env->before));
+
+	unsigned width = 1; /* TODO */
+
+	ir_node *const proj0 = be_new_Proj(perm, 0);
+	mark_as_copy_of(proj0, in[0]);
+	use_reg_idx(proj0, reg1, width);
+
+	ir_node *const proj1 = be_new_Proj(perm, 1);
+	mark_as_copy_of(proj1, in[1]);
+	use_reg_idx(proj1, reg0, width);
+
+	if (env->live_nodes != NULL) {
+		ir_nodeset_remove(env->live_nodes, in[0]);
+		ir_nodeset_remove(env->live_nodes, in[1]);
+		ir_nodeset_insert(env->live_nodes, proj0);
+	}
+}
+
+/**
+ * Returns a register which currently holds no value, or n_regs if there is
+ * none.
+ */
+static unsigned find_free_reg(void)
+{
+	for (unsigned r = 0; r < n_regs; ++r) {
+		if (rbitset_is_set(normal_regs, r) && assignments[r] == NULL)
+			return r;
+	}
+	return n_regs;
+}
+
 /**
  * Add an permutation in front of a node and change the assignments
  * due to this permutation.
@@ -750,14 +819,13 @@ static void assign_reg(ir_node const *const block, ir_node *const node, arch_reg
  * (it can have 0 which means we don't care what value is in it).
  * We ignore all fulfilled permuations (like 7->7)
  * In a first pass we create as much copy instructions as possible as they
- * are generally cheaper than exchanges. We do this by counting into how many
- * destinations a register has to be copied (in the example it's 2 for register
- * 3, or 1 for the registers 1,2,4 and 7).
- * We can then create a copy into every destination register when the usecount
- * of that register is 0 (= noone else needs the value in the register).
+ * are generally cheaper than exchanges. We can create a copy into every
+ * destination register when noone else needs the value in the register.
  *
- * After this step we should only have cycles left. We implement a cyclic
- * permutation of n registers with n-1 transpositions.
+ * After this step we should only have cycles left. A cyclic permutation of
+ * 2 registers is implemented with a single transposition. Longer cycles of
+ * n registers need n-1 transpositions, so they are implemented with n+1
+ * copies if a free register is available.
  *
  * @param live_nodes   the set of live nodes, updated due to live range split
  * @param before       the node before we add the permutation
@@ -768,127 +836,26 @@ static void assign_reg(ir_node const *const block, ir_node *const node, arch_reg
 static void permute_values(ir_nodeset_t *live_nodes, ir_node *before,
                            unsigned *permutation)
 {
-	unsigned *n_used = ALLOCANZ(unsigned, n_regs);
-
-	/* determine how often each source register needs to be read */
 	for (unsigned r = 0; r < n_regs; ++r) {
-		unsigned  old_reg = permutation[r];
-		ir_node  *value;
-
-		value = assignments[old_reg];
-		if (value == NULL) {
-			/* nothing to do here, reg is not live. Mark it as fixpoint
-			 * so we ignore it in the next steps */
-			permutation[r] = r;
-			continue;
+		if (assignments[permutation[r]] == NULL) {
+			/* nothing to do here, reg is not live. Mark it as not written
+			 * so we ignore it in the next steps and its current value does
+			 * not count as read */
+			permutation[r] = n_regs;
 		}
-
-		++n_used[old_reg];
 	}
 
-	ir_node *block = get_nodes_block(before);
-
-	/* step1: create copies where immediately possible */
-	for (unsigned r = 0; r < n_regs; /* empty */) {
-		unsigned old_r = permutation[r];
-
-		/* - no need to do anything for fixed points.
-		   - we can't copy if the value in the dest reg is still needed */
-		if (old_r == r || n_used[r] > 0) {
-			++r;
-			continue;
-		}
-
-		/* create a copy */
-		ir_node *src  = assignments[old_r];
-		ir_node *copy = be_new_Copy(block, src);
-		sched_add_before(before, copy);
-		mark_as_copy_of(copy, src);
-		unsigned width = 1; /* TODO */
-		use_reg_idx(copy, r, width);
-		DB((dbg, LEVEL_2, "Copy %+F (from %+F, before %+F) -> %s\n", copy, src, before, arch_get_irn_register(copy)->name));
-
-		if (live_nodes != NULL) {
-			ir_nodeset_insert(live_nodes, copy);
-		}
-
-		/* old register has 1 user less, permutation is resolved */
-		assert(arch_get_irn_register(src)->index == old_r);
-		permutation[r] = r;
-
-		assert(n_used[old_r] > 0);
-		--n_used[old_r];
-		if (n_used[old_r] == 0) {
-			if (live_nodes != NULL) {
-				ir_nodeset_remove(live_nodes, src);
-			}
-			free_reg_of_value(src);
-		}
-
-		/* advance or jump back (if this copy enabled another copy) */
-		if (old_r < r && n_used[old_r] == 0) {
-			r = old_r;
-		} else {
-			++r;
-		}
-	}
-
-	/* at this point we only have "cycles" left which we have to resolve with
-	 * perm instructions
-	 * TODO: if we have free registers left, then we should really use copy
-	 * instructions for any cycle longer than 2 registers...
-	 * (this is probably architecture dependent, there might be archs where
-	 *  copies are preferable even for 2-cycles) */
-
-	/* create perms with the rest */
-	for (unsigned r = 0; r < n_regs; /* empty */) {
-		unsigned old_r = permutation[r];
-
-		if (old_r == r) {
-			++r;
-			continue;
-		}
-
-		/* we shouldn't have copies from 1 value to multiple destinations left*/
-		assert(n_used[old_r] == 1);
-
-		/* exchange old_r and r2; after that old_r is a fixed point */
-		unsigned r2 = permutation[old_r];
-
-		ir_node *const in[] = { assignments[r2], assignments[old_r] };
-		ir_node *const perm = be_new_Perm(block, ARRAY_SIZE(in), in);
-		sched_add_before(before, perm);
-		DB((dbg, LEVEL_2, "Perm %+F (perm %+F,%+F, before %+F)\n",
-		    perm, in[0], in[1], before));
-
-		unsigned width = 1; /* TODO */
-
-		ir_node *const proj0 = be_new_Proj(perm, 0);
-		mark_as_copy_of(proj0, in[0]);
-		use_reg_idx(proj0, old_r, width);
-
-		ir_node *const proj1 = be_new_Proj(perm, 1);
-		mark_as_copy_of(proj1, in[1]);
-		use_reg_idx(proj1, r2, width);
-
-		/* 1 value is now in the correct register */
-		permutation[old_r] = old_r;
-		/* the source of r changed to r2 */
-		permutation[r] = r2;
-
-		/* if we have reached a fixpoint update data structures */
-		if (live_nodes != NULL) {
-			ir_nodeset_remove(live_nodes, in[0]);
-			ir_nodeset_remove(live_nodes, in[1]);
-			ir_nodeset_remove(live_nodes, proj0);
-			ir_nodeset_insert(live_nodes, proj1);
-		}
+	permute_env_t env = { live_nodes, before, get_nodes_block(before) };
+	if (be_parcopy_emit_chains(n_regs, permutation, NULL, permute_copy, &env)) {
+		unsigned const temp = find_free_reg();
+		be_parcopy_emit_cycles(n_regs, permutation, temp, 3, permute_copy,
+		                       permute_swap, &env);
 	}
 
 #ifndef NDEBUG
 	/* now we should only have fixpoints left */
 	for (unsigned r = 0; r < n_regs; ++r) {
-		assert(permutation[r] == r);
+		assert(permutation[r] == r || permutation[r] == n_regs);
 	}
 #endif
 }
@@ -1805,7 +1772,7 @@ static void be_pref_alloc(ir_graph *new_irg, const regalloc_if_t *regif)
 		spill(regif);
 
 		/* verify schedule and register pressure */
-		if (be_options.do_verify) {
+		if (be_verify_due(irg)) {
 			be_timer_push(T_VERIFY);
 			bool check_schedule = be_verify_schedule(irg);
 			be_check_verify_result(check_schedule, irg);
@@ -12,6 +12,8 @@
 #ifndef FIRM_BE_BERA_H
 #define FIRM_BE_BERA_H
 
+#include <stdbool.h>
+
 #include "firm_types.h"
 #include "be_types.h"
 
@@ -45,8 +47,10 @@ struct regalloc_if_t {
 	/**
 	 * Ask the backend to fold a reload at operand @p i of @p irn. This can
 	 * be done by targets that support memory addressing modes.
+	 * Returns true if the reload was folded, the inputs of @p irn may have
+	 * changed in this case.
 	 */
-	void (*perform_memory_operand)(ir_node *irn, unsigned i);
+	bool (*perform_memory_operand)(ir_node *irn, unsigned i);
 };
 
 /**
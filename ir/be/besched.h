@@ -246,6 +246,13 @@ void be_register_scheduler(const char *name, schedule_func func);
  */
 void be_schedule_graph(ir_graph *irg);
 
+/**
+ * Reorders the instructions of @p irg after register allocation to hide
+ * latencies according to the machine model of the target. Nodes which modify
+ * flags clobber all registers of @p flags_cls.
+ */
+void be_schedule_post_ra(ir_graph *irg, arch_register_class_t const *flags_cls);
+
 /**
  * Return the last schedule_first node following node, if there is any, node
  * otherwise.
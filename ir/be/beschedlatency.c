@@ -0,0 +1,872 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2012 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Latency and resource aware list scheduling.
+ *
+ * Both schedulers simulate the issue of the instructions on a machine, which
+ * issues isa->issue_width instructions per cycle and executes them on the
+ * ports described by isa->get_machine_op(). From the instructions which can
+ * be issued earliest they pick the one with the longest latency weighted path
+ * to the end of the block.
+ *
+ * The "latency" scheduler selects before register allocation. The "pressure"
+ * scheduler additionally tracks the number of occupied registers per class.
+ * When less than PRESSURE_SLACK registers of a class are free, it prefers the
+ * instructions, which free the most registers of the critical classes, to
+ * avoid spills. Afterwards be_schedule_post_ra() reorders the instructions
+ * again, as the register allocator inserts copies, spills and reloads into the
+ * schedule.
+ */
+#include "be_t.h"
+#include "bearch.h"
+#include "beirg.h"
+#include "belistsched.h"
+#include "belive.h"
+#include "bemodule.h"
+#include "benode.h"
+#include "besched.h"
+#include "debug.h"
+#include "execfreq.h"
+#include "iredges_t.h"
+#include "irgwalk.h"
+#include "irnode_t.h"
+#include "obst.h"
+#include "statev_t.h"
+#include "target_t.h"
+#include "util.h"
+#include "xmalloc.h"
+#include <limits.h>
+#include <string.h>
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
+
+#define MAX_PORTS (sizeof(unsigned) * CHAR_BIT)
+
+/** The simulated state of the machine. */
+typedef struct machine_t {
+	unsigned issue_width;          /**< instructions issued per cycle */
+	unsigned cycle;                /**< the current issue cycle */
+	unsigned n_issued;             /**< instructions issued in this cycle */
+	unsigned port_free[MAX_PORTS]; /**< first cycle in which a port is free */
+} machine_t;
+
+static void get_machine_op(ir_node const *const node, be_machine_op_t *const op)
+{
+	arch_isa_if_t const *const isa = ir_target.isa;
+	if (isa->get_machine_op != NULL) {
+		isa->get_machine_op(node, op);
+	} else {
+		op->latency = isa->get_op_estimated_cost(node);
+		op->ports   = 0;
+		op->busy    = 1;
+	}
+}
+
+static void machine_init(machine_t *const machine)
+{
+	memset(machine, 0, sizeof(*machine));
+	unsigned const issue_width = ir_target.isa->issue_width;
+	machine->issue_width = issue_width != 0 ? issue_width : 1;
+}
+
+/** Returns the port out of @p ports which is free first. */
+static unsigned get_free_port(machine_t const *const machine,
+                              unsigned const ports)
+{
+	assert(ports != 0);
+	unsigned best = MAX_PORTS;
+	for (unsigned p = 0; p < MAX_PORTS; ++p) {
+		if ((ports & (1u << p)) == 0)
+			continue;
+		if (best == MAX_PORTS || machine->port_free[p] < machine->port_free[best])
+			best = p;
+	}
+	return best;
+}
+
+/**
+ * Returns the first cycle, in which @p op can be issued, if its operands are
+ * available in cycle @p earliest.
+ */
+static unsigned get_issue_cycle(machine_t const *const machine,
+                                be_machine_op_t const *const op,
+                                unsigned const earliest)
+{
+	unsigned cycle = MAX(machine->cycle, earliest);
+	if (op->ports != 0) {
+		unsigned const port = get_free_port(machine, op->ports);
+		cycle = MAX(cycle, machine->port_free[port]);
+	}
+	return cycle;
+}
+
+/** Issues @p op in @p cycle. */
+static void issue(machine_t *const machine, be_machine_op_t const *const op,
+                  unsigned const cycle)
+{
+	/* pseudo instructions, which are not emitted, need no issue slot */
+	if (op->latency == 0 && op->ports == 0)
+		return;
+
+	assert(cycle >= machine->cycle);
+	if (cycle > machine->cycle) {
+		machine->cycle    = cycle;
+		machine->n_issued = 0;
+	}
+	if (op->ports != 0) {
+		unsigned const port = get_free_port(machine, op->ports);
+		machine->port_free[port] = cycle + op->busy;
+	}
+	if (++machine->n_issued == machine->issue_width) {
+		++machine->cycle;
+		machine->n_issued = 0;
+	}
+}
+
+/**
+ * Returns whether the candidate with issue cycle @p cycle and priority
+ * @p priority is better than the best one so far.
+ */
+static bool is_better(unsigned const cycle, unsigned const priority,
+                      unsigned const best_cycle, unsigned const best_priority)
+{
+	if (cycle != best_cycle)
+		return cycle < best_cycle;
+	return priority > best_priority;
+}
+
+/* Scheduling before register allocation. */
+
+/**
+ * A register class counts as critical, if less than this number of its
+ * registers is free.
+ */
+#define PRESSURE_SLACK 2
+
+typedef struct node_info_t {
+	be_machine_op_t op;
+	unsigned        priority;  /**< latency weighted path length to the
+	                                end of the block */
+	unsigned        ready;     /**< cycle in which the results are
+	                                available */
+	unsigned        remaining; /**< number of unscheduled users in the
+	                                block */
+	bool            visited;
+	bool            tracked;   /**< the value occupies registers */
+	bool            live_end;  /**< the value is live at the block end */
+} node_info_t;
+
+static node_info_t *node_infos;
+static machine_t    machine;
+static double       sched_cycles;
+
+/* state of the register pressure aware scheduler */
+static bool        track_pressure;
+static be_lv_t    *lv;
+static unsigned   *pressure;     /**< occupied registers per class */
+static unsigned   *n_regs;       /**< allocatable registers per class */
+static double      n_pressure_selects;
+
+static node_info_t *get_node_info(ir_node const *const node)
+{
+	return &node_infos[get_irn_idx(node)];
+}
+
+static unsigned compute_priority(ir_node *const node)
+{
+	node_info_t *const info = get_node_info(node);
+	if (info->visited)
+		return info->priority;
+	info->visited = true;
+
+	ir_node *const block    = get_nodes_block(node);
+	unsigned       priority = 0;
+	foreach_out_edge(node, edge) {
+		ir_node *const user = get_edge_src_irn(edge);
+		if (is_Block(user) || is_Phi(user) || get_nodes_block(user) != block)
+			continue;
+		priority = MAX(priority, compute_priority(user));
+	}
+
+	if (!arch_is_irn_not_scheduled(node)) {
+		get_machine_op(node, &info->op);
+		priority += info->op.latency;
+	}
+	info->priority = priority;
+	return priority;
+}
+
+/** Returns the cycle in which all operands of @p node are available. */
+static unsigned get_operands_ready(ir_node const *const node)
+{
+	ir_node const *const block = get_nodes_block(node);
+	unsigned             ready = 0;
+	foreach_irn_in(node, i, op) {
+		ir_node const *const value = is_Proj(op) ? get_Proj_pred(op) : op;
+		if (is_Block(value) || get_nodes_block(value) != block)
+			continue;
+		ready = MAX(ready, get_node_info(value)->ready);
+	}
+	return ready;
+}
+
+/**
+ * Returns the requirement of @p value, if the register allocator has to
+ * assign registers to it, NULL otherwise.
+ */
+static arch_register_req_t const *get_value_req(ir_node const *const value)
+{
+	if (get_irn_mode(value) == mode_T)
+		return NULL;
+	arch_register_req_t const *const req = arch_get_irn_register_req(value);
+	if (req->cls == NULL || req->cls->manual_ra || req->ignore)
+		return NULL;
+	return req;
+}
+
+/** Initializes the register pressure information of @p value in @p block. */
+static void init_value(ir_node const *const block, ir_node *const value)
+{
+	node_info_t *const info = get_node_info(value);
+	info->tracked = get_value_req(value) != NULL;
+	if (!info->tracked)
+		return;
+
+	unsigned remaining = 0;
+	foreach_out_edge(value, edge) {
+		ir_node *const user = get_edge_src_irn(edge);
+		if (is_Block(user) || is_Phi(user) || get_nodes_block(user) != block
+		    || arch_is_irn_not_scheduled(user))
+			continue;
+		++remaining;
+	}
+	info->remaining = remaining;
+	info->live_end  = be_is_live_end(lv, block, value);
+}
+
+/** Returns whether less than PRESSURE_SLACK registers of class @p c are free. */
+static bool is_class_critical(unsigned const c)
+{
+	return pressure[c] != 0 && pressure[c] + PRESSURE_SLACK > n_regs[c];
+}
+
+static bool is_pressure_critical(void)
+{
+	for (unsigned c = 0, n = ir_target.isa->n_register_classes; c < n; ++c) {
+		if (is_class_critical(c))
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Calls @p func for each value defined by @p node, which occupies a register
+ * afterwards.
+ */
+static void foreach_live_def(ir_node *const node,
+                             void (*func)(ir_node const *value, void *data),
+                             void *const data)
+{
+	if (get_irn_mode(node) == mode_T) {
+		foreach_out_edge(node, edge) {
+			ir_node *const proj = get_edge_src_irn(edge);
+			if (is_Proj(proj))
+				foreach_live_def(proj, func, data);
+		}
+		return;
+	}
+	node_info_t const *const info = get_node_info(node);
+	if (info->tracked && (info->remaining > 0 || info->live_end))
+		func(node, data);
+}
+
+/**
+ * Calls @p func for each operand of @p node, whose last use in the block is
+ * @p node.
+ */
+static void foreach_last_use(ir_node *const node,
+                             void (*func)(ir_node const *value, void *data),
+                             void *const data)
+{
+	foreach_irn_in(node, i, op) {
+		node_info_t const *const info = get_node_info(op);
+		if (!info->tracked || info->live_end)
+			continue;
+		/* count each operand once */
+		unsigned uses = 0;
+		bool     seen = false;
+		foreach_irn_in(node, k, other) {
+			if (other != op)
+				continue;
+			if (k < i) {
+				seen = true;
+				break;
+			}
+			++uses;
+		}
+		if (!seen && info->remaining == uses)
+			func(op, data);
+	}
+}
+
+static void add_def_pressure(ir_node const *const value, void *const data)
+{
+	arch_register_req_t const *const req = get_value_req(value);
+	if (is_class_critical(req->cls->index))
+		*(int*)data += req->width;
+}
+
+static void sub_use_pressure(ir_node const *const value, void *const data)
+{
+	arch_register_req_t const *const req = get_value_req(value);
+	if (is_class_critical(req->cls->index))
+		*(int*)data -= req->width;
+}
+
+/** Returns the change of pressure in the critical classes by @p node. */
+static int get_pressure_delta(ir_node *const node)
+{
+	int delta = 0;
+	foreach_live_def(node, add_def_pressure, &delta);
+	foreach_last_use(node, sub_use_pressure, &delta);
+	return delta;
+}
+
+/**
+ * Returns the number of registers of the critical classes, which @p node
+ * overwrites without producing a live value, e.g. the clobbers of a call.
+ */
+static unsigned get_critical_clobbers(ir_node *const node)
+{
+	if (get_irn_mode(node) != mode_T)
+		return 0;
+	int clobbers = 0;
+	be_foreach_out(node, o) {
+		arch_register_req_t const *const req = arch_get_irn_register_req_out(node, o);
+		if (req->cls != NULL && !req->cls->manual_ra && !req->ignore
+		    && is_class_critical(req->cls->index))
+			clobbers += req->width;
+	}
+	int live = 0;
+	foreach_live_def(node, add_def_pressure, &live);
+	assert(clobbers >= live);
+	return clobbers - live;
+}
+
+static void def_value(ir_node const *const value, void *const data)
+{
+	(void)data;
+	arch_register_req_t const *const req = get_value_req(value);
+	pressure[req->cls->index] += req->width;
+}
+
+static void kill_value(ir_node const *const value, void *const data)
+{
+	(void)data;
+	arch_register_req_t const *const req = get_value_req(value);
+	assert(pressure[req->cls->index] >= req->width);
+	pressure[req->cls->index] -= req->width;
+}
+
+static void update_pressure(ir_node *const node)
+{
+	/* the operands of Phis are used in the predecessor blocks */
+	if (!is_Phi(node)) {
+		foreach_last_use(node, kill_value, NULL);
+		foreach_irn_in(node, i, op) {
+			node_info_t *const info = get_node_info(op);
+			if (info->tracked) {
+				assert(info->remaining > 0);
+				--info->remaining;
+			}
+		}
+	}
+	foreach_live_def(node, def_value, NULL);
+}
+
+/**
+ * Updates the register pressure for the nodes scheduled after @p last.
+ * Besides the selected node the list scheduler immediately schedules the
+ * schedule_first nodes, which become ready.
+ * @returns the last scheduled node
+ */
+static ir_node *update_pressure_after(ir_node *last)
+{
+	for (ir_node *node; !sched_is_end(node = sched_next(last)); last = node)
+		update_pressure(node);
+	return last;
+}
+
+static void pressure_begin_block(ir_node *const block)
+{
+	memset(pressure, 0, ir_target.isa->n_register_classes * sizeof(*pressure));
+	be_lv_foreach(lv, block, be_lv_state_in, value) {
+		arch_register_req_t const *const req = get_value_req(value);
+		if (req == NULL)
+			continue;
+		init_value(block, value);
+		pressure[req->cls->index] += req->width;
+	}
+	foreach_out_edge(block, edge) {
+		ir_node *const node = get_edge_src_irn(edge);
+		if (!is_Block(node))
+			init_value(block, node);
+	}
+}
+
+static ir_node *latency_select(ir_nodeset_t *const ready_set)
+{
+	/* if registers get scarce, prefer instructions which free registers */
+	bool const pressure_first = track_pressure && is_pressure_critical();
+
+	ir_node *best          = NULL;
+	unsigned best_cycle    = 0;
+	unsigned best_priority = 0;
+	bool     best_clobbers = false;
+	int      best_delta    = 0;
+	foreach_ir_nodeset(ready_set, node, iter) {
+		node_info_t const *const info     = get_node_info(node);
+		unsigned           const earliest = get_operands_ready(node);
+		unsigned           const cycle    = get_issue_cycle(&machine, &info->op, earliest);
+		/* Schedule instructions clobbering registers as early as possible,
+		 * values defined before them had to survive the clobber. */
+		bool               const clobbers = pressure_first && get_critical_clobbers(node) != 0;
+		int                const delta    = pressure_first ? get_pressure_delta(node) : 0;
+		if (best == NULL || clobbers > best_clobbers
+		    || (clobbers == best_clobbers
+		        && (delta < best_delta
+		            || (delta == best_delta
+		                && (is_better(cycle, info->priority, best_cycle, best_priority)
+		                    || (cycle == best_cycle && info->priority == best_priority
+		                        && get_irn_idx(node) < get_irn_idx(best))))))) {
+			best          = node;
+			best_cycle    = cycle;
+			best_priority = info->priority;
+			best_clobbers = clobbers;
+			best_delta    = delta;
+		}
+	}
+
+	node_info_t *const info = get_node_info(best);
+	issue(&machine, &info->op, best_cycle);
+	info->ready = best_cycle + info->op.latency;
+	n_pressure_selects += pressure_first;
+	DB((dbg, LEVEL_2, "\tcycle %u: %+F (priority %u%s)\n", best_cycle, best,
+	    info->priority, pressure_first ? ", pressure first" : ""));
+	return best;
+}
+
+static void latency_sched_block(ir_node *const block, void *const data)
+{
+	(void)data;
+	foreach_out_edge(block, edge) {
+		ir_node *const node = get_edge_src_irn(edge);
+		if (!is_Block(node))
+			compute_priority(node);
+	}
+	if (track_pressure)
+		pressure_begin_block(block);
+
+	machine_init(&machine);
+	ir_nodeset_t *const cands = be_list_sched_begin_block(block);
+	ir_node            *last  = block;
+	while (ir_nodeset_size(cands) > 0) {
+		if (track_pressure)
+			last = update_pressure_after(last);
+		ir_node *const node = latency_select(cands);
+		be_list_sched_schedule(node);
+	}
+	be_list_sched_end_block();
+
+	unsigned const cycles = machine.cycle + (machine.n_issued != 0);
+	DB((dbg, LEVEL_1, "%+F: %u cycles\n", block, cycles));
+	sched_cycles += cycles * get_block_execfreq(block);
+}
+
+static void sched_latency(ir_graph *const irg)
+{
+	be_list_sched_begin(irg);
+	node_infos   = XMALLOCNZ(node_info_t, get_irg_last_idx(irg));
+	sched_cycles = 0;
+	irg_block_walk_graph(irg, latency_sched_block, NULL, NULL);
+	stat_ev_dbl("sched_latency_cycles", sched_cycles);
+	free(node_infos);
+	be_list_sched_finish();
+}
+
+static void sched_pressure(ir_graph *const irg)
+{
+	be_list_sched_begin(irg);
+	be_assure_live_sets(irg);
+	lv = be_get_irg_liveness(irg);
+
+	unsigned                     const n_classes = ir_target.isa->n_register_classes;
+	arch_register_class_t const *const classes   = ir_target.isa->register_classes;
+	pressure = XMALLOCN(unsigned, n_classes);
+	n_regs   = XMALLOCN(unsigned, n_classes);
+	for (unsigned c = 0; c < n_classes; ++c) {
+		arch_register_class_t const *const cls = &classes[c];
+		n_regs[c] = cls->manual_ra ? 0 : be_get_n_allocatable_regs(irg, cls);
+	}
+
+	node_infos         = XMALLOCNZ(node_info_t, get_irg_last_idx(irg));
+	sched_cycles       = 0;
+	n_pressure_selects = 0;
+	track_pressure     = true;
+	irg_block_walk_graph(irg, latency_sched_block, NULL, NULL);
+	track_pressure     = false;
+	stat_ev_dbl("sched_latency_cycles", sched_cycles);
+	stat_ev_dbl("sched_pressure_first_selects", n_pressure_selects);
+
+	free(node_infos);
+	free(n_regs);
+	free(pressure);
+	be_list_sched_finish();
+}
+
+/* Scheduling after register allocation. */
+
+/** A dependency between two instructions of a region. */
+typedef struct dep_t dep_t;
+struct dep_t {
+	dep_t   *next;
+	unsigned succ;    /**< position of the dependent instruction */
+	unsigned latency; /**< minimal distance in cycles */
+};
+
+/** An instruction of the region being scheduled. */
+typedef struct region_node_t {
+	ir_node        *node;
+	dep_t          *succs;
+	be_machine_op_t op;
+	unsigned        n_preds;  /**< number of unscheduled predecessors */
+	unsigned        priority; /**< latency weighted path length to the
+	                               end of the region */
+	unsigned        earliest; /**< cycle in which the operands are ready */
+} region_node_t;
+
+typedef struct post_ra_env_t {
+	struct obstack               obst;
+	arch_register_class_t const *flags_cls;
+	unsigned                    *positions; /**< position + 1 of a node in
+	                                             the current region */
+	region_node_t               *nodes;     /**< ARR_F of the region */
+	unsigned                    *last_def;  /**< position + 1 of the last
+	                                             definition of a register */
+	unsigned                   **readers;   /**< ARR_F of the readers of a
+	                                             register since then */
+	unsigned                     last_mem;  /**< position + 1 of the last
+	                                             memory operation */
+	double                       cycles_before;
+	double                       cycles_after;
+} post_ra_env_t;
+
+static void add_dep(post_ra_env_t *const env, unsigned const pred,
+                    unsigned const succ, unsigned const latency)
+{
+	assert(pred < succ);
+	dep_t *const dep = OALLOC(&env->obst, dep_t);
+	dep->succ    = succ;
+	dep->latency = latency;
+	dep->next    = env->nodes[pred].succs;
+	env->nodes[pred].succs = dep;
+	++env->nodes[succ].n_preds;
+}
+
+static void use_reg(post_ra_env_t *const env, unsigned const pos,
+                    unsigned const r)
+{
+	unsigned const def = env->last_def[r];
+	if (def != 0)
+		add_dep(env, def - 1, pos, env->nodes[def - 1].op.latency);
+	ARR_APP1(unsigned, env->readers[r], pos);
+}
+
+static void def_reg(post_ra_env_t *const env, unsigned const pos,
+                    unsigned const r)
+{
+	unsigned const def = env->last_def[r];
+	if (def != 0 && def - 1 != pos)
+		add_dep(env, def - 1, pos, 0);
+	for (size_t i = 0, n = ARR_LEN(env->readers[r]); i < n; ++i) {
+		unsigned const reader = env->readers[r][i];
+		if (reader != pos)
+			add_dep(env, reader, pos, 0);
+	}
+	ARR_SHRINKLEN(env->readers[r], 0);
+	env->last_def[r] = pos + 1;
+}
+
+typedef void (*reg_func)(post_ra_env_t *env, unsigned pos, unsigned r);
+
+/**
+ * Calls @p func for the registers of an operand with requirement @p req and
+ * register @p reg.
+ */
+static void foreach_reg(post_ra_env_t *const env, unsigned const pos,
+                        arch_register_req_t const *const req,
+                        arch_register_t const *const reg, reg_func const func)
+{
+	if (reg != NULL) {
+		for (unsigned r = reg->global_index; r < reg->global_index + req->width; ++r)
+			func(env, pos, r);
+		return;
+	}
+
+	arch_register_class_t const *const cls = req->cls;
+	if (cls == env->flags_cls) {
+		/* flags are not allocated */
+		for (unsigned i = 0; i < cls->n_regs; ++i)
+			func(env, pos, cls->regs[i].global_index);
+	} else if (req->limited != NULL) {
+		/* clobbers without users */
+		rbitset_foreach(req->limited, cls->n_regs, i) {
+			func(env, pos, cls->regs[i].global_index);
+		}
+	}
+}
+
+static bool uses_memory(ir_node const *const node)
+{
+	ir_op const *const op = get_irn_op(node);
+	if (get_op_pinned(op) == op_pin_state_pinned
+	    || (get_op_flags(op) & irop_flag_uses_memory))
+		return true;
+	foreach_irn_in(node, i, pred) {
+		if (get_irn_mode(pred) == mode_M)
+			return true;
+	}
+	return false;
+}
+
+/** Adds the dependencies of the node at position @p pos. */
+static void add_deps(post_ra_env_t *const env, unsigned const pos)
+{
+	ir_node *const node = env->nodes[pos].node;
+
+	/* values */
+	foreach_irn_in(node, i, op) {
+		ir_node const *const value  = is_Proj(op) ? get_Proj_pred(op) : op;
+		unsigned       const op_pos = env->positions[get_irn_idx(value)];
+		if (op_pos != 0)
+			add_dep(env, op_pos - 1, pos, env->nodes[op_pos - 1].op.latency);
+	}
+
+	/* registers, which need not be in SSA form anymore */
+	for (int i = 0, n = get_irn_arity(node); i < n; ++i) {
+		arch_register_req_t const *const req = arch_get_irn_register_req_in(node, i);
+		arch_register_t     const *const reg = arch_get_irn_register_in(node, i);
+		foreach_reg(env, pos, req, reg, use_reg);
+	}
+	be_foreach_out(node, o) {
+		arch_register_req_t const *const req = arch_get_irn_register_req_out(node, o);
+		arch_register_t     const *const reg = arch_get_irn_register_out(node, o);
+		foreach_reg(env, pos, req, reg, def_reg);
+	}
+	if (env->flags_cls != NULL && arch_irn_is(node, modify_flags))
+		foreach_reg(env, pos, env->flags_cls->class_req, NULL, def_reg);
+
+	/* memory operations are kept in order, as spill slots are shared */
+	if (uses_memory(node)) {
+		if (env->last_mem != 0)
+			add_dep(env, env->last_mem - 1, pos, 0);
+		env->last_mem = pos + 1;
+	}
+}
+
+/**
+ * Simulates the instructions of the region in the order given by @p order.
+ * Returns the number of cycles.
+ */
+static unsigned simulate(post_ra_env_t *const env, unsigned const *const order)
+{
+	region_node_t *const nodes   = env->nodes;
+	size_t         const n_nodes = ARR_LEN(nodes);
+	for (size_t i = 0; i < n_nodes; ++i)
+		nodes[i].earliest = 0;
+
+	machine_t machine;
+	machine_init(&machine);
+	for (size_t i = 0; i < n_nodes; ++i) {
+		region_node_t *const rnode = &nodes[order[i]];
+		unsigned const cycle = get_issue_cycle(&machine, &rnode->op, rnode->earliest);
+		issue(&machine, &rnode->op, cycle);
+		for (dep_t const *dep = rnode->succs; dep != NULL; dep = dep->next) {
+			region_node_t *const succ = &nodes[dep->succ];
+			succ->earliest = MAX(succ->earliest, cycle + dep->latency);
+		}
+	}
+	return machine.cycle + (machine.n_issued != 0);
+}
+
+/** Computes a new order of the region by list scheduling. */
+static void list_schedule(post_ra_env_t *const env, unsigned *const order)
+{
+	region_node_t *const nodes   = env->nodes;
+	size_t         const n_nodes = ARR_LEN(nodes);
+
+	unsigned *ready   = NEW_ARR_F(unsigned, 0);
+	for (size_t i = n_nodes; i-- > 0;) {
+		region_node_t *const rnode = &nodes[i];
+		unsigned priority = rnode->op.latency;
+		for (dep_t const *dep = rnode->succs; dep != NULL; dep = dep->next)
+			priority = MAX(priority, dep->latency + nodes[dep->succ].priority);
+		rnode->priority = priority;
+		rnode->earliest = 0;
+	}
+	for (size_t i = 0; i < n_nodes; ++i) {
+		if (nodes[i].n_preds == 0)
+			ARR_APP1(unsigned, ready, (unsigned)i);
+	}
+
+	machine_t machine;
+	machine_init(&machine);
+	for (size_t n = 0; n < n_nodes; ++n) {
+		size_t   best          = 0;
+		unsigned best_cycle    = 0;
+		unsigned best_priority = 0;
+		for (size_t i = 0, n_ready = ARR_LEN(ready); i < n_ready; ++i) {
+			region_node_t const *const rnode = &nodes[ready[i]];
+			unsigned const cycle = get_issue_cycle(&machine, &rnode->op, rnode->earliest);
+			/* the original order decides ties */
+			if (i == 0
+			    || is_better(cycle, rnode->priority, best_cycle, best_priority)
+			    || (cycle == best_cycle && rnode->priority == best_priority
+			        && ready[i] < ready[best])) {
+				best          = i;
+				best_cycle    = cycle;
+				best_priority = rnode->priority;
+			}
+		}
+
+		unsigned const pos = ready[best];
+		ready[best] = ready[ARR_LEN(ready) - 1];
+		ARR_SHRINKLEN(ready, ARR_LEN(ready) - 1);
+		order[n] = pos;
+
+		region_node_t *const rnode = &nodes[pos];
+		issue(&machine, &rnode->op, best_cycle);
+		for (dep_t const *dep = rnode->succs; dep != NULL; dep = dep->next) {
+			region_node_t *const succ = &nodes[dep->succ];
+			succ->earliest = MAX(succ->earliest, best_cycle + dep->latency);
+			if (--succ->n_preds == 0)
+				ARR_APP1(unsigned, ready, dep->succ);
+		}
+	}
+	assert(ARR_LEN(ready) == 0);
+	DEL_ARR_F(ready);
+}
+
+/**
+ * Reschedules the region collected in env->nodes in front of @p before and
+ * resets the region.
+ */
+static void schedule_region(post_ra_env_t *const env, ir_node *const before,
+                            double const freq)
+{
+	region_node_t *const nodes   = env->nodes;
+	size_t         const n_nodes = ARR_LEN(nodes);
+	if (n_nodes > 1) {
+		for (size_t i = 0; i < n_nodes; ++i)
+			add_deps(env, i);
+
+		unsigned *const order = XMALLOCN(unsigned, n_nodes);
+		for (size_t i = 0; i < n_nodes; ++i)
+			order[i] = i;
+		unsigned const cycles_before = simulate(env, order);
+
+		list_schedule(env, order);
+		unsigned const cycles_after = simulate(env, order);
+		DB((dbg, LEVEL_1, "region before %+F: %u -> %u cycles\n", before,
+		    cycles_before, cycles_after));
+
+		/* only keep the new order, if it is faster */
+		if (cycles_after < cycles_before) {
+			for (size_t i = 0; i < n_nodes; ++i)
+				sched_remove(nodes[i].node);
+			for (size_t i = 0; i < n_nodes; ++i)
+				sched_add_before(before, nodes[order[i]].node);
+			env->cycles_after += cycles_after * freq;
+		} else {
+			env->cycles_after += cycles_before * freq;
+		}
+		env->cycles_before += cycles_before * freq;
+		free(order);
+	}
+
+	for (size_t i = 0; i < n_nodes; ++i)
+		env->positions[get_irn_idx(nodes[i].node)] = 0;
+	ARR_SHRINKLEN(env->nodes, 0);
+	for (unsigned r = 0, n = ir_target.isa->n_registers; r < n; ++r) {
+		env->last_def[r] = 0;
+		ARR_SHRINKLEN(env->readers[r], 0);
+	}
+	env->last_mem = 0;
+	obstack_free(&env->obst, NULL);
+	obstack_init(&env->obst);
+}
+
+/** Returns whether @p node must stay in its place. */
+static bool is_barrier(ir_node const *const node)
+{
+	return is_Phi(node) || is_cfop(node) || be_is_Asm(node)
+	    || arch_irn_is(node, schedule_first);
+}
+
+static void post_ra_sched_block(ir_node *const block, void *const data)
+{
+	post_ra_env_t *const env  = (post_ra_env_t*)data;
+	double         const freq = get_block_execfreq(block);
+	sched_foreach_safe(block, node) {
+		if (is_barrier(node)) {
+			schedule_region(env, node, freq);
+			continue;
+		}
+		region_node_t rnode = { .node = node };
+		get_machine_op(node, &rnode.op);
+		ARR_APP1(region_node_t, env->nodes, rnode);
+		env->positions[get_irn_idx(node)] = ARR_LEN(env->nodes);
+	}
+	schedule_region(env, block, freq);
+}
+
+void be_schedule_post_ra(ir_graph *const irg,
+                         arch_register_class_t const *const flags_cls)
+{
+	unsigned const n_regs = ir_target.isa->n_registers;
+
+	post_ra_env_t env;
+	memset(&env, 0, sizeof(env));
+	obstack_init(&env.obst);
+	env.flags_cls = flags_cls;
+	env.positions = XMALLOCNZ(unsigned, get_irg_last_idx(irg));
+	env.nodes     = NEW_ARR_F(region_node_t, 0);
+	env.last_def  = XMALLOCNZ(unsigned, n_regs);
+	env.readers   = XMALLOCN(unsigned*, n_regs);
+	for (unsigned r = 0; r < n_regs; ++r)
+		env.readers[r] = NEW_ARR_F(unsigned, 0);
+
+	irg_block_walk_graph(irg, post_ra_sched_block, NULL, &env);
+	stat_ev_dbl("sched_post_ra_cycles_before", env.cycles_before);
+	stat_ev_dbl("sched_post_ra_cycles_after",  env.cycles_after);
+
+	for (unsigned r = 0; r < n_regs; ++r)
+		DEL_ARR_F(env.readers[r]);
+	free(env.readers);
+	free(env.last_def);
+	DEL_ARR_F(env.nodes);
+	free(env.positions);
+	obstack_free(&env.obst, NULL);
+}
+
+BE_REGISTER_MODULE_CONSTRUCTOR(be_init_sched_latency)
+void be_init_sched_latency(void)
+{
+	be_register_scheduler("latency", sched_latency);
+	be_register_scheduler("pressure", sched_pressure);
+	FIRM_DBG_REGISTER(dbg, "firm.be.sched.latency");
+}
@@ -27,10 +27,12 @@
 
 bool be_coalesce_spill_slots = true;
 bool be_do_remats            = true;
+bool be_hoist_spills         = true;
 
 static const lc_opt_table_entry_t be_spill_options[] = {
 	LC_OPT_ENT_BOOL ("coalesce_slots", "coalesce the spill slots", &be_coalesce_spill_slots),
 	LC_OPT_ENT_BOOL ("remat", "try to rematerialize values instead of reloading", &be_do_remats),
+	LC_OPT_ENT_BOOL ("hoist", "move spills and reloads out of loops", &be_hoist_spills),
 	LC_OPT_LAST
 };
 
@@ -17,6 +17,7 @@
 
 extern bool be_coalesce_spill_slots;
 extern bool be_do_remats;
+extern bool be_hoist_spills;
 
 typedef void (*be_spill_func)(ir_graph *irg, const arch_register_class_t *cls,
 							  const regalloc_if_t *regif);
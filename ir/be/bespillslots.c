@@ -417,6 +417,70 @@ static void assign_spill_entity(be_fec_env_t *env, ir_node *node,
 	env->set_frame_entity(node, entity, size, po2align);
 }
 
+/** Sort spillslots by decreasing alignment, then by decreasing size. */
+static int cmp_spillslot_layout(void const *const p0, void const *const p1)
+{
+	spill_slot_t const *const s0 = *(spill_slot_t const**)p0;
+	spill_slot_t const *const s1 = *(spill_slot_t const**)p1;
+	if (s0->po2align != s1->po2align)
+		return QSORT_CMP(s1->po2align, s0->po2align);
+	if (s0->size != s1->size)
+		return QSORT_CMP(s1->size, s0->size);
+	return QSORT_CMP(s0, s1);
+}
+
+/**
+ * Returns the number of bytes needed to lay out @p n spillslots in the given
+ * order.
+ */
+static unsigned get_spillslots_bytes(spill_slot_t *const *const slots,
+                                     size_t const n)
+{
+	unsigned offset = 0;
+	for (size_t i = 0; i < n; ++i) {
+		offset  = round_up2(offset, 1u << slots[i]->po2align);
+		offset += slots[i]->size;
+	}
+	return offset;
+}
+
+/**
+ * Creates the frame entities of the used spillslots, such that the frame
+ * layout orders them by decreasing alignment to pack small slots without
+ * padding. be_sort_frame_entities() keeps the creation order of spillslots
+ * allocated at the begin of the frame and reverses it otherwise.
+ */
+static void create_spillslot_entities(be_fec_env_t *const env,
+                                      spill_slot_t *const spillslots)
+{
+	size_t         const spillcount = ARR_LEN(env->spills);
+	spill_slot_t **const used       = ALLOCAN(spill_slot_t*, spillcount);
+	unsigned      *const counted    = rbitset_alloca(spillcount);
+	size_t               n_used     = 0;
+	for (size_t s = 0; s < spillcount; ++s) {
+		int const slotid = env->spills[s]->spillslot;
+		if (!rbitset_is_set(counted, slotid)) {
+			rbitset_set(counted, slotid);
+			used[n_used++] = &spillslots[slotid];
+		}
+	}
+
+	if (stat_ev_enabled)
+		stat_ev_int("spillslot_bytes_unsorted",
+		            get_spillslots_bytes(used, n_used));
+
+	QSORT(used, n_used, cmp_spillslot_layout);
+
+	if (stat_ev_enabled)
+		stat_ev_int("spillslot_bytes", get_spillslots_bytes(used, n_used));
+
+	ir_type *const frame = get_irg_frame_type(env->irg);
+	for (size_t i = 0; i < n_used; ++i) {
+		spill_slot_t *const slot = used[env->at_begin ? i : n_used - i - 1];
+		slot->entity = new_spillslot(frame, slot->size, slot->po2align);
+	}
+}
+
 /**
  * Create stack entities for the spillslots and assign them to the spill and
  * reload nodes.
@@ -438,16 +502,14 @@ static void assign_spillslots(be_fec_env_t *env)
 		slot->po2align = MAX(slot->po2align, web->slot_po2align);
 	}
 
-	ir_type *const frame = get_irg_frame_type(env->irg);
+	create_spillslot_entities(env, spillslots);
+
 	for (size_t s = 0; s < spillcount; ++s) {
 		const spill_t *spill  = spills[s];
 		ir_node       *node   = spill->spill;
 		int            slotid = spill->spillslot;
 		spill_slot_t  *slot   = &spillslots[slotid];
 
-		if (slot->entity == NULL)
-			slot->entity = new_spillslot(frame, slot->size, slot->po2align);
-
 		if (is_Phi(node)) {
 			ir_node *block = get_nodes_block(node);
 
@@ -461,10 +523,6 @@ static void assign_spillslots(be_fec_env_t *env)
 
 				if (slotid != argslotid) {
 					spill_slot_t *argslot = &spillslots[argslotid];
-					if (argslot->entity == NULL)
-						argslot->entity = new_spillslot(frame, argslot->size,
-						                                argslot->po2align);
-
 					memperm_t *const memperm = get_memperm(env, predblock);
 					memperm_entry_t *const entry
 						= OALLOC(&env->obst, memperm_entry_t);
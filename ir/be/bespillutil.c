@@ -16,6 +16,8 @@
 #include "bearch.h"
 #include "bechordal_t.h"
 #include "beirg.h"
+#include "belive.h"
+#include "beloopana.h"
 #include "bemodule.h"
 #include "benode.h"
 #include "besched.h"
@@ -30,8 +32,10 @@
 #include "iredges_t.h"
 #include "irgmod.h"
 #include "irgwalk.h"
+#include "irloop.h"
 #include "irnode_t.h"
 #include "irnodehashmap.h"
+#include "pmap.h"
 #include "statev_t.h"
 #include "target_t.h"
 #include "type_t.h"
@@ -74,6 +78,12 @@ struct spill_info_t {
 	                                the value of the Phi gets spilled */
 };
 
+/** A reload created by be_insert_spills_reloads(). */
+typedef struct reload_t {
+	ir_node      *reload; /**< the reloaded value, NULL if it was replaced */
+	spill_info_t *info;   /**< spill info of the reloaded value */
+} reload_t;
+
 struct spill_env_t {
 	ir_graph         *irg;
 	ir_nodehashmap_t  spillmap;
@@ -84,7 +94,11 @@ struct spill_env_t {
 	unsigned          spill_count;
 	unsigned          reload_count;
 	unsigned          remat_count;
+	unsigned          remat_flags_count;
 	unsigned          spilled_phi_count;
+	unsigned          hoisted_spill_count;
+	unsigned          hoisted_reload_count;
+	reload_t         *reloads; /**< reloads created, for hoisting */
 };
 
 /**
@@ -112,6 +126,7 @@ spill_env_t *be_new_spill_env(ir_graph *irg, const regalloc_if_t *regif)
 	spill_env_t *env = XMALLOCZ(spill_env_t);
 	env->irg         = irg;
 	env->regif       = *regif;
+	env->reloads     = NEW_ARR_F(reload_t, 0);
 	ir_nodehashmap_init(&env->spillmap);
 	obstack_init(&env->obst);
 	return env;
@@ -119,6 +134,7 @@ spill_env_t *be_new_spill_env(ir_graph *irg, const regalloc_if_t *regif)
 
 void be_delete_spill_env(spill_env_t *env)
 {
+	DEL_ARR_F(env->reloads);
 	ir_nodehashmap_destroy(&env->spillmap);
 	obstack_free(&env->obst, NULL);
 	free(env);
@@ -326,11 +342,41 @@ static void spill_node(spill_env_t *env, spill_info_t *spillinfo)
 	}
 }
 
+/**
+ * Tests whether the register value @p arg is live right before @p reloader
+ * and stays in a register there, so that a rematerialisation may use it
+ * without extending its live range or raising the register pressure.
+ */
+static bool is_value_live_in_reg(spill_env_t *env, const ir_node *arg,
+                                 const ir_node *reloader)
+{
+	arch_register_req_t const *const req = arch_get_irn_register_req(arg);
+	if (req->cls == NULL || req->cls->manual_ra)
+		return false;
+	/* a value that is spilled somewhere is not guaranteed to be in a
+	 * register at the reload point */
+	if (ir_nodehashmap_get(spill_info_t, &env->spillmap, arg) != NULL)
+		return false;
+	/* next use estimates may name a Proj, which is not scheduled */
+	if (is_Proj(reloader))
+		return false;
+
+	ir_node const *const prev = sched_prev(reloader);
+	if (is_Block(prev)) {
+		be_lv_t const *const lv = be_get_irg_liveness(env->irg);
+		return be_is_live_in(lv, prev, arg);
+	}
+	if (prev == arg)
+		return get_irn_n_edges(arg) > 0;
+	return be_value_live_after(arg, prev);
+}
+
 /**
  * Tests whether value @p arg is available before node @p reloader
  * @returns true if value is available
  */
-static bool is_value_available(spill_env_t *env, const ir_node *arg)
+static bool is_value_available(spill_env_t *env, const ir_node *arg,
+                               const ir_node *reloader)
 {
 	if (is_Unknown(arg) || is_NoMem(arg))
 		return true;
@@ -344,6 +390,34 @@ static bool is_value_available(spill_env_t *env, const ir_node *arg)
 	if (arch_irn_is_ignore(arg))
 		return true;
 
+	return is_value_live_in_reg(env, arg, reloader);
+}
+
+/**
+ * Tests whether a flags value is live right before @p reloader, i.e. whether
+ * a node at or after @p reloader consumes flags produced before it.
+ * Flags are never live across blocks after be_sched_fix_flags(), so it is
+ * enough to scan the rest of the block up to the next flags producer.
+ */
+static bool are_flags_live_before(const ir_node *reloader)
+{
+	if (is_Proj(reloader))
+		return true;
+	for (ir_node const *node = reloader; !sched_is_end(node);
+	     node = sched_next(node)) {
+		foreach_irn_in(node, i, in) {
+			arch_register_req_t const *const req
+				= arch_get_irn_register_req_in(node, i);
+			if (req->cls == NULL || !req->cls->manual_ra)
+				continue;
+			ir_node const *const producer = skip_Proj_const(in);
+			if (arch_irn_is(producer, modify_flags)
+			    && value_strictly_dominates(producer, reloader))
+				return true;
+		}
+		if (arch_irn_is(node, modify_flags))
+			return false;
+	}
 	return false;
 }
 
@@ -352,6 +426,7 @@ static bool is_value_available(spill_env_t *env, const ir_node *arg)
  *
  * - The node itself is rematerializable
  * - All arguments of the node are available or also rematerialisable
+ * - The node does not clobber flags that are live at the reloader
  * - The costs for the rematerialisation operation is less or equal a limit
  *
  * Returns the costs needed for rematerialisation or something
@@ -373,16 +448,13 @@ static int check_remat_conditions_costs(spill_env_t *env,
 	if (parentcosts + costs >= spillcosts)
 		return REMAT_COST_INFINITE;
 
-	/* never rematerialize a node which modifies the flags.
-	 * (would be better to test whether the flags are actually live at point
-	 * reloader...)
-	 */
-	if (arch_irn_is(insn, modify_flags))
+	/* never rematerialize a node which clobbers live flags */
+	if (arch_irn_is(insn, modify_flags) && are_flags_live_before(reloader))
 		return REMAT_COST_INFINITE;
 
 	int argremats = 0;
 	foreach_irn_in(insn, i, arg) {
-		if (is_value_available(env, arg))
+		if (is_value_available(env, arg, reloader))
 			continue;
 
 		/* we have to rematerialize the argument as well */
@@ -413,12 +485,14 @@ static ir_node *do_remat(spill_env_t *env, ir_node *spilled, ir_node *reloader)
 {
 	ir_node **ins = ALLOCAN(ir_node*, get_irn_arity(spilled));
 	foreach_irn_in(spilled, i, arg) {
-		if (is_value_available(env, arg)) {
+		if (is_value_available(env, arg, reloader)) {
 			ins[i] = arg;
 		} else {
 			ins[i] = do_remat(env, arg, reloader);
 		}
 	}
+	if (!is_Proj(spilled) && arch_irn_is(spilled, modify_flags))
+		++env->remat_flags_count;
 
 	/* create a copy of the node */
 	ir_node *const bl  = get_nodes_block(reloader);
@@ -536,6 +610,334 @@ static void determine_spill_costs(spill_env_t *env, spill_info_t *spillinfo)
 	DB((dbg, LEVEL_1, "spill %+F after definition\n", to_spill));
 }
 
+/** Information about a loop for hoisting spills and reloads out of it. */
+typedef struct loop_hoist_t {
+	ir_node  *preheader;          /**< the only block entering the loop */
+	ir_node  *insert_point;       /**< insertion point at its end */
+	unsigned  pressure;           /**< register pressure in the loop */
+	unsigned  preheader_pressure; /**< register pressure at insert_point */
+} loop_hoist_t;
+
+/** The reloads inside a loop which read the same spill. */
+typedef struct reload_group_t {
+	ir_node      *mem;     /**< memory input of the reloads */
+	spill_info_t *info;    /**< spill info of the reloaded value */
+	double        freq;    /**< summed execution frequency of the reloads */
+	ir_node      *hoisted; /**< replacement reload in the preheader */
+} reload_group_t;
+
+static bool is_block_in_loop(const ir_node *block, const ir_loop *loop)
+{
+	ir_loop *l = get_irn_loop(block);
+	if (l == NULL)
+		return false;
+	unsigned const depth = get_loop_depth(loop);
+	while (get_loop_depth(l) > depth)
+		l = get_loop_outer_loop(l);
+	return l == loop;
+}
+
+/**
+ * Searches the control flow edges entering @p loop from blocks in @p part.
+ * Fails if there is more than one such edge.
+ */
+static bool find_loop_entry(const ir_loop *loop, const ir_loop *part,
+                            ir_node **entry)
+{
+	for (size_t i = 0, n = get_loop_n_elements(part); i < n; ++i) {
+		loop_element const elem = get_loop_element(part, i);
+		if (*elem.kind == k_ir_loop) {
+			if (!find_loop_entry(loop, elem.son, entry))
+				return false;
+			continue;
+		}
+
+		ir_node const *const block = elem.node;
+		for (int p = 0, n_preds = get_Block_n_cfgpreds(block); p < n_preds;
+		     ++p) {
+			ir_node *const pred = get_Block_cfgpred_block(block, p);
+			if (pred == NULL)
+				return false;
+			if (is_block_in_loop(pred, loop))
+				continue;
+			if (*entry != NULL)
+				return false;
+			*entry = pred;
+		}
+	}
+	return true;
+}
+
+/**
+ * Returns the preheader of @p loop: The only block outside of the loop
+ * jumping into it, which must not have other successors.
+ */
+static ir_node *get_loop_preheader(const ir_loop *loop)
+{
+	ir_node *preheader = NULL;
+	if (!find_loop_entry(loop, loop, &preheader) || preheader == NULL)
+		return NULL;
+
+	unsigned n_succs = 0;
+	foreach_block_succ(preheader, edge) {
+		++n_succs;
+	}
+	return n_succs == 1 ? preheader : NULL;
+}
+
+static void init_loop_hoist(spill_env_t *env, pmap *infos, ir_loop *loop,
+                            be_loopana_t *loop_ana,
+                            const arch_register_class_t *cls)
+{
+	loop_hoist_t *const info = OALLOCZ(&env->obst, loop_hoist_t);
+	pmap_insert(infos, loop, info);
+
+	if (get_loop_depth(loop) > 0) {
+		ir_node *const preheader = get_loop_preheader(loop);
+		if (preheader != NULL) {
+			info->preheader    = preheader;
+			info->insert_point = be_get_end_of_block_insertion_point(preheader);
+			if (cls != NULL) {
+				be_lv_t *const lv = be_get_irg_liveness(env->irg);
+				ir_nodeset_t   live;
+				ir_nodeset_init(&live);
+				be_liveness_nodes_live_before(lv, cls, info->insert_point,
+				                              &live);
+				info->preheader_pressure = ir_nodeset_size(&live);
+				ir_nodeset_destroy(&live);
+			}
+		}
+	}
+	if (cls != NULL)
+		info->pressure = be_get_loop_pressure(loop_ana, cls, loop);
+
+	for (size_t i = 0, n = get_loop_n_elements(loop); i < n; ++i) {
+		loop_element const elem = get_loop_element(loop, i);
+		if (*elem.kind == k_ir_loop)
+			init_loop_hoist(env, infos, elem.son, loop_ana, cls);
+	}
+}
+
+static bool is_spill_in_loop(const ir_node *spill, const ir_node *to_spill,
+                             const ir_loop *loop)
+{
+	if (spill == NULL || !is_block_in_loop(get_nodes_block(spill), loop))
+		return false;
+	/* after SSA reconstruction the spill may store a reload instead */
+	foreach_irn_in(spill, i, in) {
+		if (in == to_spill)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Replaces spills inside @p loop of values defined outside of it by a single
+ * spill in the preheader. The value is live in a register throughout the
+ * loop anyway, so this does not change register pressure.
+ */
+static void hoist_spills(spill_env_t *env, const ir_loop *loop,
+                         const loop_hoist_t *info)
+{
+	double const preheader_freq = get_block_execfreq(info->preheader);
+	for (spill_info_t *si = env->spills; si != NULL; si = si->next) {
+		ir_node *const to_spill = si->to_spill;
+		if (si->spilled_phi
+		    || is_block_in_loop(get_nodes_block(to_spill), loop))
+			continue;
+
+		double freq = 0;
+		for (spill_t *s = si->spills; s != NULL; s = s->next) {
+			if (is_spill_in_loop(s->spill, to_spill, loop))
+				freq += get_block_execfreq(get_nodes_block(s->spill));
+		}
+		if (freq <= preheader_freq)
+			continue;
+
+		ir_node *const hoisted
+			= env->regif.new_spill(to_spill, sched_prev(info->insert_point));
+		DBG((dbg, LEVEL_1, "hoist spills of %+F to %+F\n", to_spill, hoisted));
+		bool replaced = false;
+		for (spill_t *s = si->spills; s != NULL; s = s->next) {
+			ir_node *const spill = s->spill;
+			if (!is_spill_in_loop(spill, to_spill, loop))
+				continue;
+			sched_remove(spill);
+			exchange(spill, hoisted);
+			s->spill = replaced ? NULL : hoisted;
+			replaced = true;
+			++env->hoisted_spill_count;
+		}
+	}
+}
+
+static ir_node *get_reload_mem(const ir_node *reload)
+{
+	foreach_irn_in(skip_Proj_const(reload), i, in) {
+		if (get_irn_mode(in) == mode_M)
+			return in;
+	}
+	panic("reload %+F without memory input", reload);
+}
+
+static int cmp_reload_group_freq(const void *a, const void *b)
+{
+	reload_group_t const *const ga = *(reload_group_t const**)a;
+	reload_group_t const *const gb = *(reload_group_t const**)b;
+	return (ga->freq < gb->freq) - (ga->freq > gb->freq);
+}
+
+/**
+ * Replaces reloads inside @p loop reading the same spill by a single reload
+ * in the preheader, if the loop has a free register for the whole loop and
+ * the reloads execute more often than the preheader.
+ */
+static void hoist_reloads(spill_env_t *env, pmap *infos, ir_loop *loop,
+                          loop_hoist_t *info, unsigned n_regs)
+{
+	ir_nodehashmap_t groups;
+	ir_nodehashmap_init(&groups);
+	reload_group_t **group_list = NEW_ARR_F(reload_group_t*, 0);
+	for (size_t i = 0, n = ARR_LEN(env->reloads); i < n; ++i) {
+		reload_t const *const r = &env->reloads[i];
+		if (r->reload == NULL)
+			continue;
+		ir_node *const block = get_nodes_block(r->reload);
+		if (!is_block_in_loop(block, loop))
+			continue;
+
+		ir_node        *const mem   = get_reload_mem(r->reload);
+		reload_group_t       *group
+			= ir_nodehashmap_get(reload_group_t, &groups, mem);
+		if (group == NULL) {
+			group       = OALLOCZ(&env->obst, reload_group_t);
+			group->mem  = mem;
+			group->info = r->info;
+			ir_nodehashmap_insert(&groups, mem, group);
+			ARR_APP1(reload_group_t*, group_list, group);
+		}
+		group->freq += get_block_execfreq(block);
+	}
+
+	/* every hoisted value occupies a register in the whole loop, so prefer
+	 * the most frequently executed reloads */
+	QSORT_ARR(group_list, cmp_reload_group_freq);
+	double const  preheader_freq = get_block_execfreq(info->preheader);
+	ir_node      *const insert_point = info->insert_point;
+	for (size_t i = 0, n = ARR_LEN(group_list); i < n; ++i) {
+		if (info->pressure >= n_regs || info->preheader_pressure >= n_regs)
+			break;
+		reload_group_t *const group = group_list[i];
+		if (group->freq <= preheader_freq
+		    || !value_strictly_dominates(skip_Proj(group->mem), insert_point))
+			continue;
+
+		group->hoisted = env->regif.new_reload(group->info->to_spill,
+		                                       group->mem, insert_point);
+		DBG((dbg, LEVEL_1, "hoist reloads of %+F to %+F\n",
+		     group->info->to_spill, group->hoisted));
+		++info->preheader_pressure;
+		for (ir_loop *l = loop;; l = get_loop_outer_loop(l)) {
+			++pmap_get(loop_hoist_t, infos, l)->pressure;
+			if (get_loop_depth(l) == 0)
+				break;
+		}
+	}
+
+	for (size_t i = 0, n = ARR_LEN(env->reloads); i < n; ++i) {
+		reload_t *const r = &env->reloads[i];
+		if (r->reload == NULL
+		    || !is_block_in_loop(get_nodes_block(r->reload), loop))
+			continue;
+		ir_node        *const mem   = get_reload_mem(r->reload);
+		reload_group_t *const group
+			= ir_nodehashmap_get(reload_group_t, &groups, mem);
+		if (group->hoisted == NULL)
+			continue;
+		sched_remove(skip_Proj(r->reload));
+		exchange(r->reload, group->hoisted);
+		r->reload = NULL;
+		++env->hoisted_reload_count;
+	}
+	for (size_t i = 0, n = ARR_LEN(group_list); i < n; ++i) {
+		reload_group_t const *const group = group_list[i];
+		if (group->hoisted != NULL) {
+			reload_t const r = { .reload = group->hoisted, .info = group->info };
+			ARR_APP1(reload_t, env->reloads, r);
+		}
+	}
+
+	DEL_ARR_F(group_list);
+	ir_nodehashmap_destroy(&groups);
+}
+
+/** Hoists spills and reloads out of @p loop, inner loops first. */
+static void hoist_from_loop(spill_env_t *env, pmap *infos, ir_loop *loop,
+                            unsigned n_regs)
+{
+	for (size_t i = 0, n = get_loop_n_elements(loop); i < n; ++i) {
+		loop_element const elem = get_loop_element(loop, i);
+		if (*elem.kind == k_ir_loop)
+			hoist_from_loop(env, infos, elem.son, n_regs);
+	}
+
+	loop_hoist_t *const info = pmap_get(loop_hoist_t, infos, loop);
+	if (info->preheader == NULL)
+		return;
+	hoist_spills(env, loop, info);
+	hoist_reloads(env, infos, loop, info, n_regs);
+}
+
+static bool is_in_any_loop(const ir_node *node)
+{
+	return get_loop_depth(get_irn_loop(get_nodes_block(node))) > 0;
+}
+
+/**
+ * Belady places spills and reloads where the register pressure peaks, which
+ * may be inside a loop although the value is defined before it. Move them to
+ * the loop preheaders if the pressure after spilling allows it.
+ */
+static void hoist_out_of_loops(spill_env_t *env)
+{
+	ir_graph *const irg = env->irg;
+	assure_loopinfo(irg);
+
+	bool                         in_loop = false;
+	const arch_register_class_t *cls     = NULL;
+	for (size_t i = 0, n = ARR_LEN(env->reloads); i < n; ++i) {
+		ir_node const *const reload = env->reloads[i].reload;
+		cls      = arch_get_irn_register_req(reload)->cls;
+		in_loop |= is_in_any_loop(reload);
+	}
+	for (spill_info_t *si = env->spills; si != NULL && !in_loop;
+	     si = si->next) {
+		if (si->spilled_phi)
+			continue;
+		for (spill_t *s = si->spills; s != NULL; s = s->next) {
+			if (s->spill != NULL && is_in_any_loop(s->spill))
+				in_loop = true;
+		}
+	}
+	if (!in_loop)
+		return;
+
+	be_invalidate_live_sets(irg);
+	be_assure_live_sets(irg);
+	be_loopana_t *const loop_ana
+		= cls != NULL ? be_new_loop_pressure(irg, cls) : NULL;
+	unsigned const n_regs
+		= cls != NULL ? be_get_n_allocatable_regs(irg, cls) : 0;
+
+	pmap *const infos = pmap_create();
+	init_loop_hoist(env, infos, get_irg_loop(irg), loop_ana, cls);
+	hoist_from_loop(env, infos, get_irg_loop(irg), n_regs);
+	pmap_destroy(infos);
+
+	if (loop_ana != NULL)
+		be_free_loop_pressure(loop_ana);
+}
+
 void be_insert_spills_reloads(spill_env_t *env)
 {
 	be_timer_push(T_RA_SPILL_APPLY);
@@ -547,6 +949,10 @@ void be_insert_spills_reloads(spill_env_t *env)
 		spill_node(env, info);
 	}
 
+	/* the SSA form of all spilled values is repaired with one environment */
+	be_ssa_construction_env_t senv;
+	be_ssa_construction_init(&senv, env->irg);
+
 	/* process each spilled node */
 	for (spill_info_t *si = env->spills; si != NULL; si = si->next) {
 		ir_node  *to_spill        = si->to_spill;
@@ -622,6 +1028,8 @@ void be_insert_spills_reloads(spill_env_t *env)
 				copy = env->regif.new_reload(si->to_spill, si->spills->spill,
 				                             rld->reloader);
 				env->reload_count++;
+				reload_t const r = { .reload = copy, .info = si };
+				ARR_APP1(reload_t, env->reloads, r);
 			}
 
 			DBG((dbg, LEVEL_1, " %+F of %+F before %+F\n",
@@ -632,17 +1040,13 @@ void be_insert_spills_reloads(spill_env_t *env)
 		/* if we had any reloads or remats, then we need to reconstruct the
 		 * SSA form for the spilled value */
 		if (ARR_LEN(copies) > 0) {
-			be_ssa_construction_env_t senv;
-			be_ssa_construction_init(&senv, env->irg);
 			be_ssa_construction_add_copy(&senv, to_spill);
 			be_ssa_construction_add_copies(&senv, copies, ARR_LEN(copies));
 			be_ssa_construction_fix_users(&senv, to_spill);
-			be_ssa_construction_destroy(&senv);
+			be_ssa_construction_reset(&senv);
 		}
 		/* need to reconstruct SSA form if we had multiple spills */
 		if (si->spills != NULL && si->spills->next != NULL) {
-			be_ssa_construction_env_t senv;
-			be_ssa_construction_init(&senv, env->irg);
 			unsigned spill_count = 0;
 			for (spill_t *spill = si->spills ; spill != NULL;
 			     spill = spill->next) {
@@ -657,17 +1061,24 @@ void be_insert_spills_reloads(spill_env_t *env)
 				be_ssa_construction_fix_users(&senv, si->spills->spill);
 			}
 
-			be_ssa_construction_destroy(&senv);
+			be_ssa_construction_reset(&senv);
 		}
 
 		DEL_ARR_F(copies);
 		si->reloaders = NULL;
 	}
+	be_ssa_construction_destroy(&senv);
+
+	if (be_hoist_spills)
+		hoist_out_of_loops(env);
 
 	stat_ev_dbl("spill_spills", env->spill_count);
 	stat_ev_dbl("spill_reloads", env->reload_count);
 	stat_ev_dbl("spill_remats", env->remat_count);
+	stat_ev_dbl("spill_remats_flags", env->remat_flags_count);
 	stat_ev_dbl("spill_spilled_phis", env->spilled_phi_count);
+	stat_ev_dbl("spill_hoisted_spills", env->hoisted_spill_count);
+	stat_ev_dbl("spill_hoisted_reloads", env->hoisted_reload_count);
 
 	/* Matze: In theory be_ssa_construction should take care of the liveness...
 	 * try to disable this again in the future */
@@ -1012,7 +1423,9 @@ void be_spill_prepare_for_constraints(ir_graph *irg)
 
 	irg_block_walk_graph(irg, NULL, assure_constraints_walker, &cenv);
 
-	/* for all */
+	/* introduce the copies for all operands in one batch */
+	be_ssa_construction_env_t senv;
+	be_ssa_construction_init(&senv, irg);
 	ir_nodehashmap_iterator_t map_iter;
 	ir_nodehashmap_entry_t    map_entry;
 	foreach_ir_nodehashmap(&cenv.op_set, map_entry, map_iter) {
@@ -1022,13 +1435,18 @@ void be_spill_prepare_for_constraints(ir_graph *irg)
 
 		DBG((dbg_constr, LEVEL_1, "introduce %zu copies for %+F\n", n_copies, map_entry.node));
 
-		/* introduce the copies for the operand and its copies */
-		be_ssa_construction_env_t senv;
-		be_ssa_construction_init(&senv, irg);
 		be_ssa_construction_add_copy(&senv, map_entry.node);
 		be_ssa_construction_add_copies(&senv, copies, n_copies);
 		be_ssa_construction_fix_users(&senv, map_entry.node);
-		be_ssa_construction_destroy(&senv);
+		be_ssa_construction_reset(&senv);
+	}
+	be_ssa_construction_destroy(&senv);
+
+	/* for all */
+	foreach_ir_nodehashmap(&cenv.op_set, map_entry, map_iter) {
+		op_copy_assoc_t const *const entry    = (op_copy_assoc_t const*)map_entry.data;
+		ir_node              **const copies   = entry->copies;
+		size_t                 const n_copies = ARR_LEN(copies);
 
 		/* Could be that not all CopyKeeps are really needed,
 		 * so we transform unnecessary ones into Keeps. */
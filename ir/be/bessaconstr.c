@@ -31,10 +31,14 @@
  *
  * This function reroutes all uses of the original value to the copies in the
  * corresponding dominance subtrees and creates Phi functions where necessary.
+ *
+ * The search for the reaching definition walks up the dominator tree with an
+ * explicit stack and caches the result at every block it passed, uses and
+ * Phi arguments are processed from a worklist. Several values can be handled
+ * with one environment by calling be_ssa_construction_reset() between them,
+ * this shares the graph wide setup (dominance frontiers, node map, reserved
+ * resources) for the whole batch.
  */
-/* statev in this file is extensive, so only enable if needed */
-#define DISABLE_STATEV
-
 #include "bessaconstr.h"
 #include "bemodule.h"
 #include "besched.h"
@@ -52,9 +56,6 @@
 
 DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
 
-static ir_node *search_def_end_of_block(be_ssa_construction_env_t *env,
-                                        ir_node *block);
-
 struct constr_info {
 	bool is_definition     : 1;
 	bool is_use            : 1;
@@ -86,6 +87,7 @@ static constr_info *get_or_set_info(be_ssa_construction_env_t *env,
 	if (info == NULL) {
 		info = OALLOCZ(&env->obst, constr_info);
 		ir_nodemap_insert(&env->infos, node, info);
+		ARR_APP1(ir_node*, env->touched, (ir_node*)node);
 	}
 	return info;
 }
@@ -164,9 +166,7 @@ static void introduce_use(be_ssa_construction_env_t *env, ir_node *use)
  */
 static void mark_iterated_dominance_frontiers(be_ssa_construction_env_t *env)
 {
-	stat_ev_cnt_decl(blocks);
 	DBG((dbg, LEVEL_3, "Dominance Frontier:"));
-	stat_ev_tim_push();
 	while (!deq_empty(&env->worklist)) {
 		ir_node  *block    = deq_pop_pointer_left(ir_node, &env->worklist);
 		ir_node **domfront = ir_get_dominance_frontier(block);
@@ -180,11 +180,9 @@ static void mark_iterated_dominance_frontiers(be_ssa_construction_env_t *env)
 
 			DBG((dbg, LEVEL_3, " %+F", y));
 			mark_Block_block_visited(y);
-			stat_ev_cnt_inc(blocks);
+			++env->n_idf_blocks;
 		}
 	}
-	stat_ev_tim_pop("bessaconstr_idf_time");
-	stat_ev_cnt_done(blocks, "bessaconstr_idf_blocks");
 	DBG((dbg, LEVEL_3, "\n"));
 }
 
@@ -212,14 +210,71 @@ static ir_node *insert_dummy_phi(be_ssa_construction_env_t *env, ir_node *block)
 }
 
 /**
- * @return Last definition of the immediate dominator.
+ * @return Last definition of a block containing a definition.
  */
-static ir_node *get_def_at_idom(be_ssa_construction_env_t *env, ir_node *block)
+static ir_node *get_last_definition(be_ssa_construction_env_t *env,
+                                    ir_node *block, constr_info *block_info)
 {
-	ir_node *dom = get_Block_idom(block);
-	assert(dom != NULL);
-	DBG((dbg, LEVEL_3, "\t...continue at idom %+F\n", dom));
-	return search_def_end_of_block(env, dom);
+	assert(has_definition(block));
+	ir_node *last_definition = block_info->u.last_definition;
+	if (last_definition != NULL)
+		return last_definition;
+
+	/* Search the last definition of the block. Uses in the block do not
+	 * influence the result and are fixed when they leave the worklist. */
+	sched_foreach_reverse(block, def) {
+		constr_info const *const info = get_info(env, def);
+		if (info && info->is_definition) {
+			DBG((dbg, LEVEL_3, "\t...found definition %+F\n",
+			     info->u.definition));
+			last_definition = info->u.definition;
+			break;
+		}
+	}
+	assert(last_definition && "No definition found");
+
+	block_info->u.last_definition = last_definition;
+	return last_definition;
+}
+
+/**
+ * @return Last definition of the given block.
+ *
+ * Walks up the dominator tree until a block with a known definition at its
+ * end is found or a phi has to be created, and records the result for all
+ * blocks on the way.
+ */
+static ir_node *search_def_end_of_block(be_ssa_construction_env_t *env,
+                                        ir_node *block)
+{
+	size_t const base = ARR_LEN(env->stack);
+	ir_node     *def;
+	for (;;) {
+		constr_info *const block_info = get_or_set_info(env, block);
+		if (block_info->u.last_definition != NULL) {
+			def = block_info->u.last_definition;
+			break;
+		} else if (has_definition(block)) {
+			def = get_last_definition(env, block, block_info);
+			break;
+		} else if (Block_block_visited(block)) {
+			/* Create a phi if the block is in the dominance frontier. */
+			def = insert_dummy_phi(env, block);
+			break;
+		}
+
+		ARR_APP1(ir_node*, env->stack, block);
+		block = get_Block_idom(block);
+		assert(block != NULL);
+		DBG((dbg, LEVEL_3, "\t...continue at idom %+F\n", block));
+	}
+
+	for (size_t i = base, n = ARR_LEN(env->stack); i < n; ++i) {
+		constr_info *const info = get_info(env, env->stack[i]);
+		info->u.last_definition = def;
+	}
+	ARR_SHRINKLEN(env->stack, base);
+	return def;
 }
 
 static ir_node *get_def_from_preds(be_ssa_construction_env_t *const env,
@@ -229,7 +284,10 @@ static ir_node *get_def_from_preds(be_ssa_construction_env_t *const env,
 	if (Block_block_visited(block)) {
 		return insert_dummy_phi(env, block);
 	} else {
-		return get_def_at_idom(env, block);
+		ir_node *dom = get_Block_idom(block);
+		assert(dom != NULL);
+		DBG((dbg, LEVEL_3, "\t...continue at idom %+F\n", dom));
+		return search_def_end_of_block(env, dom);
 	}
 }
 
@@ -290,45 +348,6 @@ static void process_block(be_ssa_construction_env_t *env, ir_node *block)
 	block_info->u.last_definition = def;
 }
 
-/**
- * @return Last definition of the given block.
- */
-static ir_node *search_def_end_of_block(be_ssa_construction_env_t *env,
-                                        ir_node *block)
-{
-	constr_info *block_info      = get_or_set_info(env, block);
-	ir_node     *last_definition = block_info->u.last_definition;
-
-	if (last_definition != NULL)
-		return last_definition;
-
-	if (has_definition(block)) {
-		if (has_use(env, block)) {
-			if (!block_info->already_processed)
-				process_block(env, block);
-		} else {
-			/* Search the last definition of the block. */
-			sched_foreach_reverse(block, def) {
-				constr_info const *const info = get_info(env, def);
-				if (info && info->is_definition) {
-					DBG((dbg, LEVEL_3, "\t...found definition %+F\n",
-					     info->u.definition));
-					block_info->u.last_definition = info->u.definition;
-					break;
-				}
-			}
-
-			assert(block_info->u.last_definition && "No definition found");
-		}
-
-		return block_info->u.last_definition;
-	} else {
-		ir_node *const def = get_def_from_preds(env, block);
-		block_info->u.last_definition = def;
-		return def;
-	}
-}
-
 /**
  * Fixes all operands of the given use.
  */
@@ -351,15 +370,13 @@ static void search_def_at_block(be_ssa_construction_env_t *const env,
 
 void be_ssa_construction_init(be_ssa_construction_env_t *env, ir_graph *irg)
 {
-	stat_ev_ctx_push_fmt("bessaconstr", "%+F", irg);
 	stat_ev_tim_push();
 
-	stat_ev_dbl("bessaconstr_n_blocks",
-	            get_Block_dom_max_subtree_pre_num(get_irg_start_block(irg)));
-
 	memset(env, 0, sizeof(env[0]));
 	env->irg       = irg;
 	env->new_phis  = NEW_ARR_F(ir_node*, 0);
+	env->stack     = NEW_ARR_F(ir_node*, 0);
+	env->touched   = NEW_ARR_F(ir_node*, 0);
 	deq_init(&env->worklist);
 	ir_nodemap_init(&env->infos, irg);
 	obstack_init(&env->obst);
@@ -378,19 +395,41 @@ void be_ssa_construction_init(be_ssa_construction_env_t *env, ir_graph *irg)
 	inc_irg_block_visited(irg);
 }
 
+void be_ssa_construction_reset(be_ssa_construction_env_t *env)
+{
+	assert(deq_empty(&env->worklist));
+
+	for (size_t i = 0, n = ARR_LEN(env->touched); i < n; ++i) {
+		ir_nodemap_insert_fast(&env->infos, env->touched[i], NULL);
+	}
+	ARR_SHRINKLEN(env->touched, 0);
+	obstack_free(&env->obst, NULL);
+	obstack_init(&env->obst);
+
+	env->phi_req                      = NULL;
+	env->iterated_domfront_calculated = false;
+
+	inc_irg_visited(env->irg);
+	inc_irg_block_visited(env->irg);
+}
+
 void be_ssa_construction_destroy(be_ssa_construction_env_t *env)
 {
+	stat_ev_int("bessaconstr_values", env->n_values);
 	stat_ev_int("bessaconstr_phis", ARR_LEN(env->new_phis));
+	stat_ev_int("bessaconstr_uses", env->n_uses);
+	stat_ev_int("bessaconstr_idf_blocks", env->n_idf_blocks);
 	obstack_free(&env->obst, NULL);
 	ir_nodemap_destroy(&env->infos);
 	deq_free(&env->worklist);
+	DEL_ARR_F(env->touched);
+	DEL_ARR_F(env->stack);
 	DEL_ARR_F(env->new_phis);
 
 	ir_free_resources(env->irg, IR_RESOURCE_IRN_VISITED
 	                          | IR_RESOURCE_BLOCK_VISITED | IR_RESOURCE_IRN_LINK);
 
-	stat_ev_tim_pop("bessaconstr_total_time");
-	stat_ev_ctx_pop("bessaconstr");
+	stat_ev_tim_pop("bessaconstr_time");
 }
 
 static void determine_phi_req(be_ssa_construction_env_t *env, ir_node *value)
@@ -487,11 +526,10 @@ void be_ssa_construction_fix_users_array(be_ssa_construction_env_t *env,
 	}
 
 	DBG((dbg, LEVEL_1, "\tfixing users array\n"));
+	++env->n_values;
 
 	assert(deq_empty(&env->worklist));
 
-	stat_ev_tim_push();
-
 	for (size_t i = 0; i < nodes_len; ++i) {
 		ir_node *value = nodes[i];
 		DBG((dbg, LEVEL_3, "\tfixing users of %+F\n", value));
@@ -506,7 +544,6 @@ void be_ssa_construction_fix_users_array(be_ssa_construction_env_t *env,
 		}
 	}
 
-	stat_ev_cnt_decl(uses);
 	while (!deq_empty(&env->worklist)) {
 		ir_node     *use  = deq_pop_pointer_left(ir_node, &env->worklist);
 		constr_info *info = get_info(env, use);
@@ -521,12 +558,10 @@ void be_ssa_construction_fix_users_array(be_ssa_construction_env_t *env,
 			search_def_at_block(env, use, info);
 		}
 
-		stat_ev_cnt_inc(uses);
+		++env->n_uses;
 	}
 
 	be_timer_pop(T_SSA_CONSTR);
-	stat_ev_tim_pop("bessaconstr_fix_time");
-	stat_ev_cnt_done(uses, "bessaconstr_uses");
 }
 
 void be_ssa_construction_fix_users(be_ssa_construction_env_t *env,
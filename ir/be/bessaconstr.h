@@ -49,6 +49,11 @@ typedef struct be_ssa_construction_env_t {
 	bool                         iterated_domfront_calculated;
 	ir_nodemap                   infos;
 	struct obstack               obst;
+	ir_node                    **stack;    /**< blocks of the dominator search */
+	ir_node                    **touched;  /**< nodes with an entry in infos */
+	unsigned                     n_values;
+	unsigned                     n_uses;
+	unsigned                     n_idf_blocks;
 } be_ssa_construction_env_t;
 
 /**
@@ -74,6 +79,16 @@ void be_ssa_construction_fix_users(be_ssa_construction_env_t *env,
 void be_ssa_construction_fix_users_array(be_ssa_construction_env_t *env,
                                          ir_node **nodes, size_t nodes_len);
 
+/**
+ * Prepares the environment for the next value of a batch.
+ *
+ * Forgets the copies and users of the previous value but keeps the graph
+ * wide setup and the list of phis created so far. Reusing one environment for
+ * many values avoids the setup costs of be_ssa_construction_init() for each
+ * value.
+ */
+void be_ssa_construction_reset(be_ssa_construction_env_t *env);
+
 /**
  * Recompute the liveness of the inserted phis.
  * @note Remember that you have to call update_liveness on the copies yourself
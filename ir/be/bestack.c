@@ -205,10 +205,8 @@ static int cmp_slots_first(void const *const p0, void const *const p1)
 
 void be_sort_frame_entities(ir_type *const frame, bool spillslots_first)
 {
-	unsigned const n_members = get_compound_n_members(frame);
-	assert(is_compound_type(frame));
-	QSORT(frame->attr.compound.members, n_members,
-		  spillslots_first ? cmp_slots_first : cmp_slots_last);
+	sort_compound_members(frame,
+	                      spillslots_first ? cmp_slots_first : cmp_slots_last);
 }
 
 void be_layout_frame_type(ir_type *const frame, int const begin,
@@ -126,6 +126,12 @@ static void node_stat_walker(ir_node *irn, void *data)
 		(*stats)[BE_STAT_PERMS]++;
 	} else if (be_is_Copy(irn)) {
 		(*stats)[BE_STAT_COPIES]++;
+	} else if (is_Proj(irn)) {
+		/* Projs carry no backend flags */
+	} else if (arch_irn_is(irn, spill)) {
+		(*stats)[BE_STAT_SPILLS]++;
+	} else if (arch_irn_is(irn, reload)) {
+		(*stats)[BE_STAT_RELOADS]++;
 	}
 }
 
@@ -154,6 +160,8 @@ static const char *get_stat_name(enum be_stat_tag_t tag)
 	case BE_STAT_MEM_PHIS: return "mem_phis";
 	case BE_STAT_COPIES:   return "copies";
 	case BE_STAT_PERMS:    return "perms";
+	case BE_STAT_SPILLS:   return "spills";
+	case BE_STAT_RELOADS:  return "reloads";
 	default:               panic("unknown stat tag found");
 	}
 }
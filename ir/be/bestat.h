@@ -20,6 +20,8 @@ typedef enum be_stat_tag_t {
 	BE_STAT_MEM_PHIS,             /**< memory-phi count */
 	BE_STAT_COPIES,               /**< copies */
 	BE_STAT_PERMS,                /**< perms */
+	BE_STAT_SPILLS,               /**< spills */
+	BE_STAT_RELOADS,              /**< reloads not folded into their user */
 	BE_STAT_COUNT
 } be_stat_tag_t;
 ENUM_COUNTABLE(be_stat_tag_t)
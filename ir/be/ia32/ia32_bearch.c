@@ -41,6 +41,7 @@
 #include "lower_alloc.h"
 #include "lower_builtins.h"
 #include "lower_calls.h"
+#include "lower_copyb.h"
 #include "lower_mode_b.h"
 #include "lower_softfloat.h"
 #include "lowering.h"
@@ -333,10 +334,10 @@ static bool ia32_possible_memory_operand(const ir_node *irn, unsigned int i)
 	return true;
 }
 
-static void ia32_perform_memory_operand(ir_node *irn, unsigned int i)
+static bool ia32_perform_memory_operand(ir_node *irn, unsigned int i)
 {
 	if (!ia32_possible_memory_operand(irn, i))
-		return;
+		return false;
 
 	ir_node           *const op           = get_irn_n(irn, i);
 	ir_node           *const load         = get_Proj_pred(op);
@@ -371,6 +372,7 @@ static void ia32_perform_memory_operand(ir_node *irn, unsigned int i)
 	sched_remove(load);
 	kill_node(op);
 	kill_node(load);
+	return true;
 }
 
 static bool gprof;
@@ -1624,17 +1626,21 @@ static void ia32_lower_for_target(void)
 		/* lower for mode_b stuff */
 		ir_lower_mode_b(irg, ia32_mode_gp);
 		be_after_transform(irg, "lower-modeb");
-		lower_alloc(irg, ir_platform.ia32_po2_stackalign);
-		be_after_transform(irg, "lower-alloc");
 	}
 
+	/* Alloc and CopyB lowering only look at single nodes, so run them
+	 * together in one traversal per graph.
+	 * Turn all small CopyBs into loads/stores, keep medium-sized CopyBs,
+	 * so we can generate rep movs later, and turn all big CopyBs into
+	 * memcpy calls. */
+	lower_nodes_t *lower = lower_nodes_new();
+	lower_alloc_register(lower, ir_platform.ia32_po2_stackalign);
+	lower_CopyB_register(lower, 64, 8193, true);
 	foreach_irp_irg(i, irg) {
-		/* Turn all small CopyBs into loads/stores, keep medium-sized CopyBs,
-		 * so we can generate rep movs later, and turn all big CopyBs into
-		 * memcpy calls. */
-		lower_CopyB(irg, 64, 8193, true);
-		be_after_transform(irg, "lower-copyb");
+		lower_nodes_irg(lower, irg);
+		be_after_transform(irg, "lower-nodes");
 	}
+	lower_nodes_free(lower);
 }
 
 static const lc_opt_table_entry_t ia32_options[] = {
@@ -20,6 +20,7 @@
 #include "irgmod.h"
 #include "irgopt.h"
 #include "irgraph_t.h"
+#include "irgwalk.h"
 #include "irhooks.h"
 #include "irmode_t.h"
 #include "irnode_t.h"
@@ -515,6 +516,69 @@ void irg_finalize_cons(ir_graph *irg)
 	clear_irg_constraints(irg, IR_GRAPH_CONSTRAINT_CONSTRUCTION);
 }
 
+void irg_begin_bulk_cons(ir_graph *irg)
+{
+	assert(irg_is_constrained(irg, IR_GRAPH_CONSTRAINT_CONSTRUCTION));
+	add_irg_constraints(irg, IR_GRAPH_CONSTRAINT_BULK_CONSTRUCTION);
+}
+
+/**
+ * Post-walker: Replaces a node by an equivalent node already entered into the
+ * CSE table.  The inputs have already been visited, except for back edges.
+ */
+static void cse_bulk_node(ir_node *node, void *env)
+{
+	bool *changed = (bool*)env;
+
+	/* skip the Ids left behind by replaced inputs so that the hashes match */
+	foreach_irn_in(node, i, pred) {
+		if (is_Id(pred))
+			set_irn_n(node, i, skip_Id(pred));
+	}
+
+	/* blocks are never equal; Phis may get Id inputs through back edges
+	 * after they have been entered into the table, the keep-alives of End
+	 * change all the time */
+	if (is_Block(node) || is_Phi(node) || is_End(node) || is_Anchor(node))
+		return;
+
+	ir_node *const nn = identify_remember(node);
+	if (nn != node) {
+		if (get_nodes_block(nn) != get_nodes_block(node))
+			set_irg_pinned(get_irn_irg(node), op_pin_state_floats);
+		exchange(node, nn);
+		*changed = true;
+	}
+}
+
+#ifdef DEBUG_libfirm
+static void verify_bulk_node(ir_node *node, void *env)
+{
+	(void)env;
+	if (UNLIKELY(!irn_verify(node)))
+		abort();
+}
+#endif
+
+void irg_finalize_bulk_cons(ir_graph *irg)
+{
+	assert(irg_is_constrained(irg, IR_GRAPH_CONSTRAINT_BULK_CONSTRUCTION));
+	clear_irg_constraints(irg, IR_GRAPH_CONSTRAINT_BULK_CONSTRUCTION);
+	irg_finalize_cons(irg);
+
+	if (get_optimize() && get_opt_cse()) {
+		bool changed = false;
+		irg_walk_anchors(irg, NULL, cse_bulk_node, &changed);
+		/* replaced nodes may have been kept alive twice */
+		if (changed)
+			remove_End_Bads_and_doublets(get_irg_end(irg));
+	}
+
+#ifdef DEBUG_libfirm
+	irg_walk_anchors(irg, verify_bulk_node, NULL, NULL);
+#endif
+}
+
 ir_node *new_Const_long(ir_mode *mode, long value)
 {
 	return new_d_Const_long(NULL, mode, value);
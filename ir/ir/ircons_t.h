@@ -28,6 +28,9 @@ static inline ir_node *_get_cur_block(void)
 static inline void verify_new_node_(ir_node *const node)
 {
 #ifdef DEBUG_libfirm
+	/* bulk constructed nodes are verified by irg_finalize_bulk_cons() */
+	if (irg_is_constrained(get_irn_irg(node), IR_GRAPH_CONSTRAINT_BULK_CONSTRUCTION))
+		return;
 	if (UNLIKELY(!irn_verify(node)))
 		abort();
 #else
@@ -9,6 +9,8 @@
  * @author  Martin Trapp, Christian Schaefer, Goetz Lindenmaier, Hubert Schmidt,
  *          Matthias Braun
  */
+/* open_memstream() */
+#define _POSIX_C_SOURCE 200809L
 #include "irdump_t.h"
 
 #include "array.h"
@@ -31,11 +33,13 @@
 #include "panic.h"
 #include "pmap.h"
 #include "pset.h"
+#include "raw_bitset.h"
 #include "tv_t.h"
 #include "util.h"
 #include <errno.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -1330,6 +1334,8 @@ static void dump_graph_info(FILE *F, ir_graph *irg)
 		fprintf(F, " consistent_entity_usage");
 	if (irg_has_properties(irg, IR_GRAPH_PROPERTY_MANY_RETURNS))
 		fprintf(F, " many_returns");
+	if (irg_has_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_ALIAS_INFO))
+		fprintf(F, " consistent_alias_info");
 	fprintf(F, "\"\n");
 }
 
@@ -2188,8 +2194,179 @@ void dump_ir_prog_ext(ir_prog_dump_func func, const char *suffix)
 	fclose(out);
 }
 
+typedef struct stream_env_t {
+	FILE     *out;
+	FILE     *label;      /**< memory stream for the node labels, may be NULL */
+	char     *label_buf;  /**< buffer of the label stream */
+	size_t    label_size; /**< size of the label stream */
+	uint64_t *state;      /**< fingerprint per node index, 0 if not dumped */
+	unsigned *seen;       /**< nodes reached in this dump */
+} stream_env_t;
+
+static uint64_t fingerprint_add(uint64_t hash, uint64_t value)
+{
+	/* FNV-1a over the bytes of value */
+	for (unsigned i = 0; i < sizeof(value); ++i) {
+		hash ^= (value >> (i * 8)) & 0xFF;
+		hash *= UINT64_C(0x100000001B3);
+	}
+	return hash;
+}
+
+/**
+ * Returns the fingerprint of @p node. It includes the label, so that changed
+ * attributes (Proj numbers, tarvals, entities, ...) are noticed.
+ */
+static uint64_t node_fingerprint(const ir_node *node, const char *label,
+                                 size_t label_len)
+{
+	uint64_t hash = UINT64_C(0xCBF29CE484222325);
+	hash = fingerprint_add(hash, get_irn_opcode(node));
+	hash = fingerprint_add(hash, (uintptr_t)get_irn_mode(node));
+	hash = fingerprint_add(hash, get_irn_arity(node));
+	for (int i = -1, n = get_irn_arity(node); i < n; ++i) {
+		if (i < 0 && is_Block(node))
+			continue;
+		ir_node const *const pred = get_irn_n(node, i);
+		hash = fingerprint_add(hash, pred != NULL ? get_irn_idx(pred) + 1 : 0);
+	}
+	for (size_t i = 0; i < label_len; ++i) {
+		hash ^= (unsigned char)label[i];
+		hash *= UINT64_C(0x100000001B3);
+	}
+	/* 0 marks nodes missing from the last dump */
+	return hash != 0 ? hash : 1;
+}
+
+static void print_stream_idx(FILE *out, const ir_node *node)
+{
+	if (node != NULL) {
+		fprintf(out, " %u", get_irn_idx(node));
+	} else {
+		fputs(" -", out);
+	}
+}
+
+static void dump_stream_node(ir_node *node, void *env)
+{
+	stream_env_t  *const stream = (stream_env_t*)env;
+	unsigned const       idx    = get_irn_idx(node);
+	rbitset_set(stream->seen, idx);
+
+	/* The label is formatted once into memory, hashed and written from
+	 * there. Without a memory stream every node is dumped again. */
+	FILE  *const out       = stream->out;
+	FILE  *const label     = stream->label;
+	size_t       label_len = 0;
+	if (label != NULL) {
+		fseek(label, 0, SEEK_SET);
+		dump_node_label(label, node);
+		fflush(label);
+		label_len = (size_t)ftell(label);
+		uint64_t const fingerprint
+			= node_fingerprint(node, stream->label_buf, label_len);
+		if (stream->state[idx] == fingerprint)
+			return;
+		stream->state[idx] = fingerprint;
+	} else {
+		stream->state[idx] = 1;
+	}
+
+	fprintf(out, "n %u %s %s", idx, get_irn_opname(node),
+	        get_mode_name(get_irn_mode(node)));
+	print_stream_idx(out, is_Block(node) ? NULL : get_irn_n(node, -1));
+	int const arity = get_irn_arity(node);
+	fprintf(out, " %d", arity);
+	for (int i = 0; i < arity; ++i) {
+		print_stream_idx(out, get_irn_n(node, i));
+	}
+	fputc(' ', out);
+	if (label != NULL) {
+		fwrite(stream->label_buf, 1, label_len, out);
+	} else {
+		dump_node_label(out, node);
+	}
+	fputc('\n', out);
+}
+
+void dump_ir_graph_stream(ir_graph *graph, const char *suffix)
+{
+	const char *dump_name = get_irg_dump_name(graph);
+	if (!ir_should_dump(dump_name))
+		return;
+
+	add_dump_path();
+	add_string_escaped(dump_name);
+	obstack_grow(&obst, ".irstream", sizeof(".irstream"));
+
+	char *file_name = (char*)obstack_finish(&obst);
+	/* the first dump of a graph starts a new stream */
+	bool  full      = graph->dump_stream_state == NULL;
+	FILE *out       = fopen(file_name, full ? "wb" : "ab");
+	obstack_free(&obst, file_name);
+
+	if (out == NULL) {
+		fprintf(stderr, "Couldn't open '%s': %s\n", file_name, strerror(errno));
+		return;
+	}
+
+	unsigned const n_nodes = get_irg_last_idx(graph);
+	if (full) {
+		graph->dump_stream_state = NEW_ARR_FZ(uint64_t, n_nodes);
+	} else {
+		size_t const old_len = ARR_LEN(graph->dump_stream_state);
+		if (old_len < n_nodes) {
+			ARR_RESIZE(uint64_t, graph->dump_stream_state, n_nodes);
+			memset(&graph->dump_stream_state[old_len], 0,
+			       (n_nodes - old_len) * sizeof(uint64_t));
+		}
+	}
+
+	fprintf(out, "dump %u %s %s\n", graph->dump_nr++, full ? "full" : "delta",
+	        suffix != NULL ? suffix : "");
+
+	stream_env_t env;
+	env.out   = out;
+#ifndef _WIN32
+	env.label = open_memstream(&env.label_buf, &env.label_size);
+#else
+	env.label = NULL;
+#endif
+	env.state = graph->dump_stream_state;
+	env.seen  = rbitset_malloc(n_nodes);
+	ird_walk_graph(graph, NULL, dump_stream_node, &env);
+	if (env.label != NULL) {
+		fclose(env.label);
+		free(env.label_buf);
+	}
+
+	/* nodes dumped before but no longer reachable */
+	for (size_t i = 0, n = ARR_LEN(env.state); i < n; ++i) {
+		if (env.state[i] == 0 || (i < n_nodes && rbitset_is_set(env.seen, i)))
+			continue;
+		env.state[i] = 0;
+		fprintf(out, "d %zu\n", i);
+	}
+
+	free(env.seen);
+	fclose(out);
+}
+
+void free_irg_dump_stream(ir_graph *graph)
+{
+	if (graph->dump_stream_state != NULL) {
+		DEL_ARR_F(graph->dump_stream_state);
+		graph->dump_stream_state = NULL;
+	}
+}
+
 void dump_ir_graph(ir_graph *graph, const char *suffix)
 {
+	if (flags & ir_dump_flag_stream) {
+		dump_ir_graph_stream(graph, suffix);
+		return;
+	}
+
 	char buf[256];
 
 	snprintf(buf, sizeof(buf), "%s.vcg", suffix);
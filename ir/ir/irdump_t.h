@@ -37,4 +37,7 @@ void dump_vcg_infonames(FILE *out);
  * (plain text format) */
 void dump_irnode_to_file(FILE *out, const ir_node *node);
 
+/** Frees the node fingerprints kept for dump_ir_graph_stream(). */
+void free_irg_dump_stream(ir_graph *graph);
+
 #endif
@@ -16,43 +16,24 @@
 
 #include "bitset.h"
 #include "debug.h"
-#include "hashptr.h"
 #include "irdump_t.h"
 #include "iredgekinds.h"
-#include "iredgeset.h"
 #include "irgwalk.h"
 #include "irnode_t.h"
 #include "irnodemap.h"
 #include "iropt_t.h"
 #include "irprintf.h"
 #include "set.h"
+#include "util.h"
 
-#define DO_REHASH
-#define SCALAR_RETURN
-#define HashSet                   ir_edgeset_t
-#define HashSetIterator           ir_edgeset_iterator_t
-#define ValueType                 ir_edge_t*
-#define NullValue                 NULL
-#define DeletedValue              ((ir_edge_t*)-1)
-#define Hash(this,key)            (hash_ptr(key->src) ^ (key->pos * 40013))
-#define KeysEqual(this,key1,key2) ((key1->src) == (key2->src) && (key1->pos == key2->pos))
-#define SetRangeEmpty(ptr,size)   memset(ptr, 0, (size) * sizeof((ptr)[0]))
-
-#define hashset_init            ir_edgeset_init
-void ir_edgeset_init_size(ir_edgeset_t *self, size_t size);
-#define hashset_init_size       ir_edgeset_init_size
-#define hashset_destroy         ir_edgeset_destroy
-#define hashset_insert          ir_edgeset_insert
-#define hashset_remove          ir_edgeset_remove
-ir_edge_t *ir_edgeset_find(const ir_edgeset_t *self, const ir_edge_t* key);
-#define hashset_find            ir_edgeset_find
-size_t ir_edgeset_size(const ir_edgeset_t *self);
-#define hashset_size            ir_edgeset_size
-#define hashset_iterator_init   ir_edgeset_iterator_init
-#define hashset_iterator_next   ir_edgeset_iterator_next
-#define hashset_remove_iterator ir_edgeset_remove_iterator
-
-#include "hashset.c.h"
+/**
+ * The edges of the inputs of a node, indexed by input position + 1 so that
+ * the block input (-1) gets slot 0.
+ */
+typedef struct ir_edge_ins_t {
+	unsigned   n_slots;  /**< Number of slots in edges. */
+	ir_edge_t *edges[];  /**< The edges, NULL for positions without edge. */
+} ir_edge_ins_t;
 
 /**
  * A function that allows for setting an edge.
@@ -138,21 +119,75 @@ static inline long edge_get_id(const ir_edge_t *e)
 void edges_init_graph_kind(ir_graph *irg, ir_edge_kind_t kind)
 {
 	if (edges_activated_kind(irg, kind)) {
-		irg_edge_info_t *info   = get_irg_edge_info(irg, kind);
-		size_t           amount = get_irg_last_idx(irg) * 5 / 4;
+		irg_edge_info_t *info = get_irg_edge_info(irg, kind);
 
 		if (info->allocated) {
-			amount = ir_edgeset_size(&info->edges);
-			ir_edgeset_destroy(&info->edges);
+			DEL_ARR_F(info->ins);
 			obstack_free(&info->edges_obst, NULL);
 		}
 		obstack_init(&info->edges_obst);
 		INIT_LIST_HEAD(&info->free_edges);
-		ir_edgeset_init_size(&info->edges, amount);
+		info->ins = NEW_ARR_FZ(ir_edge_ins_t*, get_irg_last_idx(irg));
 		info->allocated = 1;
 	}
 }
 
+/**
+ * Returns the edge at position @p pos of @p src or NULL if there is none.
+ */
+static ir_edge_t *find_edge(const irg_edge_info_t *info, const ir_node *src,
+                            int pos)
+{
+	unsigned const idx = get_irn_idx(src);
+	if (idx >= ARR_LEN(info->ins))
+		return NULL;
+	ir_edge_ins_t const *const ins  = info->ins[idx];
+	unsigned             const slot = pos + 1;
+	if (ins == NULL || slot >= ins->n_slots)
+		return NULL;
+	ir_edge_t *const edge = ins->edges[slot];
+	/* the slots of a killed node may be seen by a node reusing its index */
+	if (edge == NULL || edge->src != src)
+		return NULL;
+	assert(edge->pos == pos);
+	return edge;
+}
+
+/**
+ * Returns the slot for the edge at position @p pos of @p src,
+ * making room for it if necessary.
+ */
+static ir_edge_t **get_edge_slot(irg_edge_info_t *info, const ir_node *src,
+                                 int pos)
+{
+	unsigned const idx   = get_irn_idx(src);
+	size_t   const n_ins = ARR_LEN(info->ins);
+	if (idx >= n_ins) {
+		size_t const new_n_ins = MAX(idx + 1, 2 * n_ins);
+		ARR_RESIZE(ir_edge_ins_t*, info->ins, new_n_ins);
+		memset(&info->ins[n_ins], 0, (new_n_ins - n_ins) * sizeof(*info->ins));
+	}
+
+	ir_edge_ins_t *ins  = info->ins[idx];
+	unsigned const slot = pos + 1;
+	if (ins == NULL || slot >= ins->n_slots) {
+		unsigned n_slots = MAX(slot + 1, (unsigned)get_irn_arity(src) + 1);
+		unsigned n_old   = 0;
+		if (ins != NULL) {
+			n_old   = ins->n_slots;
+			n_slots = MAX(n_slots, 2 * n_old);
+		}
+		size_t const   size    = sizeof(*ins) + n_slots * sizeof(ins->edges[0]);
+		ir_edge_ins_t *new_ins = (ir_edge_ins_t*)obstack_alloc(&info->edges_obst, size);
+		new_ins->n_slots = n_slots;
+		if (n_old > 0)
+			MEMCPY(new_ins->edges, ins->edges, n_old);
+		memset(&new_ins->edges[n_old], 0, (n_slots - n_old) * sizeof(ins->edges[0]));
+		info->ins[idx] = ins = new_ins;
+	}
+	return &ins->edges[slot];
+}
+
 /**
  * Change the out count
  *
@@ -198,12 +233,16 @@ void edges_dump_kind(ir_graph *irg, ir_edge_kind_t kind)
 	if (!edges_activated_kind(irg, kind))
 		return;
 
-	irg_edge_info_t       *info  = get_irg_edge_info(irg, kind);
-	ir_edgeset_t          *edges = &info->edges;
-	ir_edge_t             *e;
-	ir_edgeset_iterator_t  iter;
-	foreach_ir_edgeset(edges, e, iter) {
-		ir_printf("%+F %d\n", e->src, e->pos);
+	irg_edge_info_t *info = get_irg_edge_info(irg, kind);
+	for (size_t i = 0, n = ARR_LEN(info->ins); i < n; ++i) {
+		ir_edge_ins_t const *const ins = info->ins[i];
+		if (ins == NULL)
+			continue;
+		for (unsigned s = 0; s < ins->n_slots; ++s) {
+			ir_edge_t const *const e = ins->edges[s];
+			if (e != NULL && e->src != NULL)
+				ir_printf("%+F %d\n", e->src, e->pos);
+		}
 	}
 }
 
@@ -213,8 +252,9 @@ static void add_edge(ir_node *src, int pos, ir_node *tgt, ir_edge_kind_t kind,
 	if (tgt == NULL)
 		return;
 	assert(edges_activated_kind(irg, kind));
-	irg_edge_info_t *info  = get_irg_edge_info(irg, kind);
-	ir_edgeset_t    *edges = &info->edges;
+	irg_edge_info_t *info = get_irg_edge_info(irg, kind);
+	ir_edge_t      **slot = get_edge_slot(info, src, pos);
+	assert((*slot == NULL || (*slot)->src != src) && "edge already present");
 
 	irn_edge_info_t  *tgt_info = get_irn_edge_info(tgt, kind);
 	struct list_head *head     = &tgt_info->outs_head;
@@ -230,16 +270,11 @@ static void add_edge(ir_node *src, int pos, ir_node *tgt, ir_edge_kind_t kind,
 		list_del(&edge->list);
 	}
 
-	edge->src     = src;
-	edge->pos     = pos;
-#ifdef DEBUG_libfirm
-	edge->present = false;
-#endif
-
-	ir_edge_t *new_edge = ir_edgeset_insert(edges, edge);
-	assert(new_edge == edge);
+	edge->src = src;
+	edge->pos = pos;
+	*slot     = edge;
 
-	list_add(&new_edge->list, head);
+	list_add(&edge->list, head);
 	edge_change_cnt(tgt_info, +1);
 }
 
@@ -250,23 +285,15 @@ static void delete_edge(ir_node *src, int pos, ir_node *old_tgt,
 		return;
 	assert(edges_activated_kind(irg, kind));
 
-	irg_edge_info_t *info  = get_irg_edge_info(irg, kind);
-	ir_edgeset_t    *edges = &info->edges;
-
-	/* Initialize the edge template to search in the set. */
-	ir_edge_t templ;
-	templ.src = src;
-	templ.pos = pos;
-
-	/* search the edge in the set. */
-	ir_edge_t *edge = ir_edgeset_find(edges, &templ);
+	irg_edge_info_t *info = get_irg_edge_info(irg, kind);
+	ir_edge_t       *edge = find_edge(info, src, pos);
 
 	/* mark the edge invalid if it was found */
 	if (edge == NULL)
 		return;
 
 	list_del(&edge->list);
-	ir_edgeset_remove(edges, edge);
+	info->ins[get_irn_idx(src)]->edges[pos + 1] = NULL;
 	list_add(&edge->list, &info->free_edges);
 	edge->pos = -2;
 	edge->src = NULL;
@@ -289,8 +316,7 @@ static void edges_notify_edge_kind(ir_node *src, int pos, ir_node *tgt, ir_node
 	if (tgt == old_tgt)
 		return;
 
-	irg_edge_info_t *info  = get_irg_edge_info(irg, kind);
-	ir_edgeset_t    *edges = &info->edges;
+	irg_edge_info_t *info = get_irg_edge_info(irg, kind);
 
 	/* The target is not NULL and the old target differs
 	 * from the new target, the edge shall be moved (if the
@@ -301,12 +327,7 @@ static void edges_notify_edge_kind(ir_node *src, int pos, ir_node *tgt, ir_node
 	assert(head->next && head->prev &&
 	       "target list head must have been initialized");
 
-	/* Initialize the edge template to search in the set. */
-	ir_edge_t templ;
-	templ.src = src;
-	templ.pos = pos;
-
-	ir_edge_t *edge = ir_edgeset_find(edges, &templ);
+	ir_edge_t *edge = find_edge(info, src, pos);
 	assert(edge && "edge to redirect not found!");
 
 	list_move(&edge->list, head);
@@ -498,7 +519,8 @@ void edges_deactivate_kind(ir_graph *irg, ir_edge_kind_t kind)
 	info->activated = 0;
 	if (info->allocated) {
 		obstack_free(&info->edges_obst, NULL);
-		ir_edgeset_destroy(&info->edges);
+		DEL_ARR_F(info->ins);
+		info->ins       = NULL;
 		info->allocated = 0;
 	}
 	clear_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES);
@@ -549,26 +571,38 @@ void edges_reroute_except(ir_node *from, ir_node *to, ir_node *exception)
 
 static void verify_set_presence(ir_node *irn, void *data)
 {
-	build_walker *w     = (build_walker*)data;
-	ir_graph     *irg   = get_irn_irg(irn);
-	ir_edgeset_t *edges = &get_irg_edge_info(irg, w->kind)->edges;
+	build_walker          *w    = (build_walker*)data;
+	ir_graph              *irg  = get_irn_irg(irn);
+	irg_edge_info_t const *info = get_irg_edge_info(irg, w->kind);
 
 	foreach_tgt(irn, i, n, w->kind) {
-		ir_edge_t  templ = { .src = irn, .pos = i };
-		ir_edge_t *e     = ir_edgeset_find(edges, &templ);
-		ir_node   *dst   = get_n(irn, i, w->kind);
-		if (dst == NULL)
-			continue;
-		if (e != NULL) {
-#ifdef DEBUG_libfirm
-			e->present = true;
-#endif
-		} else {
+		ir_edge_t *e   = find_edge(info, irn, i);
+		ir_node   *dst = get_n(irn, i, w->kind);
+		if (dst == NULL) {
+			if (e != NULL) {
+				w->fine = false;
+				ir_fprintf(stderr, "Edge Verifier: edge(%ld) %+F,%d is superfluous\n", edge_get_id(e), irn, i);
+			}
+		} else if (e == NULL) {
 			w->fine = false;
 			ir_fprintf(stderr, "Edge Verifier: %+F,%d is missing\n",
 			           irn, i);
 		}
 	}
+
+	/* edges beyond the arity are superfluous, too */
+	unsigned const idx = get_irn_idx(irn);
+	if (idx < ARR_LEN(info->ins) && info->ins[idx] != NULL) {
+		int const first = edge_kind_info[w->kind].first_idx;
+		int const arity = edge_kind_info[w->kind].get_arity(irn);
+		for (int i = MAX(arity, first), n = (int)info->ins[idx]->n_slots - 1; i < n; ++i) {
+			ir_edge_t *e = find_edge(info, irn, i);
+			if (e != NULL) {
+				w->fine = false;
+				ir_fprintf(stderr, "Edge Verifier: edge(%ld) %+F,%d is superfluous\n", edge_get_id(e), irn, i);
+			}
+		}
+	}
 }
 
 static void verify_list_presence(ir_node *irn, void *data)
@@ -599,36 +633,12 @@ static void verify_list_presence(ir_node *irn, void *data)
 
 int edges_verify_kind(ir_graph *irg, ir_edge_kind_t kind)
 {
-	struct build_walker    w     = { .kind      = kind,
-	                                 .reachable = bitset_alloca(get_irg_last_idx(irg)),
-	                                 .fine      = true };
-
-#ifdef DEBUG_libfirm
-	ir_edgeset_t          *edges = &get_irg_edge_info(irg, kind)->edges;
-	ir_edge_t             *e;
-	ir_edgeset_iterator_t iter;
-	/* Clear the present bit in all edges available. */
-	foreach_ir_edgeset(edges, e, iter) {
-		e->present = false;
-	}
-#endif
+	struct build_walker w = { .kind      = kind,
+	                          .reachable = bitset_alloca(get_irg_last_idx(irg)),
+	                          .fine      = true };
 
 	irg_walk_graph(irg, verify_set_presence, verify_list_presence, &w);
 
-#ifdef DEBUG_libfirm
-	/*
-	 * Dump all edges which are not invalid and not present.
-	 * These edges are superfluous and their presence in the
-	 * edge set is wrong.
-	 */
-	foreach_ir_edgeset(edges, e, iter) {
-		if (! e->present && bitset_is_set(w.reachable, get_irn_idx(e->src))) {
-			w.fine = false;
-			ir_fprintf(stderr, "Edge Verifier: edge(%ld) %+F,%d is superfluous\n", edge_get_id(e), e->src, e->pos);
-		}
-	}
-#endif
-
 	return w.fine;
 }
 
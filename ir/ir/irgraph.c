@@ -13,19 +13,21 @@
 #include "array.h"
 #include "irbackedge_t.h"
 #include "ircons_t.h"
+#include "irdump_t.h"
 #include "iredges_t.h"
 #include "irflag_t.h"
 #include "irgmod.h"
 #include "irgopt.h"
 #include "irgwalk.h"
 #include "irhooks.h"
-#include "irmemory.h"
+#include "irmemory_t.h"
 #include "irnode_t.h"
 #include "iropt_t.h"
 #include "iroptimize.h"
 #include "irouts.h"
 #include "irprog_t.h"
 #include "irtools.h"
+#include "irverify_t.h"
 #include "type_t.h"
 #include "util.h"
 #include "xmalloc.h"
@@ -275,6 +277,9 @@ void free_ir_graph(ir_graph *irg)
 	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_NONE);
 
 	free_irg_outs(irg);
+	free_irg_points_to(irg);
+	free_irg_verify_touched(irg);
+	free_irg_dump_stream(irg);
 	del_identities(irg);
 	if (irg->ent) {
 		set_entity_irg(irg->ent, NULL);  /* not set in const code irg */
@@ -595,6 +600,7 @@ void assure_irg_properties(ir_graph *irg, ir_graph_properties_t props)
 		{ IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO,      assure_loopinfo },
 		{ IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE,  assure_irg_entity_usage_computed },
 		{ IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE_FRONTIERS, ir_compute_dominance_frontiers },
+		{ IR_GRAPH_PROPERTY_CONSISTENT_ALIAS_INFO,    assure_irg_alias_info },
 	};
 	for (size_t i = 0; i < ARRAY_SIZE(property_functions); ++i) {
 		ir_graph_properties_t missing = props & ~irg->properties;
@@ -616,4 +622,6 @@ void confirm_irg_properties(ir_graph *irg, ir_graph_properties_t props)
 		set_irp_globals_entity_usage_state(ir_entity_usage_not_computed);
 	if (!(props & IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE_FRONTIERS))
 		ir_free_dominance_frontiers(irg);
+	if (!(props & IR_GRAPH_PROPERTY_CONSISTENT_ALIAS_INFO))
+		free_irg_alias_info(irg);
 }
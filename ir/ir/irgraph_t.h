@@ -16,7 +16,6 @@
 #include "entity_t.h"
 #include "firm_types.h"
 #include "iredgekinds.h"
-#include "iredgeset.h"
 #include "irloop.h"
 #include "irnodemap.h"
 #include "irprog.h"
@@ -24,6 +23,7 @@
 #include "obst.h"
 #include "pset.h"
 #include "type_t.h"
+#include <stdint.h>
 
 #define get_irg_start_block(irg)              get_irg_start_block_(irg)
 #define set_irg_start_block(irg, node)        set_irg_start_block_(irg, node)
@@ -73,7 +73,8 @@
  * Edge info to put into an irg.
  */
 typedef struct irg_edge_info_t {
-	ir_edgeset_t     edges;          /**< A set containing all edges of the current graph. */
+	struct ir_edge_ins_t **ins;      /**< Edges of the inputs of each node,
+	                                      indexed by node index. */
 	struct list_head free_edges;     /**< list of all free edges. */
 	struct obstack   edges_obst;     /**< Obstack, where edges are allocated on. */
 	unsigned         allocated : 1;  /**< Set if edges are allocated on the obstack. */
@@ -99,6 +100,9 @@ typedef struct ir_vrp_info {
 	struct obstack    obst;
 } ir_vrp_info;
 
+/** Alias analysis cache, see irmemory.c */
+typedef struct ir_alias_info ir_alias_info;
+
 /**
  * An ir_graph represents the code of a function as a graph of nodes.
  */
@@ -125,10 +129,13 @@ struct ir_graph {
 	ir_visited_t     self_visited;  /**< Visited flag of the irg */
 	ir_node        **idx_irn_map;   /**< Map of node indexes to nodes. */
 	size_t           index;         /**< a unique number for each graph */
+	size_t           irp_index;     /**< position in the graph list of irp */
 	/** A void* field to link any information to the graph. */
 	void            *link;
 	void            *be_data;       /**< backend can put in private data here */
 	unsigned short   dump_nr;       /**< number of graph dumps */
+	/** node fingerprints of the last dump_ir_graph_stream() */
+	uint64_t        *dump_stream_state;
 
 	unsigned char    mem_disambig_opt;
 
@@ -145,6 +152,12 @@ struct ir_graph {
 	ir_vrp_info         vrp;         /**< vrp info */
 	ir_loop            *loop;        /**< The outermost loop for this graph. */
 	ir_dom_front_info_t domfront;    /**< dominance frontier analysis data */
+	ir_alias_info      *alias_info;  /**< memoized alias queries */
+	int                *points_to;   /**< points-to class per node index */
+	unsigned           *verify_touched; /**< indices of nodes created or
+	                                         replaced since the last sampled
+	                                         verification */
+	unsigned            verify_count;   /**< number of sampled verifications */
 	irg_edges_info_t    edge_info;   /**< edge info for automatic outs */
 	ir_graph          **callers;     /**< Callgraph: list of callers. */
 	unsigned           *caller_isbe; /**< Callgraph: bitset if backedge info is
@@ -27,75 +27,27 @@
 #include <stdlib.h>
 
 /**
- * specialized version of irg_walk_2, called if only pre callback exists
+ * A node on the explicit stack of irg_walk_2() with the position of the next
+ * predecessor to visit: WALK_BLOCK for the block of the node, WALK_INPUTS
+ * before the inputs, and the number of inputs left otherwise.
  */
-static void irg_walk_2_pre(ir_node *node, irg_walk_func *pre, void *env)
-{
-	ir_graph    *irg     = get_irn_irg(node);
-	ir_visited_t visited = irg->visited;
-
-	set_irn_visited(node, visited);
+typedef struct walk_frame_t {
+	ir_node *node;
+	int      pos;
+} walk_frame_t;
 
-	pre(node, env);
-
-	if (!is_Block(node)) {
-		ir_node *pred = get_nodes_block(node);
-		if (pred->visited < visited)
-			irg_walk_2_pre(pred, pre, env);
-	}
-	foreach_irn_in_r(node, i, pred) {
-		if (pred->visited < visited)
-			irg_walk_2_pre(pred, pre, env);
-	}
-}
+enum { WALK_BLOCK = -2, WALK_INPUTS = -1 };
 
-/**
- * specialized version of irg_walk_2, called if only post callback exists
- */
-static void irg_walk_2_post(ir_node *node, irg_walk_func *post, void *env)
+static walk_frame_t *walk_enter(walk_frame_t *stack, ir_node *node,
+                                ir_visited_t visited, irg_walk_func *pre,
+                                void *env)
 {
-	ir_graph    *irg     = get_irn_irg(node);
-	ir_visited_t visited = irg->visited;
-
 	set_irn_visited(node, visited);
-
-	if (!is_Block(node)) {
-		ir_node *pred = get_nodes_block(node);
-		if (pred->visited < visited)
-			irg_walk_2_post(pred, post, env);
-	}
-	foreach_irn_in_r(node, i, pred) {
-		if (pred->visited < visited)
-			irg_walk_2_post(pred, post, env);
-	}
-
-	post(node, env);
-}
-
-/**
- * specialized version of irg_walk_2, called if pre and post callbacks exist
- */
-static void irg_walk_2_both(ir_node *node, irg_walk_func *pre,
-                                irg_walk_func *post, void *env)
-{
-	ir_graph    *irg     = get_irn_irg(node);
-	ir_visited_t visited = irg->visited;
-
-	set_irn_visited(node, visited);
-
-	pre(node, env);
-
-	if (!is_Block(node)) {
-		ir_node *pred = get_nodes_block(node);
-		if (pred->visited < visited)
-			irg_walk_2_both(pred, pre, post, env);
-	}
-	foreach_irn_in_r(node, i, pred) {
-		if (pred->visited < visited)
-			irg_walk_2_both(pred, pre, post, env);
-	}
-
-	post(node, env);
+	if (pre != NULL)
+		pre(node, env);
+	walk_frame_t const frame = { node, WALK_BLOCK };
+	ARR_APP1(walk_frame_t, stack, frame);
+	return stack;
 }
 
 void irg_walk_2(ir_node *node, irg_walk_func *pre, irg_walk_func *post,
@@ -104,9 +56,37 @@ void irg_walk_2(ir_node *node, irg_walk_func *pre, irg_walk_func *post,
 	if (irn_visited(node))
 		return;
 
-	if      (post == NULL) irg_walk_2_pre (node, pre, env);
-	else if (pre  == NULL) irg_walk_2_post(node, post, env);
-	else                   irg_walk_2_both(node, pre, post, env);
+	/* The walk keeps its path on an explicit stack, the depth of the graph is
+	 * not limited by the C stack. Predecessors are visited in the same order
+	 * as by a recursive walk: the block first, then the inputs from last to
+	 * first, each read just before it is visited. */
+	ir_visited_t const visited = get_irg_visited(get_irn_irg(node));
+	walk_frame_t      *stack   = NEW_ARR_F(walk_frame_t, 0);
+	stack = walk_enter(stack, node, visited, pre, env);
+	while (ARR_LEN(stack) > 0) {
+		walk_frame_t *const frame = &stack[ARR_LEN(stack) - 1];
+		ir_node      *const irn   = frame->node;
+		ir_node            *pred;
+		if (frame->pos == WALK_BLOCK) {
+			frame->pos = WALK_INPUTS;
+			if (is_Block(irn))
+				continue;
+			pred = get_nodes_block(irn);
+		} else {
+			if (frame->pos == WALK_INPUTS)
+				frame->pos = get_irn_arity(irn);
+			if (frame->pos == 0) {
+				ARR_SHRINKLEN(stack, ARR_LEN(stack) - 1);
+				if (post != NULL)
+					post(irn, env);
+				continue;
+			}
+			pred = get_irn_n(irn, --frame->pos);
+		}
+		if (pred->visited < visited)
+			stack = walk_enter(stack, pred, visited, pre, env);
+	}
+	DEL_ARR_F(stack);
 }
 
 void irg_walk_core(ir_node *node, irg_walk_func *pre, irg_walk_func *post,
@@ -304,28 +284,55 @@ static ir_node *get_cf_op(ir_node *n)
 	return n;
 }
 
+/**
+ * A block on the explicit stack of irg_block_walk_2() with the number of
+ * control flow predecessors left to visit.
+ */
+typedef struct block_walk_frame_t {
+	ir_node *block;
+	int      pos;
+} block_walk_frame_t;
+
+static block_walk_frame_t *block_walk_enter(block_walk_frame_t *stack,
+                                            ir_node *block, irg_walk_func *pre,
+                                            void *env)
+{
+	mark_Block_block_visited(block);
+	if (pre != NULL)
+		pre(block, env);
+	block_walk_frame_t const frame = { block, get_Block_n_cfgpreds(block) };
+	ARR_APP1(block_walk_frame_t, stack, frame);
+	return stack;
+}
+
 static void irg_block_walk_2(ir_node *node, irg_walk_func *pre,
                              irg_walk_func *post, void *env)
 {
 	if (Block_block_visited(node))
 		return;
-	mark_Block_block_visited(node);
 
-	if (pre != NULL)
-		pre(node, env);
+	/* walk with an explicit stack in the order of a recursive walk */
+	block_walk_frame_t *stack = NEW_ARR_F(block_walk_frame_t, 0);
+	stack = block_walk_enter(stack, node, pre, env);
+	while (ARR_LEN(stack) > 0) {
+		block_walk_frame_t *const frame = &stack[ARR_LEN(stack) - 1];
+		ir_node            *const block = frame->block;
+		if (frame->pos == 0) {
+			ARR_SHRINKLEN(stack, ARR_LEN(stack) - 1);
+			if (post != NULL)
+				post(block, env);
+			continue;
+		}
 
-	for (int i = get_Block_n_cfgpreds(node); i-- > 0; ) {
 		/* find the corresponding predecessor block. */
-		ir_node *pred_cfop  = get_cf_op(get_Block_cfgpred(node, i));
+		ir_node *const pred_cfop = get_cf_op(get_Block_cfgpred(block, --frame->pos));
 		if (is_Bad(pred_cfop))
 			continue;
-		ir_node *pred_block = get_nodes_block(pred_cfop);
-		/* recursion */
-		irg_block_walk_2(pred_block, pre, post, env);
+		ir_node *const pred_block = get_nodes_block(pred_cfop);
+		if (!Block_block_visited(pred_block))
+			stack = block_walk_enter(stack, pred_block, pre, env);
 	}
-
-	if (post != NULL)
-		post(node, env);
+	DEL_ARR_F(stack);
 }
 
 void irg_block_walk(ir_node *node, irg_walk_func *pre, irg_walk_func *post,
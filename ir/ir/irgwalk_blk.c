@@ -248,57 +248,95 @@ static void traverse_dom_blocks_top_down(ir_graph *irg, blk_collect_data_t* blks
 }
 
 /**
- * walks over the graph and collects all blocks and all block entries
+ * A node on the explicit stack of collect_walk() with the number of inputs
+ * left to visit, or -1 if the block of the node is still to be visited.
  */
-static void collect_walk(ir_node *node, blk_collect_data_t *env)
+typedef struct collect_frame_t {
+	ir_node *node;
+	int      pos;
+	bool     descended; /**< the walk descended into the input at pos */
+} collect_frame_t;
+
+static collect_frame_t *collect_enter(collect_frame_t *stack, ir_node *node)
 {
 	mark_irn_visited(node);
+	int const pos = is_Block(node) ? get_irn_arity(node) : -1;
+	collect_frame_t const frame = { node, pos, false };
+	ARR_APP1(collect_frame_t, stack, frame);
+	return stack;
+}
 
+/**
+ * Records pred, an input of node the walk descended into, as a block entry if
+ * it is one.
+ */
+static void collect_entry(ir_node *node, ir_node *pred,
+                          blk_collect_data_t *env)
+{
 	if (is_Block(node)) {
-		/* predecessors of a block are control flow nodes */
-		foreach_irn_in_r(node, i, pred) {
-			if (irn_visited(pred))
-				continue;
-
-			ir_node *blk = get_nodes_block(pred);
-			collect_walk(pred, env);
-
-			/* control flow predecessors are always block inputs */
-			block_entry_t *entry = block_find_entry(blk, env);
-			ARR_APP1(ir_node *, entry->entry_list, pred);
-		}
-
-		/* it's a block, put it into the block list, except for the end block
-		 * which we append in the main loop. This avoids it being placed
-		 * elsewhere if the graph contains endless loops. */
-		if (node != get_irg_end_block(get_irn_irg(node)))
-			ARR_APP1(ir_node *, env->blk_list, node);
-	} else {
-		ir_node *block = get_nodes_block(node);
-		if (!irn_visited(block))
-			collect_walk(block, env);
-
-		bool is_phi = is_Phi(node);
-		foreach_irn_in_r(node, i, pred) {
-			if (irn_visited(pred))
-				continue;
-
-			collect_walk(pred, env);
+		/* predecessors of a block are control flow nodes, which are always
+		 * block inputs */
+		block_entry_t *entry = block_find_entry(get_nodes_block(pred), env);
+		ARR_APP1(ir_node *, entry->entry_list, pred);
+		return;
+	}
 
-			/* BEWARE: predecessors of End nodes might be blocks */
-			if (is_Block(pred))
-				continue;
+	/* BEWARE: predecessors of End nodes might be blocks */
+	if (is_Block(pred))
+		return;
 
-			ir_node *blk = get_nodes_block(pred);
+	/* Note that Phi predecessors are always block entries
+	 * because Phi edges are always "outside" a block */
+	ir_node *blk = get_nodes_block(pred);
+	if (get_nodes_block(node) != blk || is_Phi(node)) {
+		block_entry_t *entry = block_find_entry(blk, env);
+		ARR_APP1(ir_node *, entry->entry_list, pred);
+	}
+}
 
-			/* Note that Phi predecessors are always block entries
-			 * because Phi edges are always "outside" a block */
-			if (block != blk || is_phi) {
-				block_entry_t *entry = block_find_entry(blk, env);
-				ARR_APP1(ir_node *, entry->entry_list, pred);
-			}
+/**
+ * walks over the graph and collects all blocks and all block entries
+ */
+static void collect_walk(ir_node *node, blk_collect_data_t *env)
+{
+	/* the walk keeps its path on an explicit stack in the order of a
+	 * recursive walk: the block of a node first, then its inputs from last
+	 * to first */
+	ir_node         *const end_block = get_irg_end_block(get_irn_irg(node));
+	collect_frame_t       *stack     = NEW_ARR_F(collect_frame_t, 0);
+	stack = collect_enter(stack, node);
+	while (ARR_LEN(stack) > 0) {
+		collect_frame_t *const frame = &stack[ARR_LEN(stack) - 1];
+		ir_node         *const irn   = frame->node;
+		if (frame->pos < 0) {
+			frame->pos = get_irn_arity(irn);
+			ir_node *const block = get_nodes_block(irn);
+			if (!irn_visited(block))
+				stack = collect_enter(stack, block);
+			continue;
+		}
+		if (frame->descended) {
+			frame->descended = false;
+			collect_entry(irn, get_irn_n(irn, frame->pos), env);
+			continue;
 		}
+		if (frame->pos == 0) {
+			ARR_SHRINKLEN(stack, ARR_LEN(stack) - 1);
+			/* it's a block, put it into the block list, except for the end
+			 * block which we append in the main loop. This avoids it being
+			 * placed elsewhere if the graph contains endless loops. */
+			if (is_Block(irn) && irn != end_block)
+				ARR_APP1(ir_node *, env->blk_list, irn);
+			continue;
+		}
+
+		ir_node *const pred = get_irn_n(irn, --frame->pos);
+		if (irn_visited(pred))
+			continue;
+		frame->descended = true;
+		stack = collect_enter(stack, pred);
 	}
+	DEL_ARR_F(stack);
 }
 
 /**
@@ -1955,7 +1955,12 @@ int read_preds(read_env_t *env)
 	return obstack_object_size(&env->preds_obst) / sizeof(ir_node*);
 }
 
-static void read_preds_delayed(read_env_t *env, ir_node *node)
+/**
+ * Reads a list of predecessors which are resolved after the whole graph has
+ * been read.  The caller creates the node with the returned number of
+ * (NULL) predecessors and sets the node field.
+ */
+static delayed_pred_t *read_preds_delayed(read_env_t *env)
 {
 	expect_list_begin(env);
 	assert(obstack_object_size(&env->preds_obst) == 0);
@@ -1967,10 +1972,11 @@ static void read_preds_delayed(read_env_t *env, ir_node *node)
 		++n_preds;
 	}
 	delayed_pred_t *d = (delayed_pred_t*) obstack_finish(&env->preds_obst);
-	d->node    = node;
+	d->node    = NULL;
 	d->n_preds = n_preds;
 
 	ARR_APP1(const delayed_pred_t*, env->delayed_preds, d);
+	return d;
 }
 
 static ir_node *read_ASM(read_env_t *env)
@@ -2019,33 +2025,39 @@ static ir_node *read_Phi(read_env_t *env)
 {
 	ir_node   *block = read_node_ref(env);
 	ir_mode   *mode  = read_mode_ref(env);
-	const bool loop  = read_loop(env);
-	ir_node   *res   = loop ? new_r_Phi_loop(block, 0, NULL)
-	                        : new_r_Phi(block, 0, NULL, mode);
-	read_preds_delayed(env, res);
+	const bool      loop  = read_loop(env);
+	delayed_pred_t *preds = read_preds_delayed(env);
+	ir_node       **in    = ALLOCANZ(ir_node*, preds->n_preds);
+	ir_node        *res   = loop ? new_r_Phi_loop(block, preds->n_preds, in)
+	                             : new_r_Phi(block, preds->n_preds, in, mode);
+	preds->node = res;
 	return res;
 }
 
 static ir_node *read_Block(read_env_t *env)
 {
-	ir_node *res = new_r_Block(env->irg, 0, NULL);
-	read_preds_delayed(env, res);
+	delayed_pred_t *preds = read_preds_delayed(env);
+	ir_node       **in    = ALLOCANZ(ir_node*, preds->n_preds);
+	ir_node        *res   = new_r_Block(env->irg, preds->n_preds, in);
+	preds->node = res;
 	return res;
 }
 
 static ir_node *read_labeled_Block(read_env_t *env)
 {
-	ir_node   *res    = new_r_Block(env->irg, 0, NULL);
-	ir_entity *entity = read_entity_ref(env);
-	read_preds_delayed(env, res);
+	ir_entity      *entity = read_entity_ref(env);
+	delayed_pred_t *preds  = read_preds_delayed(env);
+	ir_node       **in     = ALLOCANZ(ir_node*, preds->n_preds);
+	ir_node        *res    = new_r_Block(env->irg, preds->n_preds, in);
 	set_Block_entity(res, entity);
+	preds->node = res;
 	return res;
 }
 
 static ir_node *read_Anchor(read_env_t *env)
 {
 	ir_node *res = new_r_Anchor(env->irg);
-	read_preds_delayed(env, res);
+	read_preds_delayed(env)->node = res;
 	return res;
 }
 
@@ -2102,7 +2114,8 @@ static void read_graph(read_env_t *env, ir_graph *irg)
 		read_node(env);
 	}
 
-	/* resolve delayed preds */
+	/* resolve delayed preds, the nodes already have the right arity except
+	 * for the Anchor */
 	for (size_t i = 0, n = ARR_LEN(env->delayed_preds); i < n; ++i) {
 		const delayed_pred_t *dp  = env->delayed_preds[i];
 		ir_node             **ins = ALLOCAN(ir_node*, dp->n_preds);
@@ -2112,17 +2125,19 @@ static void read_graph(read_env_t *env, ir_graph *irg)
 			if (pred == NULL) {
 				parse_error(env, "predecessor %ld of a node not defined\n",
 				            pred_nr);
-				goto next_delayed_pred;
+				pred = new_r_Bad(irg, mode_ANY);
 			}
 			ins[i] = pred;
 		}
-		set_irn_in(dp->node, dp->n_preds, ins);
 		if (is_Anchor(dp->node)) {
+			set_irn_in(dp->node, dp->n_preds, ins);
 			foreach_irn_in(get_irg_anchor(irg), a, old) {
 				exchange(old, ins[a]);
 			}
+		} else {
+			for (int i = 0; i < dp->n_preds; ++i)
+				set_irn_n(dp->node, i, ins[i]);
 		}
-next_delayed_pred: ;
 	}
 	DEL_ARR_F(env->delayed_preds);
 	env->delayed_preds = NULL;
@@ -2137,8 +2152,9 @@ static ir_graph *read_irg(read_env_t *env)
 	set_irg_frame_type(irg, frame);
 	// Free the old frame type in order to retain idempotency
 	free_type(old_frame);
+	irg_begin_bulk_cons(irg);
 	read_graph(env, irg);
-	irg_finalize_cons(irg);
+	irg_finalize_bulk_cons(irg);
 	return irg;
 }
 
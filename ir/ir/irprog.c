@@ -18,6 +18,8 @@
 #include "irmemory.h"
 #include "irop_t.h"
 #include "obst.h"
+#include "type_t.h"
+#include <stdint.h>
 
 /** The initial name of the irp program. */
 #define INITAL_PROG_NAME "no_name_set"
@@ -36,8 +38,10 @@ static ir_prog *new_incomplete_ir_prog(void)
 {
 	ir_prog *res = XMALLOCZ(ir_prog);
 
-	res->graphs         = NEW_ARR_F(ir_graph *, 0);
-	res->types          = NEW_ARR_F(ir_type *, 0);
+	res->graphs              = NEW_ARR_F(ir_graph *, 0);
+	res->first_removed_graph = SIZE_MAX;
+	res->types               = NEW_ARR_F(ir_type *, 0);
+	res->first_removed_type  = SIZE_MAX;
 	res->global_asms    = NEW_ARR_F(ident *, 0);
 	res->last_label_nr  = 1;  /* 0 is reserved as non-label */
 	res->max_irg_idx    = 0;
@@ -94,6 +98,8 @@ void free_ir_prog(void)
 	if (irp == NULL)
 		return;
 
+	free_irp_points_to();
+
 	/* must iterate backwards here */
 	foreach_irp_irg_r(i, irg) {
 		free_ir_graph(irg);
@@ -166,26 +172,48 @@ void add_irp_irg(ir_graph *irg)
 {
 	assert(irg != NULL);
 	assert(irp && irp->graphs);
+	irg->irp_index = ARR_LEN(irp->graphs);
 	ARR_APP1(ir_graph *, irp->graphs, irg);
 }
 
 void remove_irp_irg(ir_graph *irg)
 {
-	size_t i, l;
-
 	assert(irg);
-	l = ARR_LEN(irp->graphs);
-	for (i = 0; i < l; ++i) {
-		if (irp->graphs[i] == irg) {
-			for (; i < l - 1; ++i) {
-				irp->graphs[i] = irp->graphs[i+1];
-			}
-			ARR_SETLEN(ir_graph*, irp->graphs, l - 1);
-			break;
-		}
+	size_t const index = irg->irp_index;
+	size_t const n     = ARR_LEN(irp->graphs);
+	if (index >= n || irp->graphs[index] != irg)
+		return;
+
+	/* leave a gap which is closed lazily to keep the order */
+	if (index == n - 1 && irp->n_removed_graphs == 0) {
+		ARR_SETLEN(ir_graph*, irp->graphs, n - 1);
+	} else {
+		irp->graphs[index] = NULL;
+		++irp->n_removed_graphs;
+		if (index < irp->first_removed_graph)
+			irp->first_removed_graph = index;
 	}
 }
 
+void compact_irp_irgs(void)
+{
+	if (irp->n_removed_graphs == 0)
+		return;
+
+	ir_graph **const graphs = irp->graphs;
+	size_t           n      = irp->first_removed_graph;
+	for (size_t i = n + 1, n_graphs = ARR_LEN(graphs); i < n_graphs; ++i) {
+		ir_graph *const irg = graphs[i];
+		if (irg == NULL)
+			continue;
+		irg->irp_index = n;
+		graphs[n++]    = irg;
+	}
+	ARR_SETLEN(ir_graph*, irp->graphs, n);
+	irp->n_removed_graphs    = 0;
+	irp->first_removed_graph = SIZE_MAX;
+}
+
 size_t (get_irp_n_irgs)(void)
 {
 	return get_irp_n_irgs_();
@@ -204,32 +232,56 @@ size_t get_irp_last_idx(void)
 void set_irp_irg(size_t pos, ir_graph *irg)
 {
 	assert(irp && irg);
-	assert(pos < ARR_LEN(irp->graphs));
+	assert(pos < get_irp_n_irgs());
+	compact_irp_irgs();
 	irp->graphs[pos] = irg;
+	irg->irp_index   = pos;
 }
 
 void add_irp_type(ir_type *typ)
 {
 	assert(typ != NULL);
 	assert(irp);
+	typ->irp_index = ARR_LEN(irp->types);
 	ARR_APP1(ir_type *, irp->types, typ);
 }
 
 void remove_irp_type(ir_type *typ)
 {
-	size_t i, l;
 	assert(typ);
+	size_t const index = typ->irp_index;
+	size_t const n     = ARR_LEN(irp->types);
+	if (index >= n || irp->types[index] != typ)
+		return;
+
+	/* leave a gap which is closed lazily to keep the order */
+	if (index == n - 1 && irp->n_removed_types == 0) {
+		ARR_SETLEN(ir_type*, irp->types, n - 1);
+	} else {
+		irp->types[index] = NULL;
+		++irp->n_removed_types;
+		if (index < irp->first_removed_type)
+			irp->first_removed_type = index;
+	}
+}
+
+void compact_irp_types(void)
+{
+	if (irp->n_removed_types == 0)
+		return;
 
-	l = ARR_LEN(irp->types);
-	for (i = 0; i < l; ++i) {
-		if (irp->types[i] == typ) {
-			for (; i < l - 1; ++i) {
-				irp->types[i] = irp->types[i+1];
-			}
-			ARR_SETLEN(ir_type *, irp->types, l - 1);
-			break;
-		}
+	ir_type **const types = irp->types;
+	size_t          n     = irp->first_removed_type;
+	for (size_t i = n + 1, n_types = ARR_LEN(types); i < n_types; ++i) {
+		ir_type *const type = types[i];
+		if (type == NULL)
+			continue;
+		type->irp_index = n;
+		types[n++]      = type;
 	}
+	ARR_SETLEN(ir_type*, irp->types, n);
+	irp->n_removed_types    = 0;
+	irp->first_removed_type = SIZE_MAX;
 }
 
 size_t (get_irp_n_types) (void)
@@ -245,8 +297,10 @@ ir_type *(get_irp_type) (size_t pos)
 void set_irp_type(size_t pos, ir_type *typ)
 {
 	assert(irp && typ);
-	assert(pos < ARR_LEN((irp)->types));
+	assert(pos < get_irp_n_types());
+	compact_irp_types();
 	irp->types[pos] = typ;
+	typ->irp_index  = pos;
 }
 
 void set_irp_prog_name(ident *name)
@@ -42,14 +42,24 @@ struct ir_prog {
 	ident     *name;                /**< A file name or the like. */
 	ir_graph  *main_irg;            /**< The entry point to the compiled program
 	                                     or NULL if no point exists. */
-	ir_graph **graphs;              /**< A list of all graphs in the ir. */
+	ir_graph **graphs;              /**< A list of all graphs in the ir.
+	                                     Removed graphs are NULL until the
+	                                     list is compacted. */
+	size_t     n_removed_graphs;    /**< Number of removed graphs in graphs. */
+	size_t     first_removed_graph; /**< Index of the first removed graph or
+	                                     SIZE_MAX. */
 	pmap      *globals;             /**< Map identifiers to global entities. */
 	/** This graph holds nodes for global entity initialization expressions.
 	 * It is not a function. */
 	ir_graph  *const_code_irg;
 	ir_entity *unknown_entity;      /**< unique 'unknown'-entity */
 	ir_type   *segment_types[IR_SEGMENT_LAST+1];
-	ir_type  **types;               /**< A list of all types in the ir. */
+	ir_type  **types;               /**< A list of all types in the ir.
+	                                     Removed types are NULL until the
+	                                     list is compacted. */
+	size_t     n_removed_types;     /**< Number of removed types in types. */
+	size_t     first_removed_type;  /**< Index of the first removed type or
+	                                     SIZE_MAX. */
 	ir_type   *code_type;           /**< unique 'code'-type */
 	ir_type   *unknown_type;        /**< unique 'unknown'-type */
 	ir_type   *dummy_owner;         /**< owner for internal entities */
@@ -93,25 +103,36 @@ static inline ir_type *get_tls_type_(void)
 	return get_segment_type_(IR_SEGMENT_THREAD_LOCAL);
 }
 
+/** Closes the gaps left by removed graphs in the list of graphs. */
+void compact_irp_irgs(void);
+
+/** Closes the gaps left by removed types in the list of types. */
+void compact_irp_types(void);
+
 static inline size_t get_irp_n_irgs_(void)
 {
-	return ARR_LEN(irp->graphs);
+	return ARR_LEN(irp->graphs) - irp->n_removed_graphs;
 }
 
 static inline ir_graph *get_irp_irg_(size_t pos)
 {
-	assert(pos < ARR_LEN(irp->graphs));
+	assert(pos < get_irp_n_irgs_());
+	/* positions in front of the first removed graph are still valid */
+	if (pos >= irp->first_removed_graph)
+		compact_irp_irgs();
 	return irp->graphs[pos];
 }
 
 static inline size_t get_irp_n_types_(void)
 {
-	return ARR_LEN(irp->types);
+	return ARR_LEN(irp->types) - irp->n_removed_types;
 }
 
 static inline ir_type *get_irp_type_(size_t pos)
 {
-	assert(pos < ARR_LEN(irp->types));
+	assert(pos < get_irp_n_types_());
+	if (pos >= irp->first_removed_type)
+		compact_irp_types();
 	/* Don't set the skip_tid result so that no double entries are generated. */
 	return irp->types[pos];
 }
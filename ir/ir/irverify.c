@@ -11,6 +11,7 @@
  */
 #include "irverify_t.h"
 
+#include "array.h"
 #include "ircons.h"
 #include "irdom_t.h"
 #include "irdump.h"
@@ -18,12 +19,13 @@
 #include "irflag_t.h"
 #include "irgraph_t.h"
 #include "irgwalk.h"
+#include "irhooks.h"
 #include "irnode_t.h"
 #include "irnodeset.h"
 #include "irop_t.h"
 #include "irouts.h"
 #include "irprintf.h"
-#include "irprog.h"
+#include "irprog_t.h"
 
 static void warn(const ir_node *n, const char *format, ...)
 {
@@ -1295,13 +1297,164 @@ int irg_verify(ir_graph *irg)
 
 void irg_assert_verify(ir_graph *irg)
 {
-	bool fine = irg_verify(irg);
+	bool fine = irg_verify_sampled(irg);
 	if (!fine) {
 		dump_ir_graph(irg, "assert");
 		abort();
 	}
 }
 
+static unsigned     sample_period;
+static hook_entry_t sample_hooks[2];
+
+static void record_touched(ir_node *node)
+{
+	ir_graph *irg = get_irn_irg(node);
+	/* the next check is a full one anyway */
+	if (irg->verify_count % sample_period == 0)
+		return;
+	if (irg->verify_touched == NULL) {
+		irg->verify_touched = NEW_ARR_F(unsigned, 0);
+	} else if (ARR_LEN(irg->verify_touched) >= get_irg_last_idx(irg) / 2) {
+		/* Without checks the list would grow forever. A partial check of
+		 * that many nodes is no cheaper than a full one, so drop the list and
+		 * check fully next time. */
+		free_irg_verify_touched(irg);
+		irg->verify_count = 0;
+		return;
+	}
+	ARR_APP1(unsigned, irg->verify_touched, get_irn_idx(node));
+}
+
+static void sample_new_node(void *ctx, ir_node *node)
+{
+	(void)ctx;
+	record_touched(node);
+}
+
+static void sample_replace(void *ctx, ir_node *old_node, ir_node *new_node)
+{
+	(void)ctx;
+	/* kill_node() reports a replacement by NULL, a dead node has no users */
+	if (new_node == NULL)
+		return;
+	record_touched(new_node);
+	/* the users of the old node get new_node as operand */
+	if (edges_activated(get_irn_irg(old_node))) {
+		foreach_out_edge(old_node, edge) {
+			record_touched(get_edge_src_irn(edge));
+		}
+	}
+}
+
+void free_irg_verify_touched(ir_graph *irg)
+{
+	if (irg->verify_touched != NULL) {
+		DEL_ARR_F(irg->verify_touched);
+		irg->verify_touched = NULL;
+	}
+}
+
+void irg_verify_set_sample_period(unsigned period)
+{
+	bool const was_sampling = sample_period > 1;
+	bool const sampling     = period > 1;
+	sample_period = period;
+
+	if (sampling && !was_sampling) {
+		sample_hooks[0].hook._hook_new_node = sample_new_node;
+		sample_hooks[1].hook._hook_replace  = sample_replace;
+		register_hook(hook_new_node, &sample_hooks[0]);
+		register_hook(hook_replace,  &sample_hooks[1]);
+	} else if (!sampling && was_sampling) {
+		unregister_hook(hook_new_node, &sample_hooks[0]);
+		unregister_hook(hook_replace,  &sample_hooks[1]);
+	}
+
+	/* changes made while not recording must be caught by a full check */
+	foreach_irp_irg(i, irg) {
+		free_irg_verify_touched(irg);
+		irg->verify_count = 0;
+	}
+}
+
+typedef struct sample_env_t {
+	ir_visited_t reachable; /**< visited number of reachable nodes */
+	bool         ssa;       /**< check the SSA property */
+	bool         fine;
+} sample_env_t;
+
+static void verify_sampled_node(ir_node *node, sample_env_t *env)
+{
+	/* only check reachable nodes, each of them once */
+	if (get_irn_visited(node) != env->reachable)
+		return;
+	set_irn_visited(node, env->reachable + 1);
+
+	env->fine &= irn_verify(node);
+	if (env->ssa)
+		env->fine &= check_dominance_for_node(node);
+}
+
+/** Empty walker, the walk itself marks the reachable nodes visited. */
+static void mark_reachable(ir_node *node, void *env)
+{
+	(void)node;
+	(void)env;
+}
+
+static bool verify_touched(ir_graph *irg)
+{
+	unsigned *const touched = irg->verify_touched;
+	if (touched == NULL)
+		return true;
+
+	/* mark reachable nodes: dead nodes are skipped by irg_verify() too */
+	irg_walk_anchors(irg, mark_reachable, NULL, NULL);
+
+	sample_env_t env;
+	env.reachable = get_irg_visited(irg);
+	env.ssa       = get_irg_pinned(irg) == op_pin_state_pinned
+	             && irg_has_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
+	env.fine      = true;
+
+	bool const     has_edges = edges_activated(irg);
+	unsigned const last_idx  = get_irg_last_idx(irg);
+	for (size_t i = 0, n = ARR_LEN(touched); i < n; ++i) {
+		unsigned const idx = touched[i];
+		if (idx >= last_idx)
+			continue;
+		ir_node *const node = get_idx_irn(irg, idx);
+		if (node == NULL || is_Deleted(node))
+			continue;
+
+		verify_sampled_node(node, &env);
+		if (!is_Block(node) && !is_Anchor(node))
+			verify_sampled_node(get_nodes_block(node), &env);
+		if (has_edges) {
+			foreach_out_edge(node, edge) {
+				verify_sampled_node(get_edge_src_irn(edge), &env);
+			}
+		}
+	}
+	/* nodes checked above carry the next visited number */
+	inc_irg_visited(irg);
+
+	ARR_SETLEN(unsigned, irg->verify_touched, 0);
+	return env.fine;
+}
+
+int irg_verify_sampled(ir_graph *irg)
+{
+	if (sample_period <= 1 || irg->verify_count++ % sample_period == 0) {
+		bool const fine = irg_verify(irg);
+		if (irg->verify_touched != NULL)
+			ARR_SETLEN(unsigned, irg->verify_touched, 0);
+		return fine;
+	}
+	return verify_touched(irg);
+}
+
 void ir_register_verify_node_ops(void)
 {
 	set_op_verify(op_Add,      verify_node_Add);
@@ -18,4 +18,9 @@
  */
 void ir_register_verify_node_ops(void);
 
+/**
+ * Frees the list of touched nodes recorded for sampled verification.
+ */
+void free_irg_verify_touched(ir_graph *irg);
+
 #endif
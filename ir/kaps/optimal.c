@@ -24,6 +24,7 @@
 #include "vector.h"
 #include <assert.h>
 #include <stdbool.h>
+#include <string.h>
 
 #if KAPS_DUMP
 #include "html_dumper.h"
@@ -965,29 +966,30 @@ void apply_RII(pbqp_t *pbqp)
 	unsigned       col_len  = tgt_vec->len;
 	unsigned       row_len  = src_vec->len;
 	pbqp_matrix_t *mat      = pbqp_matrix_alloc(pbqp, row_len, col_len);
+	vector_t      *vec      = vector_alloc(pbqp, node_vec->len);
+	size_t         vec_size = sizeof(*vec) + sizeof(*vec->entries) * vec->len;
 
 	for (unsigned row_index = 0; row_index < row_len; ++row_index) {
-		for (unsigned col_index = 0; col_index < col_len; ++col_index) {
-			vector_t *vec = vector_copy(pbqp, node_vec);
-
-			if (src_is_src) {
-				vector_add_matrix_col(vec, src_mat, row_index);
-			} else {
-				vector_add_matrix_row(vec, src_mat, row_index);
-			}
-
-			if (tgt_is_src) {
-				vector_add_matrix_col(vec, tgt_mat, col_index);
-			} else {
-				vector_add_matrix_row(vec, tgt_mat, col_index);
-			}
-
-			mat->entries[row_index * col_len + col_index] = vector_get_min(vec);
+		/* The costs of the node and the source edge only depend on the row. */
+		memcpy(vec, node_vec, vec_size);
+		if (src_is_src) {
+			vector_add_matrix_col(vec, src_mat, row_index);
+		} else {
+			vector_add_matrix_row(vec, src_mat, row_index);
+		}
 
-			obstack_free(&pbqp->obstack, vec);
+		num *row = &mat->entries[row_index * col_len];
+		if (tgt_is_src) {
+			for (unsigned col_index = 0; col_index < col_len; ++col_index)
+				row[col_index] = vector_get_min_plus_matrix_col(vec, tgt_mat, col_index);
+		} else {
+			for (unsigned col_index = 0; col_index < col_len; ++col_index)
+				row[col_index] = vector_get_min_plus_matrix_row(vec, tgt_mat, col_index);
 		}
 	}
 
+	obstack_free(&pbqp->obstack, vec);
+
 	pbqp_edge_t *edge = get_edge(pbqp, src_node->index, tgt_node->index);
 
 	/* Disconnect node. */
@@ -1164,19 +1166,15 @@ unsigned get_local_minimal_alternative(pbqp_t *pbqp, pbqp_node_t *node)
 			pbqp_edge_t   *edge   = node->edges[edge_index];
 			pbqp_matrix_t *mat    = edge->costs;
 			bool           is_src = edge->src == node;
-			vector_t      *vec;
+			num            edge_min;
 
 			if (is_src) {
-				vec = vector_copy(pbqp, edge->tgt->costs);
-				vector_add_matrix_row(vec, mat, node_index);
+				edge_min = vector_get_min_plus_matrix_row(edge->tgt->costs, mat, node_index);
 			} else {
-				vec = vector_copy(pbqp, edge->src->costs);
-				vector_add_matrix_col(vec, mat, node_index);
+				edge_min = vector_get_min_plus_matrix_col(edge->src->costs, mat, node_index);
 			}
 
-			value = pbqp_add(value, vector_get_min(vec));
-
-			obstack_free(&pbqp->obstack, vec);
+			value = pbqp_add(value, edge_min);
 		}
 
 		if (value < min) {
@@ -14,29 +14,6 @@
 #include "adt/array.h"
 #include <string.h>
 
-num pbqp_add(num x, num y)
-{
-	if (x == INF_COSTS || y == INF_COSTS)
-		return INF_COSTS;
-
-	num res = x + y;
-
-#if !KAPS_USE_UNSIGNED
-	/* No positive overflow. */
-	assert(x < 0 || y < 0 || res >= x);
-	assert(x < 0 || y < 0 || res >= y);
-#endif
-
-	/* No negative overflow. */
-	assert(x > 0 || y > 0 || res <= x);
-	assert(x > 0 || y > 0 || res <= y);
-
-	/* Result is not infinity.*/
-	assert(res < INF_COSTS);
-
-	return res;
-}
-
 vector_t *vector_alloc(pbqp_t *pbqp, unsigned length)
 {
 	vector_t *vec = (vector_t *)obstack_alloc(&pbqp->obstack, sizeof(*vec) + sizeof(*vec->entries) * length);
@@ -134,6 +111,47 @@ num vector_get_min(vector_t *vec)
 	return min;
 }
 
+num vector_get_min_plus_matrix_col(vector_t const *vec,
+                                   pbqp_matrix_t const *mat,
+                                   unsigned col_index)
+{
+	unsigned          len     = vec->len;
+	unsigned          cols    = mat->cols;
+	num const        *entries = &mat->entries[col_index];
+	vec_elem_t const *elems   = vec->entries;
+	num               min     = INF_COSTS;
+
+	assert(len == mat->rows);
+	assert(col_index < cols);
+
+	for (unsigned index = 0; index < len; ++index) {
+		num elem = pbqp_add(elems[index].data, entries[index * cols]);
+		min = elem < min ? elem : min;
+	}
+
+	return min;
+}
+
+num vector_get_min_plus_matrix_row(vector_t const *vec,
+                                   pbqp_matrix_t const *mat,
+                                   unsigned row_index)
+{
+	unsigned          len     = vec->len;
+	num const        *entries = &mat->entries[row_index * mat->cols];
+	vec_elem_t const *elems   = vec->entries;
+	num               min     = INF_COSTS;
+
+	assert(len == mat->cols);
+	assert(row_index < mat->rows);
+
+	for (unsigned index = 0; index < len; ++index) {
+		num elem = pbqp_add(elems[index].data, entries[index]);
+		min = elem < min ? elem : min;
+	}
+
+	return min;
+}
+
 unsigned vector_get_min_index(vector_t *vec)
 {
 	unsigned len       = vec->len;
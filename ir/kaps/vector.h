@@ -12,9 +12,38 @@
 #ifndef KAPS_VECTOR_H
 #define KAPS_VECTOR_H
 
+#include <assert.h>
+
 #include "vector_t.h"
 
-num pbqp_add(num x, num y);
+/**
+ * Adds two costs, INF_COSTS is absorbing.
+ *
+ * This is the inner operation of all matrix and vector kernels and is called
+ * once per entry, so it is inline.
+ */
+static inline num pbqp_add(num x, num y)
+{
+	if (x == INF_COSTS || y == INF_COSTS)
+		return INF_COSTS;
+
+	num res = x + y;
+
+#if !KAPS_USE_UNSIGNED
+	/* No positive overflow. */
+	assert(x < 0 || y < 0 || res >= x);
+	assert(x < 0 || y < 0 || res >= y);
+#endif
+
+	/* No negative overflow. */
+	assert(x > 0 || y > 0 || res <= x);
+	assert(x > 0 || y > 0 || res <= y);
+
+	/* Result is not infinity.*/
+	assert(res < INF_COSTS);
+
+	return res;
+}
 
 vector_t *vector_alloc(pbqp_t *pbqp, unsigned length);
 
@@ -38,4 +67,13 @@ void vector_add_matrix_row(vector_t *vec, pbqp_matrix_t *mat, unsigned row_index
 num vector_get_min(vector_t *vec);
 unsigned vector_get_min_index(vector_t *vec);
 
+/* min_i (vec[i] + mat[i][col_index]) without materializing the sum */
+num vector_get_min_plus_matrix_col(vector_t const *vec,
+                                   pbqp_matrix_t const *mat,
+                                   unsigned col_index);
+/* min_i (vec[i] + mat[row_index][i]) without materializing the sum */
+num vector_get_min_plus_matrix_row(vector_t const *vec,
+                                   pbqp_matrix_t const *mat,
+                                   unsigned row_index);
+
 #endif
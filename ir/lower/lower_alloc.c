@@ -15,18 +15,23 @@
 #include "irgwalk.h"
 #include "irnode_t.h"
 #include "irnodeset.h"
+#include "lower_nodes.h"
 
-static unsigned po2_stack_alignment;
+typedef struct alloc_env_t {
+	unsigned po2_stack_alignment;
+} alloc_env_t;
 
 /**
  * Adjust the size of a node representing a stack alloc to a certain
  * stack_alignment.
  *
- * @param size       the node containing the non-aligned size
- * @param block      the block where new nodes are allocated on
+ * @param size                 the node containing the non-aligned size
+ * @param block                the block where new nodes are allocated on
+ * @param po2_stack_alignment  align to 2**po2_stack_alignment
  * @return a node representing the aligned size
  */
-static ir_node *adjust_alloc_size(dbg_info *dbgi, ir_node *size, ir_node *block)
+static ir_node *adjust_alloc_size(dbg_info *dbgi, ir_node *size, ir_node *block,
+                                  unsigned po2_stack_alignment)
 {
 	/* Example: po2_alignment 4 (align to 16 bytes):
 	 *   size = (size+15) & 0xfff...f8 */
@@ -46,34 +51,43 @@ static ir_node *adjust_alloc_size(dbg_info *dbgi, ir_node *size, ir_node *block)
 /**
  * lower Alloca nodes to allocate "bytes" instead of a certain type
  */
-static void lower_node(ir_node *node, void *data)
+static bool lower_alloc_node(ir_node *node, void *env)
 {
-	bool *changed = (bool*)data;
-	if (!is_Alloc(node))
-		return;
+	alloc_env_t const *const alloc_env = (alloc_env_t const*)env;
 
 	ir_node  *const size     = get_Alloc_size(node);
 	ir_node  *const mem      = get_Alloc_mem(node);
 	ir_node  *const block    = get_nodes_block(node);
 	dbg_info *const dbgi     = get_irn_dbg_info(node);
-	ir_node  *const new_size = adjust_alloc_size(dbgi, size, block);
+	ir_node  *const new_size = adjust_alloc_size(dbgi, size, block,
+	                                             alloc_env->po2_stack_alignment);
 	ir_node  *const new_node
 		= new_rd_Alloc(dbgi, block, mem, new_size, 1);
 
 	if (new_node != node)
 		exchange(node, new_node);
-	*changed = true;
+	return true;
 }
 
-void lower_alloc(ir_graph *irg, unsigned new_po2_stack_alignment)
+void lower_alloc_register(lower_nodes_t *lower,
+                          unsigned new_po2_stack_alignment)
 {
 	if (new_po2_stack_alignment == 0)
 		return;
 
-	po2_stack_alignment = new_po2_stack_alignment;
-	bool changed = false;
-	irg_walk_graph(irg, NULL, lower_node, &changed);
+	alloc_env_t *env = (alloc_env_t*)lower_nodes_alloc_env(lower, sizeof(*env));
+	env->po2_stack_alignment = new_po2_stack_alignment;
+	lower_nodes_register(lower, op_Alloc, lower_alloc_node, env,
+	                     IR_GRAPH_PROPERTIES_NONE);
+}
+
+void lower_alloc(ir_graph *irg, unsigned new_po2_stack_alignment)
+{
+	if (new_po2_stack_alignment == 0)
+		return;
 
-	confirm_irg_properties(irg, changed ? IR_GRAPH_PROPERTIES_CONTROL_FLOW
-	                                    : IR_GRAPH_PROPERTIES_ALL);
+	lower_nodes_t *lower = lower_nodes_new();
+	lower_alloc_register(lower, new_po2_stack_alignment);
+	lower_nodes_irg(lower, irg);
+	lower_nodes_free(lower);
 }
@@ -13,6 +13,7 @@
 
 #include <stdbool.h>
 #include "firm_types.h"
+#include "lower_nodes.h"
 
 /**
  * Lower Alloc nodes: Ensure that alloc sizes are a multiple of a specified
@@ -22,4 +23,9 @@
  */
 void lower_alloc(ir_graph *irg, unsigned po2_stack_alignment);
 
+/**
+ * Registers the Alloc lowering of lower_alloc() in a combined node lowering.
+ */
+void lower_alloc_register(lower_nodes_t *lower, unsigned po2_stack_alignment);
+
 #endif
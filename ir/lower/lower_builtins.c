@@ -11,7 +11,6 @@
 #include "lower_builtins.h"
 
 #include "adt/pmap.h"
-#include "deq.h"
 #include "ircons_t.h"
 #include "irgmod.h"
 #include "irgwalk.h"
@@ -24,8 +23,10 @@
 #include <stdbool.h>
 #include <stdlib.h>
 
-static bool dont_lower[ir_bk_last + 1];
-static lower_func lower_va_arg;
+typedef struct builtin_env_t {
+	bool       dont_lower[ir_bk_last + 1];
+	lower_func lower_va_arg;
+} builtin_env_t;
 
 static const char *get_builtin_name(ir_builtin_kind kind)
 {
@@ -158,15 +159,13 @@ static void replace_may_alias(ir_node *node)
 	turn_into_tuple(node, ARRAY_SIZE(in), in);
 }
 
-static void lower_builtin(ir_node *node, void *env)
+static bool lower_builtin(ir_node *node, void *env)
 {
-	bool *changed = (bool*)env;
-	if (!is_Builtin(node))
-		return;
+	builtin_env_t const *const builtin_env = (builtin_env_t const*)env;
 
 	ir_builtin_kind const kind = get_Builtin_kind(node);
-	if (dont_lower[kind])
-		return;
+	if (builtin_env->dont_lower[kind])
+		return false;
 
 	switch (kind) {
 	case ir_bk_prefetch: {
@@ -174,7 +173,7 @@ static void lower_builtin(ir_node *node, void *env)
 		ir_node *mem = get_Builtin_mem(node);
 		ir_node *const in[] = { mem };
 		turn_into_tuple(node, ARRAY_SIZE(in), in);
-		goto changed;
+		return true;
 	}
 
 	case ir_bk_ffs:
@@ -185,17 +184,15 @@ static void lower_builtin(ir_node *node, void *env)
 	case ir_bk_bswap:
 		/* replace with a call */
 		replace_with_call(node);
-		goto changed;
+		return true;
 
 	case ir_bk_may_alias:
 		replace_may_alias(node);
-changed:
-		*changed = true;
-		return;
+		return true;
 
 	case ir_bk_va_arg:
-		lower_va_arg(node);
-		return;
+		builtin_env->lower_va_arg(node);
+		return true;
 
 	case ir_bk_trap:
 	case ir_bk_debugbreak:
@@ -213,47 +210,29 @@ changed:
 	panic("unexpected builtin %+F", node);
 }
 
-static void collect_builtin(ir_node *node, void *env)
+void lower_builtins_register(lower_nodes_t *lower, size_t n_exceptions,
+                             ir_builtin_kind const *const exceptions,
+                             lower_func new_lower_va_arg)
 {
-	deq_t *builtins = env;
-	if (!is_Builtin(node)) {
-		return;
+	builtin_env_t *env = (builtin_env_t*)lower_nodes_alloc_env(lower, sizeof(*env));
+	env->lower_va_arg = new_lower_va_arg;
+	memset(env->dont_lower, 0, sizeof(env->dont_lower));
+	for (size_t i = 0; i < n_exceptions; ++i) {
+		env->dont_lower[exceptions[i]] = true;
 	}
-	ir_node** right_end = deq_alloc_right(builtins, sizeof(ir_node*));
-	*right_end = node;
-}
 
-static void irg_walk_builtin_nodes_post(ir_graph *irg,
-										irg_walk_func *post,
-										void *env)
-{
-	// We'll use this as a queue. Enqueue at right end, dequeue at left
-	deq_t builtin_nodes;
-	deq_init(&builtin_nodes);
-	irg_walk_graph(irg, NULL, collect_builtin, &builtin_nodes);
-	while (!deq_empty(&builtin_nodes)) {
-		ir_node** left_end = deq_left_end(&builtin_nodes);
-		post(*left_end, env);
-		deq_shrink_left(&builtin_nodes, sizeof(ir_node*));
-	}
-	deq_free(&builtin_nodes);
+	lower_nodes_register(lower, op_Builtin, lower_builtin, env,
+	                     IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES);
 }
 
 void lower_builtins(size_t n_exceptions,
                     ir_builtin_kind const *const exceptions,
                     lower_func new_lower_va_arg)
 {
-	lower_va_arg = new_lower_va_arg;
-	memset(dont_lower, 0, sizeof(dont_lower));
-	for (size_t i = 0; i < n_exceptions; ++i) {
-		dont_lower[exceptions[i]] = true;
-	}
-
+	lower_nodes_t *lower = lower_nodes_new();
+	lower_builtins_register(lower, n_exceptions, exceptions, new_lower_va_arg);
 	foreach_irp_irg(i, irg) {
-		bool changed = false;
-		assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES);
-		irg_walk_builtin_nodes_post(irg, lower_builtin, &changed);
-		confirm_irg_properties(irg, changed ? IR_GRAPH_PROPERTIES_CONTROL_FLOW
-		                                    : IR_GRAPH_PROPERTIES_ALL);
+		lower_nodes_irg(lower, irg);
 	}
+	lower_nodes_free(lower);
 }
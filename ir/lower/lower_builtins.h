@@ -12,6 +12,7 @@
 #define FIRM_LOWER_BUILTINS_H
 
 #include "firm_types.h"
+#include "lower_nodes.h"
 #include <stddef.h>
 
 typedef void(*lower_func)(ir_node*);
@@ -19,4 +20,12 @@ typedef void(*lower_func)(ir_node*);
 void lower_builtins(size_t n_exceptions, ir_builtin_kind const *exceptions,
                     lower_func lower_va_arg);
 
+/**
+ * Registers the Builtin lowering of lower_builtins() in a combined node
+ * lowering.
+ */
+void lower_builtins_register(lower_nodes_t *lower, size_t n_exceptions,
+                             ir_builtin_kind const *exceptions,
+                             lower_func lower_va_arg);
+
 #endif
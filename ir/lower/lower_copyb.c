@@ -8,6 +8,8 @@
  * @brief   Lower small CopyB nodes into a series of Load/Store nodes
  * @author  Michael Beck, Matthias Braun, Manuel Mohr
  */
+#include "lower_copyb.h"
+
 #include "adt/list.h"
 #include "ircons.h"
 #include "irgmod.h"
@@ -21,17 +23,15 @@
 #include "type_t.h"
 #include "util.h"
 
-static unsigned max_small_size; /**< The maximum size of a CopyB node
-                                     so that it is regarded as 'small'. */
-static unsigned min_large_size; /**< The minimum size of a CopyB node
-                                     so that it is regarded as 'large'. */
-static unsigned native_mode_bytes; /**< The size of the native mode in bytes. */
-static bool allow_misalignments; /**< Whether backend can handle misaligned
-                                      loads and stores. */
-
-typedef struct walk_env {
-	ir_node **copybs; /**< The list of CopyB nodes. */
-} walk_env_t;
+typedef struct copyb_env_t {
+	unsigned max_small_size;      /**< The maximum size of a CopyB node
+	                                   so that it is regarded as 'small'. */
+	unsigned min_large_size;      /**< The minimum size of a CopyB node
+	                                   so that it is regarded as 'large'. */
+	unsigned native_mode_bytes;   /**< The size of the native mode in bytes. */
+	bool     allow_misalignments; /**< Whether backend can handle misaligned
+	                                   loads and stores. */
+} copyb_env_t;
 
 static ir_mode *get_ir_mode(unsigned mode_bytes)
 {
@@ -48,7 +48,7 @@ static ir_mode *get_ir_mode(unsigned mode_bytes)
 /**
  * Turn a small CopyB node into a series of Load/Store nodes.
  */
-static void lower_small_copyb_node(ir_node *irn)
+static void lower_small_copyb_node(ir_node *irn, copyb_env_t const *env)
 {
 	ir_graph      *irg         = get_irn_irg(irn);
 	dbg_info      *dbgi        = get_irn_dbg_info(irn);
@@ -58,8 +58,8 @@ static void lower_small_copyb_node(ir_node *irn)
 	ir_node       *addr_dst    = get_CopyB_dst(irn);
 	ir_node       *mem         = get_CopyB_mem(irn);
 	ir_mode       *mode_ref    = get_irn_mode(addr_src);
-	unsigned       mode_bytes  = allow_misalignments ? native_mode_bytes
-	                                                 : get_type_alignment(tp);
+	unsigned       mode_bytes  = env->allow_misalignments ? env->native_mode_bytes
+	                                                      : get_type_alignment(tp);
 	unsigned       size        = get_type_size(tp);
 	unsigned       offset      = 0;
 	bool           is_volatile = get_CopyB_volatility(irn) == volatility_is_volatile;
@@ -93,10 +93,10 @@ static void lower_small_copyb_node(ir_node *irn)
 	exchange(irn, mem);
 }
 
-static ir_type *get_memcpy_methodtype(void)
+static ir_type *get_memcpy_methodtype(copyb_env_t const *env)
 {
 	ir_type *tp          = new_type_method(3, 1, false, cc_cdecl_set, mtp_no_property);
-	ir_mode *size_t_mode = get_ir_mode(native_mode_bytes);
+	ir_mode *size_t_mode = get_ir_mode(env->native_mode_bytes);
 
 	set_method_param_type(tp, 0, get_type_for_mode(mode_P));
 	set_method_param_type(tp, 1, get_type_for_mode(mode_P));
@@ -106,9 +106,9 @@ static ir_type *get_memcpy_methodtype(void)
 	return tp;
 }
 
-static ir_node *get_memcpy_address(ir_graph *irg)
+static ir_node *get_memcpy_address(ir_graph *irg, copyb_env_t const *env)
 {
-	ir_type   *mt  = get_memcpy_methodtype();
+	ir_type   *mt  = get_memcpy_methodtype(env);
 	ir_entity *ent = create_compilerlib_entity("memcpy", mt);
 
 	return new_r_Address(irg, ent);
@@ -117,7 +117,7 @@ static ir_node *get_memcpy_address(ir_graph *irg)
 /**
  * Turn a large CopyB node into a memcpy call.
  */
-static void lower_large_copyb_node(ir_node *irn)
+static void lower_large_copyb_node(ir_node *irn, copyb_env_t const *env)
 {
 	ir_graph *irg      = get_irn_irg(irn);
 	ir_node  *block    = get_nodes_block(irn);
@@ -128,9 +128,9 @@ static void lower_large_copyb_node(ir_node *irn)
 	ir_type  *copyb_tp = get_CopyB_type(irn);
 	unsigned  size     = get_type_size(copyb_tp);
 
-	ir_node  *callee      = get_memcpy_address(irg);
-	ir_type  *call_tp     = get_memcpy_methodtype();
-	ir_mode  *mode_size_t = get_ir_mode(native_mode_bytes);
+	ir_node  *callee      = get_memcpy_address(irg, env);
+	ir_type  *call_tp     = get_memcpy_methodtype(env);
+	ir_mode  *mode_size_t = get_ir_mode(env->native_mode_bytes);
 	ir_node  *size_cnst   = new_r_Const_long(irg, mode_size_t, size);
 	ir_node  *in[]        = { addr_dst, addr_src, size_cnst };
 	ir_node  *call        = new_rd_Call(dbgi, block, mem, callee, ARRAY_SIZE(in), in, call_tp);
@@ -139,61 +139,45 @@ static void lower_large_copyb_node(ir_node *irn)
 	exchange(irn, call_mem);
 }
 
-static void lower_copyb_node(ir_node *irn)
-{
-	ir_type *tp   = get_CopyB_type(irn);
-	unsigned size = get_type_size(tp);
-
-	if (size <= max_small_size)
-		lower_small_copyb_node(irn);
-	else if (size >= min_large_size)
-		lower_large_copyb_node(irn);
-	else
-		panic("CopyB of invalid size");
-}
-
-/**
- * Post-Walker: find CopyB nodes.
- */
-static void find_copyb_nodes(ir_node *irn, void *ctx)
+static bool lower_copyb_node(ir_node *irn, void *env)
 {
-	if (!is_CopyB(irn))
-		return;
+	copyb_env_t const *const copyb_env = (copyb_env_t const*)env;
 
 	ir_type *tp = get_CopyB_type(irn);
 	if (get_type_state(tp) != layout_fixed)
-		return;
-
-	unsigned size         = get_type_size(tp);
-	bool     medium_sized = max_small_size < size && size < min_large_size;
-	if (medium_sized)
-		return; /* Nothing to do for medium-sized CopyBs. */
+		return false;
 
-	/* Okay, either small or large CopyB, so link it in and lower it later. */
-	walk_env_t *env = (walk_env_t*)ctx;
-	ARR_APP1(ir_node*, env->copybs, irn);
+	unsigned size = get_type_size(tp);
+	if (size <= copyb_env->max_small_size) {
+		lower_small_copyb_node(irn, copyb_env);
+	} else if (size >= copyb_env->min_large_size) {
+		lower_large_copyb_node(irn, copyb_env);
+	} else {
+		return false; /* Nothing to do for medium-sized CopyBs. */
+	}
+	return true;
 }
 
-void lower_CopyB(ir_graph *irg, unsigned max_small_sz, unsigned min_large_sz,
-                 int allow_misaligns)
+void lower_CopyB_register(lower_nodes_t *lower, unsigned max_small_sz,
+                          unsigned min_large_sz, int allow_misaligns)
 {
 	assert(max_small_sz < min_large_sz && "CopyB size ranges must not overlap");
 
-	max_small_size      = max_small_sz;
-	min_large_size      = min_large_sz;
-	native_mode_bytes   = ir_target_pointer_size();
-	allow_misalignments = allow_misaligns;
-
-	walk_env_t env = { .copybs = NEW_ARR_F(ir_node*, 0) };
-	irg_walk_graph(irg, NULL, find_copyb_nodes, &env);
+	copyb_env_t *env = (copyb_env_t*)lower_nodes_alloc_env(lower, sizeof(*env));
+	env->max_small_size      = max_small_sz;
+	env->min_large_size      = min_large_sz;
+	env->native_mode_bytes   = ir_target_pointer_size();
+	env->allow_misalignments = allow_misaligns;
 
-	bool changed = false;
-	for (size_t i = 0, n = ARR_LEN(env.copybs); i != n; ++i) {
-		lower_copyb_node(env.copybs[i]);
-		changed = true;
-	}
-	confirm_irg_properties(irg, changed ? IR_GRAPH_PROPERTIES_CONTROL_FLOW
-	                                    : IR_GRAPH_PROPERTIES_ALL);
+	lower_nodes_register(lower, op_CopyB, lower_copyb_node, env,
+	                     IR_GRAPH_PROPERTIES_NONE);
+}
 
-	DEL_ARR_F(env.copybs);
+void lower_CopyB(ir_graph *irg, unsigned max_small_sz, unsigned min_large_sz,
+                 int allow_misaligns)
+{
+	lower_nodes_t *lower = lower_nodes_new();
+	lower_CopyB_register(lower, max_small_sz, min_large_sz, allow_misaligns);
+	lower_nodes_irg(lower, irg);
+	lower_nodes_free(lower);
 }
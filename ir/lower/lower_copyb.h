@@ -0,0 +1,23 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2016 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Lower small CopyB nodes into a series of Load/Store nodes
+ */
+#ifndef FIRM_LOWER_COPYB_H
+#define FIRM_LOWER_COPYB_H
+
+#include "firm_types.h"
+#include "lower_nodes.h"
+
+/**
+ * Registers the CopyB lowering of lower_CopyB() in a combined node lowering.
+ * The parameters are the same as for lower_CopyB().
+ */
+void lower_CopyB_register(lower_nodes_t *lower, unsigned max_small_size,
+                          unsigned min_large_size, int allow_misalignments);
+
+#endif
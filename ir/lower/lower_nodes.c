@@ -0,0 +1,98 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2016 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Run several node-local lowerings in a single graph traversal
+ */
+#include "lower_nodes.h"
+
+#include "array.h"
+#include "irgwalk.h"
+#include "irnode_t.h"
+#include "irop_t.h"
+#include "irtrace_t.h"
+#include "obst.h"
+#include "pdeq.h"
+#include "xmalloc.h"
+
+typedef struct handler_t {
+	lower_node_func func; /**< NULL if the opcode is not lowered */
+	void           *env;
+} handler_t;
+
+struct lower_nodes_t {
+	handler_t            *handlers; /**< handler per opcode */
+	ir_graph_properties_t required; /**< union of required properties */
+	deq_t                 worklist; /**< nodes waiting to be lowered */
+	struct obstack        obst;     /**< handler environments */
+};
+
+lower_nodes_t *lower_nodes_new(void)
+{
+	lower_nodes_t *lower = XMALLOCZ(lower_nodes_t);
+	lower->handlers = NEW_ARR_FZ(handler_t, ir_get_n_opcodes());
+	lower->required = IR_GRAPH_PROPERTIES_NONE;
+	deq_init(&lower->worklist);
+	obstack_init(&lower->obst);
+	return lower;
+}
+
+void lower_nodes_free(lower_nodes_t *lower)
+{
+	obstack_free(&lower->obst, NULL);
+	deq_free(&lower->worklist);
+	DEL_ARR_F(lower->handlers);
+	free(lower);
+}
+
+void *lower_nodes_alloc_env(lower_nodes_t *lower, size_t size)
+{
+	return obstack_alloc(&lower->obst, size);
+}
+
+void lower_nodes_register(lower_nodes_t *lower, ir_op const *op,
+                          lower_node_func func, void *env,
+                          ir_graph_properties_t required)
+{
+	unsigned code = get_op_code(op);
+	assert(code < ARR_LEN(lower->handlers));
+	assert(lower->handlers[code].func == NULL && "opcode lowered twice");
+	lower->handlers[code].func = func;
+	lower->handlers[code].env  = env;
+	lower->required           |= required;
+}
+
+static void collect_node(ir_node *node, void *env)
+{
+	lower_nodes_t *lower = (lower_nodes_t*)env;
+	unsigned       code  = get_irn_opcode(node);
+	if (code < ARR_LEN(lower->handlers) && lower->handlers[code].func != NULL)
+		deq_push_pointer_right(&lower->worklist, node);
+}
+
+void lower_nodes_irg(lower_nodes_t *lower, ir_graph *irg)
+{
+	ir_trace_push("lower_nodes", irg);
+	assure_irg_properties(irg, lower->required);
+
+	/* Collect first: handlers replace nodes, which must not disturb the
+	 * walk. */
+	irg_walk_graph(irg, NULL, collect_node, lower);
+
+	bool changed = false;
+	while (!deq_empty(&lower->worklist)) {
+		ir_node *node = deq_pop_pointer_left(ir_node, &lower->worklist);
+		/* The node may have been exchanged by an earlier handler, in which
+		 * case its opcode changed and no handler is found anymore. */
+		handler_t const *handler = &lower->handlers[get_irn_opcode(node)];
+		if (handler->func != NULL)
+			changed |= handler->func(node, handler->env);
+	}
+
+	confirm_irg_properties(irg, changed ? IR_GRAPH_PROPERTIES_CONTROL_FLOW
+	                                    : IR_GRAPH_PROPERTIES_ALL);
+	ir_trace_pop();
+}
@@ -0,0 +1,65 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2016 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Run several node-local lowerings in a single graph traversal
+ *
+ * Many target lowerings only look at nodes of a single opcode and replace
+ * them by a sequence of other nodes without touching the rest of the graph
+ * (Alloc size adjustment, CopyB expansion, Builtin to Call lowering). Running
+ * each of them as its own pass costs a complete graph walk per lowering.
+ *
+ * A lower_nodes_t collects per-opcode handlers of such lowerings. Running it
+ * walks the graph once, puts all nodes with a registered handler on a
+ * worklist and then calls the handlers in walk order. Each handler gets the
+ * environment it was registered with, so several pipelines can exist at the
+ * same time.
+ */
+#ifndef FIRM_LOWER_NODES_H
+#define FIRM_LOWER_NODES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "firm_types.h"
+#include "irgraph.h"
+
+/**
+ * Lowers a single node.
+ * @param env  the environment the handler was registered with
+ * @return true if the graph was changed
+ */
+typedef bool (*lower_node_func)(ir_node *node, void *env);
+
+typedef struct lower_nodes_t lower_nodes_t;
+
+/** Creates an empty lowering pipeline. */
+lower_nodes_t *lower_nodes_new(void);
+
+/** Frees a lowering pipeline. */
+void lower_nodes_free(lower_nodes_t *lower);
+
+/**
+ * Allocates @p size bytes for a handler environment, which live as long as
+ * the pipeline.
+ */
+void *lower_nodes_alloc_env(lower_nodes_t *lower, size_t size);
+
+/**
+ * Registers @p func as handler for all nodes with opcode @p op.
+ * @param env       passed to every call of @p func
+ * @param required  graph properties the handler relies on, they are assured
+ *                  once before the traversal
+ */
+void lower_nodes_register(lower_nodes_t *lower, ir_op const *op,
+                          lower_node_func func, void *env,
+                          ir_graph_properties_t required);
+
+/**
+ * Runs all registered handlers on @p irg in one traversal.
+ */
+void lower_nodes_irg(lower_nodes_t *lower, ir_graph *irg);
+
+#endif
@@ -37,6 +37,7 @@
 #include "iroptimize.h"
 #include "irouts_t.h"
 #include "irprintf.h"
+#include "irtrace_t.h"
 #include "list.h"
 #include "obstack.h"
 #include "panic.h"
@@ -3180,6 +3181,7 @@ static void add_memory_keeps(ir_graph *irg, ir_node **kept_memory, size_t len)
 
 void combo(ir_graph *irg)
 {
+	ir_trace_push("combo", irg);
 	assure_irg_properties(irg,
 		IR_GRAPH_PROPERTY_NO_BADS
 		| IR_GRAPH_PROPERTY_NO_TUPLES
@@ -3275,4 +3277,5 @@ void combo(ir_graph *irg)
 	set_value_of_func(NULL);
 
 	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_NONE);
+	ir_trace_pop();
 }
@@ -10,6 +10,7 @@
  * @author  Michael Beck
  * @brief
  */
+#include "array.h"
 #include "debug.h"
 #include "ircons.h"
 #include "irdom.h"
@@ -27,6 +28,7 @@
 #include "iropt_t.h"
 #include "iroptimize.h"
 #include "irouts.h"
+#include "irtrace_t.h"
 #include "tv_t.h"
 #include "valueset.h"
 
@@ -990,6 +992,29 @@ static void compute_antic(ir_node *block, void *ctx)
 		env->changes |= 1;
 }
 
+/**
+ * Appends a block to the antic block order.
+ */
+static void collect_antic_block(ir_node *block, void *ctx)
+{
+	ir_node ***order = (ir_node***)ctx;
+
+	if (is_Block(block))
+		ARR_APP1(ir_node*, *order, block);
+}
+
+/**
+ * Returns the blocks in the order the block-wise walker visits them.
+ * The antic passes visit them in this order without walking all nodes
+ * of the graph again.
+ */
+static ir_node **compute_antic_order(ir_graph *irg)
+{
+	ir_node **order = NEW_ARR_F(ir_node*, 0);
+	irg_walk_blkwise_graph(irg, collect_antic_block, NULL, &order);
+	return order;
+}
+
 /* --------------------------------------------------------
  * Main algorithm Avail_out
  * --------------------------------------------------------
@@ -1727,7 +1752,9 @@ static void gvn_pre(ir_graph *irg, pre_env *env)
 	dom_tree_walk_irg(irg, compute_avail_top_down, NULL, env);
 
 	/* compute the anticipated value sets for all blocks */
-	unsigned antic_iter = 0;
+	ir_node **order      = compute_antic_order(irg);
+	size_t    n_blocks   = ARR_LEN(order);
+	unsigned  antic_iter = 0;
 	env->first_iter = 1;
 
 	env->iteration = 1;
@@ -1736,11 +1763,13 @@ static void gvn_pre(ir_graph *irg, pre_env *env)
 		++antic_iter;
 		DB((dbg, LEVEL_2, "= Antic_in Iteration %d ========================\n", antic_iter));
 		env->changes = 0;
-		irg_walk_blkwise_graph(irg, compute_antic, NULL, env);
+		for (size_t i = 0; i < n_blocks; ++i)
+			compute_antic(order[i], env);
 		env->first_iter = 0;
 		DB((dbg, LEVEL_2, "----------------------------------------------\n"));
 		env->iteration ++;
 	} while (env->changes != 0 && antic_iter < MAX_ANTIC_ITER);
+	DEL_ARR_F(order);
 
 	DEBUG_ONLY(set_stats(gvnpre_stats->antic_iterations, antic_iter);)
 
@@ -1789,6 +1818,8 @@ void do_gvn_pre(ir_graph *irg)
 	ir_nodeset_t          keeps;
 	optimization_state_t  state;
 
+	ir_trace_push("gvn_pre", irg);
+
 	/* bads and unreachables cause too much trouble with dominance,
 	   loop info for endless loop detection,
 	   no critical edges is PRE precondition
@@ -1878,4 +1909,5 @@ void do_gvn_pre(ir_graph *irg)
 	/* TODO assure nothing else breaks. */
 	set_opt_global_cse(0);
 	edges_activate(irg);
+	ir_trace_pop();
 }
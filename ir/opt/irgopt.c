@@ -22,6 +22,7 @@
 #include "iropt_t.h"
 #include "iroptimize.h"
 #include "irtools.h"
+#include "irtrace_t.h"
 #include "pdeq.h"
 #include <assert.h>
 
@@ -153,6 +154,7 @@ static void opt_walker(ir_node *n, deq_t *waitq)
 
 void optimize_graph_df(ir_graph *irg)
 {
+	ir_trace_push("optimize_graph_df", irg);
 	ir_graph_properties_t props = IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES;
 	if (get_opt_global_cse()) {
 		set_irg_pinned(irg, op_pin_state_floats);
@@ -217,6 +219,7 @@ void optimize_graph_df(ir_graph *irg)
 	 * Doing this AFTER edges where deactivated saves cycles */
 	ir_node *end = get_irg_end(irg);
 	remove_End_Bads_and_doublets(end);
+	ir_trace_pop();
 }
 
 void local_opts_const_code(void)
@@ -7936,7 +7936,10 @@ ir_node *optimize_node(ir_node *n)
 	if (!get_optimize() && (iro != iro_Phi))
 		return n;
 
+	/* Bulk constructed nodes may still lack predecessors. */
 	ir_graph *irg = get_irn_irg(n);
+	if (irg_is_constrained(irg, IR_GRAPH_CONSTRAINT_BULK_CONSTRUCTION))
+		return n;
 
 	/* constant expression evaluation / constant folding */
 	if (get_opt_constant_folding()) {
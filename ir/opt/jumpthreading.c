@@ -12,6 +12,7 @@
 #include "array.h"
 #include "debug.h"
 #include "ircons.h"
+#include "irdom.h"
 #include "iredges_t.h"
 #include "irgmod.h"
 #include "irgopt.h"
@@ -30,6 +31,53 @@
 
 DEBUG_ONLY(static firm_dbg_module_t *dbg;)
 
+/**
+ * Updates the dominance information, if it is kept up to date, after a
+ * control flow edge from @p from to @p to was added.
+ */
+static void dom_insert_edge(ir_node *from, ir_node *to)
+{
+	if (irg_has_properties(get_irn_irg(to), IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE))
+		ir_dom_insert_edge(from, to);
+}
+
+/**
+ * Updates the dominance information, if it is kept up to date, after a
+ * control flow edge from @p from to @p to was removed.
+ */
+static void dom_delete_edge(ir_node *from, ir_node *to)
+{
+	if (from != NULL
+	    && irg_has_properties(get_irn_irg(to), IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE))
+		ir_dom_delete_edge(from, to);
+}
+
+/**
+ * Keeps @p block alive, which adds a control flow edge to the end block.
+ */
+static void keep_block_alive(ir_node *block)
+{
+	keep_alive(block);
+	dom_insert_edge(block, get_irg_end_block(get_irn_irg(block)));
+}
+
+/**
+ * Exchanges the control flow node @p jump with a Bad and removes its edges
+ * from the dominance information.
+ */
+static void kill_jump(ir_node *jump)
+{
+	ir_graph *irg   = get_irn_irg(jump);
+	ir_node  *block = get_nodes_block(jump);
+	ir_node  *bad   = new_r_Bad(irg, mode_X);
+	foreach_out_edge_safe(jump, edge) {
+		ir_node *succ = get_edge_src_irn(edge);
+		set_irn_n(succ, get_edge_src_pos(edge), bad);
+		dom_delete_edge(block, succ);
+	}
+	exchange(jump, bad);
+}
+
 /**
  * Add the new predecessor x to node node, which is either a Block or a Phi
  */
@@ -174,7 +222,7 @@ static void construct_ssa(ir_node *orig_block, ir_node *orig_val,
 			if (is_Phi(user) && get_irn_mode(user) == mode_M && !get_Phi_loop(user)) {
 				set_Phi_loop(user, true);
 				keep_alive(user);
-				keep_alive(user_block);
+				keep_block_alive(user_block);
 			}
 		}
 	}
@@ -192,11 +240,17 @@ static void construct_ssa(ir_node *orig_block, ir_node *orig_val,
  */
 static void split_critical_edge(ir_node *block, int pos)
 {
-	ir_graph *irg       = get_irn_irg(block);
-	ir_node  *in[]      = { get_Block_cfgpred(block, pos) };
-	ir_node  *new_block = new_r_Block(irg, ARRAY_SIZE(in), in);
-	ir_node  *new_jmp   = new_r_Jmp(new_block);
+	ir_graph *irg        = get_irn_irg(block);
+	ir_node  *pred_block = get_Block_cfgpred_block(block, pos);
+	ir_node  *in[]       = { get_Block_cfgpred(block, pos) };
+	ir_node  *new_block  = new_r_Block(irg, ARRAY_SIZE(in), in);
+	dom_insert_edge(pred_block, new_block);
+	ir_node  *new_jmp    = new_r_Jmp(new_block);
 	set_Block_cfgpred(block, pos, new_jmp);
+	/* remove the old edge first: the dominator subtree recomputed for it
+	 * already contains the new block */
+	dom_delete_edge(pred_block, block);
+	dom_insert_edge(new_block, block);
 }
 
 typedef struct jumpthreading_env_t {
@@ -257,7 +311,7 @@ static void copy_and_fix(const jumpthreading_env_t *env, ir_node *block,
 		if (is_End(node)) {
 			/* edge is a Keep edge. If the end block is unreachable via normal
 			 * control flow, we must maintain end's reachability with Keeps. */
-			keep_alive(copy_block);
+			keep_block_alive(copy_block);
 			continue;
 		}
 		/* ignore control flow */
@@ -409,9 +463,7 @@ static ir_node *find_const_or_confirm(jumpthreading_env_t *env, ir_node *jump,
 		assert(get_Block_n_cfgpreds(env->true_block) == 1);
 		if (block == get_Block_cfgpred_block(env->true_block, 0)) {
 			if (evaluated == 0) {
-				ir_graph *irg = get_irn_irg(block);
-				ir_node  *bad = new_r_Bad(irg, mode_X);
-				exchange(jump, bad);
+				kill_jump(jump);
 			} else if (evaluated == 1) {
 				dbg_info *dbgi = get_irn_dbg_info(skip_Proj(jump));
 				ir_node  *jmp  = new_rd_Jmp(dbgi, get_nodes_block(jump));
@@ -429,6 +481,7 @@ static ir_node *find_const_or_confirm(jumpthreading_env_t *env, ir_node *jump,
 
 		/* adjust true_block to point directly towards our jump */
 		add_pred(env->true_block, jump);
+		dom_insert_edge(block, env->true_block);
 
 		split_critical_edge(env->true_block, 0);
 
@@ -482,6 +535,7 @@ static ir_node *find_candidate(jumpthreading_env_t *env, ir_node *jump,
 
 		/* adjust true_block to point directly towards our jump */
 		add_pred(env->true_block, jump);
+		dom_insert_edge(block, env->true_block);
 
 		split_critical_edge(env->true_block, 0);
 
@@ -546,7 +600,7 @@ static ir_node *find_candidate(jumpthreading_env_t *env, ir_node *jump,
 }
 
 /**
- * Block-walker: searches for the following construct
+ * Searches for the following construct above block
  *
  *  Const or Phi with constants
  *           |
@@ -558,10 +612,8 @@ static ir_node *find_candidate(jumpthreading_env_t *env, ir_node *jump,
  *        /
  *     Block
  */
-static void thread_jumps(ir_node* block, void* data)
+static void thread_jumps(ir_node* block, bool *changed)
 {
-	bool *changed = (bool*)data;
-
 	/* we do not deal with Phis, so restrict this to exactly one cfgpred */
 	if (get_Block_n_cfgpreds(block) != 1)
 		return;
@@ -582,14 +634,17 @@ static void thread_jumps(ir_node* block, void* data)
 		const ir_tarval *tv = get_Const_tarval(selector);
 		assert(tv == tarval_b_false || tv == tarval_b_true);
 		ir_node    *const cond_block = get_nodes_block(cond);
-		ir_node    *const jmp        = new_r_Jmp(cond_block);
-		ir_node    *const bad        = new_r_Bad(irg, mode_X);
-		const bool        is_true    = tv == tarval_b_true;
-		ir_node *const in[] = {
-			[pn_Cond_false] = is_true ? bad : jmp,
-			[pn_Cond_true]  = is_true ? jmp : bad,
-		};
-		turn_into_tuple(cond, ARRAY_SIZE(in), in);
+		unsigned    const taken      = tv == tarval_b_true
+		                               ? pn_Cond_true : pn_Cond_false;
+		/* exchange the Projs instead of creating a Tuple, which would keep
+		 * the dead edge visible to the dominance update */
+		foreach_out_edge_safe(cond, edge) {
+			ir_node *const proj = get_edge_src_irn(edge);
+			if (get_Proj_num(proj) == taken)
+				exchange(proj, new_r_Jmp(cond_block));
+			else
+				kill_jump(proj);
+		}
 		*changed = true;
 		return;
 	}
@@ -608,7 +663,7 @@ static void thread_jumps(ir_node* block, void* data)
 	if (copy_block != get_nodes_block(cond)) {
 		/* We might thread the condition block of an infinite loop,
 		 * such that there is no path to End anymore. */
-		keep_alive(block);
+		keep_block_alive(block);
 
 		/* we have to remove the edge towards the pred as the pred now
 		 * jumps into the true_block. We also have to shorten Phis
@@ -626,13 +681,21 @@ static void thread_jumps(ir_node* block, void* data)
 			}
 		}
 
+		ir_node *pred_block = get_Block_cfgpred_block(env.cnst_pred, cnst_pos);
 		set_Block_cfgpred(env.cnst_pred, cnst_pos, badX);
+		dom_delete_edge(pred_block, env.cnst_pred);
 	}
 
 	/* the graph is changed now */
 	*changed = true;
 }
 
+static void collect_block(ir_node *block, void *data)
+{
+	ir_node ***blocks = (ir_node***)data;
+	ARR_APP1(ir_node*, *blocks, block);
+}
+
 void opt_jumpthreading(ir_graph* irg)
 {
 	assure_irg_properties(irg,
@@ -646,20 +709,28 @@ void opt_jumpthreading(ir_graph* irg)
 
 	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_IRN_VISITED);
 
-	bool changed = false;
-	bool rerun;
+	/* The blocks are collected before the transformation, so that keeping the
+	 * dominance information up to date may walk the graph. */
+	ir_node **blocks  = NEW_ARR_F(ir_node*, 0);
+	bool      changed = false;
+	bool      rerun;
 	do {
 		rerun = false;
-		irg_block_walk_graph(irg, thread_jumps, NULL, &rerun);
+		ARR_RESIZE(ir_node*, blocks, 0);
+		irg_block_walk_graph(irg, collect_block, NULL, &blocks);
+		for (size_t i = 0, n = ARR_LEN(blocks); i < n; ++i)
+			thread_jumps(blocks[i], &rerun);
 		changed |= rerun;
 	} while (rerun);
+	DEL_ARR_F(blocks);
 
 	ir_free_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_IRN_VISITED);
 
 	if (changed) {
 		/* we tend to produce a lot of duplicated keep edges, remove them */
 		remove_End_Bads_and_doublets(get_irg_end(irg));
-		confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_NONE);
+		/* the dominance information was updated along with each edge */
+		confirm_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
 	} else {
 		confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_ALL);
 	}
@@ -2311,6 +2311,8 @@ void optimize_load_store(ir_graph *irg)
 		get_irg_memory_disambiguator_options(irg);
 	if ((opts & aa_opt_always_alias) == 0) {
 		assure_irp_globals_entity_usage_computed();
+		if (opts & aa_opt_points_to)
+			assure_irp_points_to_computed();
 	}
 
 	walk_env_t env = { .changes = NO_CHANGES };
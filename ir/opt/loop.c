@@ -12,6 +12,7 @@
 
 #include "array.h"
 #include "debug.h"
+#include "execfreq_t.h"
 #include "irbackedge_t.h"
 #include "ircons_t.h"
 #include "irdom.h"
@@ -80,6 +81,8 @@ static ir_loop **loops;
 /* Stats */
 typedef struct loop_stats_t {
 	unsigned loops;
+	unsigned cold;
+	unsigned few_iterations;
 	unsigned inverted;
 	unsigned too_large;
 	unsigned too_large_adapted;
@@ -106,6 +109,8 @@ static void print_stats(void)
 {
 	DB((dbg, LEVEL_2, "---------------------------------------\n"));
 	DB((dbg, LEVEL_2, "loops             :   %d\n", stats.loops));
+	DB((dbg, LEVEL_2, "cold              :   %d\n", stats.cold));
+	DB((dbg, LEVEL_2, "few_iterations    :   %d\n", stats.few_iterations));
 	DB((dbg, LEVEL_2, "inverted          :   %d\n", stats.inverted));
 	DB((dbg, LEVEL_2, "too_large         :   %d\n", stats.too_large));
 	DB((dbg, LEVEL_2, "too_large_adapted :   %d\n", stats.too_large_adapted));
@@ -131,6 +136,10 @@ typedef struct loop_opt_params_t {
 	bool     allow_const_unrolling;
 	bool     allow_invar_unrolling;
 	unsigned invar_unrolling_min_size;  /* [nodes] */
+
+	/* Only used if the blocks carry execution frequencies */
+	unsigned hot_size_factor;           /* Node limit factor for hot loops [factor] */
+	double   min_inversion_trips;       /* Minimum average trip count for inversion [iterations] */
 } loop_opt_params_t;
 
 static loop_opt_params_t opt_params;
@@ -143,6 +152,8 @@ typedef struct loop_info_t {
 	unsigned   cf_outs;    /* number of cf edges which leave the loop */
 	ir_node   *cf_out;     /* single loop leaving cf edge */
 	int        be_src_pos; /* position of the single own backedge in the head */
+	double     freq;       /* execution frequency of the head, 0 if unknown */
+	double     trip_count; /* average head executions per entry, 0 if unknown */
 
 	/* for inversion */
 	unsigned cc_size; /* nodes in the condition chain */
@@ -200,6 +211,15 @@ static unsigned get_max_nodes_adapted(unsigned const depth)
 	return (int)((double)opt_params.max_loop_size * factor);
 }
 
+/* Returns the maximum nodes of the unrolled cur_loop.
+ * Hot loops may grow more than others. */
+static unsigned get_max_unrolled_loop_size(void)
+{
+	if (loop_info.freq >= HOT_LOOP_FREQ)
+		return opt_params.max_unrolled_loop_size * opt_params.hot_size_factor;
+	return opt_params.max_unrolled_loop_size;
+}
+
 /* Returns 0 if the node or block is not in cur_loop. */
 static bool is_in_loop(const ir_node *const node)
 {
@@ -1134,6 +1154,16 @@ static void loop_inversion(ir_graph *const irg)
 		return;
 	}
 
+	/* Inversion only saves a jump per iteration, but duplicates the
+	 * condition chain. */
+	if (loop_info.trip_count > 0.0
+	    && loop_info.trip_count < opt_params.min_inversion_trips) {
+		DB((dbg, LEVEL_1, "Trip count %g < minimal trip count %g\n",
+			loop_info.trip_count, opt_params.min_inversion_trips));
+		++stats.few_iterations;
+		return;
+	}
+
 	/*inversion_head_node_limit = INT_MAX;*/
 	ir_reserve_resources(irg, IR_RESOURCE_BLOCK_MARK);
 
@@ -1763,13 +1793,24 @@ static ir_node *is_simple_loop(void)
 	DB((dbg, LEVEL_4, "1 loop exit\n"));
 
 	/* Calculate maximum unroll_nr keeping node count below limit. */
-	loop_info.max_unroll = (int)((double)opt_params.max_unrolled_loop_size / (double)loop_info.nodes);
+	unsigned const max_size = get_max_unrolled_loop_size();
+	loop_info.max_unroll = (int)((double)max_size / (double)loop_info.nodes);
 	if (loop_info.max_unroll < 2) {
 		++stats.too_large;
 		return NULL;
 	}
 
-	DB((dbg, LEVEL_4, "maximum unroll factor %u, to not exceed node limit \n", opt_params.max_unrolled_loop_size));
+	/* Unrolling beyond the average number of iterations only adds code. */
+	if (loop_info.trip_count > 0.0
+	    && loop_info.max_unroll > loop_info.trip_count) {
+		loop_info.max_unroll = (unsigned)loop_info.trip_count;
+		if (loop_info.max_unroll < 2) {
+			++stats.few_iterations;
+			return NULL;
+		}
+	}
+
+	DB((dbg, LEVEL_4, "maximum unroll factor %u, to not exceed node limit %u\n", loop_info.max_unroll, max_size));
 
 	/* RETURN if we have more than 1 be. */
 	/* Get my backedges without alien bes. */
@@ -2154,9 +2195,10 @@ static void unroll_loop(ir_graph *const irg)
 	if (loop_info.nodes <= 0)
 		return;
 
-	if (loop_info.nodes > opt_params.max_unrolled_loop_size) {
+	unsigned const max_size = get_max_unrolled_loop_size();
+	if (loop_info.nodes > max_size) {
 		DB((dbg, LEVEL_2, "Nodes %d > allowed nodes %d\n",
-			loop_info.nodes, opt_params.max_unrolled_loop_size));
+			loop_info.nodes, max_size));
 		++stats.too_large;
 		return;
 	}
@@ -2246,6 +2288,20 @@ static void init_analyze(ir_graph *const irg, ir_loop *const loop, loop_op_t con
 	}
 	DB((dbg, LEVEL_1, "Loophead: %N\n", loop_head));
 
+	if (ir_has_execfreq(irg)) {
+		loop_info.freq       = get_block_execfreq(loop_head);
+		loop_info.trip_count = get_loop_trip_count(loop, loop_head);
+		DB((dbg, LEVEL_1, "Frequency %g, trip count %g\n",
+			loop_info.freq, loop_info.trip_count));
+	}
+
+	if (loop_info.freq > 0.0 && loop_info.freq < COLD_LOOP_FREQ) {
+		DB((dbg, LEVEL_1, "Frequency %g < cold loop frequency %g\n",
+			loop_info.freq, COLD_LOOP_FREQ));
+		++stats.cold;
+		return;
+	}
+
 	if (loop_info.branches > opt_params.max_branches) {
 		DB((dbg, LEVEL_1, "Branches %d > allowed branches %d\n",
 			loop_info.branches, opt_params.max_branches));
@@ -2290,6 +2346,8 @@ static void set_loop_params(void)
 	opt_params.invar_unrolling_min_size =   20;
 	opt_params.max_unrolled_loop_size   =  400;
 	opt_params.max_branches             = 9999;
+	opt_params.hot_size_factor          =    2;
+	opt_params.min_inversion_trips      =  2.0;
 }
 
 /**
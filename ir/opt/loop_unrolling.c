@@ -9,12 +9,14 @@
  * @author  Elias Aebi
  */
 #include "lcssa_t.h"
+#include "execfreq_t.h"
 #include "irtools.h"
 #include "xmalloc.h"
 #include "debug.h"
 #include <assert.h>
 #include <pset_new.h>
 #include "irnode_t.h"
+#include "util.h"
 
 DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
 
@@ -238,8 +240,8 @@ static void rewire_block(ir_node *const block, ir_node *const header)
 	}
 }
 
-static unsigned find_optimal_factor(unsigned long number, unsigned max) {
-	if (number <= max) {
+static unsigned find_optimal_factor(unsigned long number, unsigned max, unsigned max_full) {
+	if (number <= max_full) {
 		// loop can be unrolled completely
 		return (unsigned) number;
 	}
@@ -275,15 +277,17 @@ static ir_node* skip_trivial_phis(ir_node *start) {
  *
  * Currently only loops featuring a counter variable with constant start, step and limit known at compile time
  * are considered for unrolling.
- * Tries to find a divisor of the number of loop iterations which is smaller than the maximum unroll factor
- * and is a power of two. In this case, additional optimizations are possible.
+ * Loops with at most max_full iterations are unrolled completely. Otherwise, tries to find a divisor of the
+ * number of loop iterations which is smaller than the maximum unroll factor and is a power of two. In this
+ * case, additional optimizations are possible.
  *
  * @param header loop header
  * @param max max allowed unroll factor
+ * @param max_full max number of iterations of a loop that is unrolled completely
  * @param fully_unroll pointer to where the decision to fully unroll the loop is stored
  * @return unroll factor to use fot this loop; 0 if loop should not be unrolled
  */
-static unsigned find_suitable_factor(ir_node *const header, unsigned max, bool *fully_unroll) {
+static unsigned find_suitable_factor(ir_node *const header, unsigned max, unsigned max_full, bool *fully_unroll) {
 	unsigned const DONT_UNROLL = 0;
 	unsigned const n_outs = get_irn_n_outs(header);
 	unsigned factor = 1;
@@ -400,7 +404,7 @@ static unsigned find_suitable_factor(ir_node *const header, unsigned max, bool *
 			long init = get_tarval_long(tv_init);
 			DB((dbg, LEVEL_3 , "\tinit: %ld, step: %ld, limit: %ld, loop count: %ld\n", init, step, limit, loop_count));
 #endif
-			factor = find_optimal_factor((unsigned long) loop_count, max);
+			factor = find_optimal_factor((unsigned long) loop_count, max, max_full);
 			if (factor == (unsigned long) loop_count) {
 				*fully_unroll = true;
 			}
@@ -547,7 +551,39 @@ static void rewire_fully_unrolled(ir_loop *const loop, ir_node *header) {
 
 static unsigned n_loops_unrolled = 0;
 
-static bool unroll_loop(ir_loop *const loop, unsigned factor)
+/**
+ * Adapts the unroll limits to the execution frequency of the loop.
+ *
+ * Cold loops are not unrolled at all. Hot loops may be unrolled completely
+ * as long as the result is not larger than the biggest loop unrolled by the
+ * regular factor. Without frequencies, a loop is only unrolled completely if
+ * it has at most @p factor iterations.
+ *
+ * @param factor    the unroll factor, updated for this loop
+ * @param max_full  stores the maximum number of iterations of a loop that is
+ *                  unrolled completely
+ */
+static void get_unroll_limits(ir_loop *const loop, ir_node *const header, size_t const n_nodes,
+                              unsigned const maxsize, unsigned *const factor, unsigned *const max_full)
+{
+	*max_full = *factor;
+
+	double const freq = get_block_execfreq(header);
+	if (!ir_has_execfreq(get_irn_irg(header)) || freq <= 0.0)
+		return;
+
+	DB((dbg, LEVEL_3, "\texecution frequency %g, trip count %g\n", freq, get_loop_trip_count(loop, header)));
+	if (freq < COLD_LOOP_FREQ) {
+		DB((dbg, LEVEL_3, "\tcold loop %+F, do not unroll\n", loop));
+		*factor   = 1;
+		*max_full = 1;
+	} else if (freq >= HOT_LOOP_FREQ) {
+		size_t const budget = (size_t)maxsize * *factor / MAX(n_nodes, (size_t)1);
+		*max_full = (unsigned)MAX(budget, (size_t)*factor);
+	}
+}
+
+static bool unroll_loop(ir_loop *const loop, unsigned factor, unsigned const maxsize, size_t const n_nodes)
 {
 	ir_node *const header = get_loop_header(loop);
 	if (header == NULL) {
@@ -557,8 +593,11 @@ static bool unroll_loop(ir_loop *const loop, unsigned factor)
 
 	DB((dbg, LEVEL_4, "\tidentified loop header %+F\n", header));
 
+	unsigned max_full;
+	get_unroll_limits(loop, header, n_nodes, maxsize, &factor, &max_full);
+
 	bool fully_unroll = false;
-	factor = find_suitable_factor(header, factor, &fully_unroll);
+	factor = find_suitable_factor(header, factor, max_full, &fully_unroll);
 	if (factor < 1 || (factor == 1 && !fully_unroll)) {
 		return false;
 	}
@@ -645,8 +684,9 @@ static bool duplicate_innermost_loops(ir_loop *const loop, unsigned const factor
 	// found innermost loop, try to unroll
 	if (innermost && !container) {
 		DB((dbg, LEVEL_3, "inspect %+F\n", loop));
-		if (count_nodes(loop) <= maxsize) {
-			return unroll_loop(loop, factor);
+		size_t const n_nodes = count_nodes(loop);
+		if (n_nodes <= maxsize) {
+			return unroll_loop(loop, factor, maxsize, n_nodes);
 		} else {
 			DB((dbg, LEVEL_3, "\ttoo many nodes in %+F, skip\n", loop));
 		}
@@ -24,6 +24,7 @@
 #include "iropt.h"
 #include "iroptimize.h"
 #include "irouts_t.h"
+#include "irtrace_t.h"
 #include "panic.h"
 #include "raw_bitset.h"
 #include "type_t.h"
@@ -1754,6 +1755,7 @@ void opt_ldst(ir_graph *irg)
 	block_t *bl;
 
 	FIRM_DBG_REGISTER(dbg, "firm.opt.ldst");
+	ir_trace_push("opt_ldst", irg);
 
 	DB((dbg, LEVEL_1, "\nDoing Load/Store optimization on %+F\n", irg));
 
@@ -1768,6 +1770,8 @@ void opt_ldst(ir_graph *irg)
 		get_irg_memory_disambiguator_options(irg);
 	if ((opts & aa_opt_always_alias) == 0) {
 		assure_irp_globals_entity_usage_computed();
+		if (opts & aa_opt_points_to)
+			assure_irp_points_to_computed();
 	}
 
 	obstack_init(&env.obst);
@@ -1883,4 +1887,5 @@ no_changes:
 #ifdef DEBUG_libfirm
 	DEL_ARR_F(env.id_2_address);
 #endif
+	ir_trace_pop();
 }
@@ -101,9 +101,12 @@ void remove_unreachable_code(ir_graph *irg)
 	irg_walk_graph(irg, unreachable_to_bad, NULL, &changed);
 	changed |= remove_unreachable_keeps(irg);
 
+	/* Only edges leaving dead code were removed, which does not change the
+	 * dominance relation, see ir_dom_delete_edge(). */
 	confirm_irg_properties(irg, changed
 		? IR_GRAPH_PROPERTY_NO_CRITICAL_EDGES
 		| IR_GRAPH_PROPERTY_NO_TUPLES
+		| IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE
 		| IR_GRAPH_PROPERTY_ONE_RETURN
 		| IR_GRAPH_PROPERTY_MANY_RETURNS
 		: IR_GRAPH_PROPERTIES_ALL);
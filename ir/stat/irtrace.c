@@ -0,0 +1,189 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2012 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       Hierarchical compile time tracing in Chrome trace format.
+ */
+#define _POSIX_C_SOURCE 200112L
+#include "irtrace_t.h"
+
+#include "typerep.h"
+#include "irgraph.h"
+#include "util.h"
+#include <stdio.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#define MAX_SPANS 256
+
+int (ir_trace_enabled) = 0;
+
+static FILE               *trace_file;
+static bool                trace_first_event;
+/** Number of open spans, including the ones dropped beyond MAX_SPANS. */
+static unsigned            trace_depth;
+/** Number of spans dropped because they were nested too deeply. */
+static unsigned            trace_dropped;
+static const char         *trace_names[MAX_SPANS];
+static unsigned long long  trace_start;
+
+/** Returns a monotonic timestamp in nanoseconds. */
+static unsigned long long trace_now(void)
+{
+#if defined(_WIN32)
+	LARGE_INTEGER freq;
+	LARGE_INTEGER count;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+	return (unsigned long long)((double)count.QuadPart * 1e9
+	                            / (double)freq.QuadPart);
+#elif defined(_POSIX_TIMERS) && _POSIX_TIMERS > 0 && defined(CLOCK_MONOTONIC)
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ULL
+	     + (unsigned long long)ts.tv_nsec;
+#else
+	struct timeval tval;
+	gettimeofday(&tval, NULL);
+	return (unsigned long long)tval.tv_sec * 1000000000ULL
+	     + (unsigned long long)tval.tv_usec * 1000ULL;
+#endif
+}
+
+/** Writes @p str as JSON string literal. */
+static void trace_print_string(const char *str)
+{
+	putc('"', trace_file);
+	for (const char *c = str; *c != '\0'; ++c) {
+		unsigned char ch = (unsigned char)*c;
+		if (ch == '"' || ch == '\\') {
+			putc('\\', trace_file);
+			putc(ch, trace_file);
+		} else if (ch < 0x20) {
+			fprintf(trace_file, "\\u%04x", ch);
+		} else {
+			putc(ch, trace_file);
+		}
+	}
+	putc('"', trace_file);
+}
+
+static void trace_print_event(char phase, const char *name,
+                              const ir_graph *irg)
+{
+	/* take the timestamp first so the output time is not attributed to the
+	 * span */
+	unsigned long long now = trace_now() - trace_start;
+
+	if (!trace_first_event)
+		fputs(",\n", trace_file);
+	trace_first_event = false;
+
+	fputs("{\"name\":", trace_file);
+	trace_print_string(name);
+	fprintf(trace_file, ",\"cat\":\"firm\",\"ph\":\"%c\",\"ts\":%llu.%03u,"
+	        "\"pid\":1,\"tid\":1", phase, now / 1000,
+	        (unsigned)(now % 1000));
+	if (irg != NULL) {
+		fputs(",\"args\":{\"irg\":", trace_file);
+		trace_print_string(get_entity_ld_name(get_irg_entity(irg)));
+		putc('}', trace_file);
+	}
+	putc('}', trace_file);
+}
+
+void do_ir_trace_push(const char *name, const ir_graph *irg)
+{
+	/* spans nested too deeply are only counted, so their pops stay
+	 * balanced */
+	if (trace_depth < ARRAY_SIZE(trace_names)) {
+		trace_names[trace_depth] = name;
+		trace_print_event('B', name, irg);
+	} else {
+		++trace_dropped;
+	}
+	++trace_depth;
+}
+
+void (ir_trace_push)(const char *name, const ir_graph *irg)
+{
+	ir_trace_push_(name, irg);
+}
+
+void do_ir_trace_pop(void)
+{
+	/* ignore pops of spans opened before tracing started */
+	if (trace_depth == 0)
+		return;
+	--trace_depth;
+	if (trace_depth < ARRAY_SIZE(trace_names))
+		trace_print_event('E', trace_names[trace_depth], NULL);
+}
+
+void (ir_trace_pop)(void)
+{
+	ir_trace_pop_();
+}
+
+/** Closes the recorded open spans in the output and closes the trace file. */
+static void trace_finish_file(void)
+{
+	for (unsigned i = MIN(trace_depth, ARRAY_SIZE(trace_names)); i-- > 0;)
+		trace_print_event('E', trace_names[i], NULL);
+	fputs("\n]\n", trace_file);
+	fclose(trace_file);
+	trace_file = NULL;
+}
+
+int ir_trace_begin(const char *filename)
+{
+	FILE *const file = fopen(filename, "wt");
+	if (file == NULL) {
+		fprintf(stderr, "Warning: Couldn't create trace output '%s'\n",
+		        filename);
+		return 1;
+	}
+
+	/* A running trace is continued in the new file: The spans open right
+	 * now are closed in the old file and reopened in the new one, so the
+	 * pops of their owners still match. */
+	if (trace_file != NULL)
+		trace_finish_file();
+
+	trace_file        = file;
+	trace_first_event = true;
+	trace_start       = trace_now();
+	fputs("[\n", trace_file);
+	for (unsigned i = 0, n = MIN(trace_depth, ARRAY_SIZE(trace_names));
+	     i < n; ++i) {
+		trace_print_event('B', trace_names[i], NULL);
+	}
+	ir_trace_enabled = 1;
+	return 0;
+}
+
+void ir_trace_end(void)
+{
+	if (trace_file == NULL)
+		return;
+
+	trace_finish_file();
+	if (trace_dropped > 0) {
+		fprintf(stderr, "Warning: Dropped %u trace spans nested deeper "
+		        "than %d\n", trace_dropped, MAX_SPANS);
+	}
+	/* the remaining pops arrive while tracing is disabled */
+	trace_depth      = 0;
+	trace_dropped    = 0;
+	ir_trace_enabled = 0;
+}
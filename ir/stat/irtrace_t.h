@@ -0,0 +1,35 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2012 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       Hierarchical compile time tracing.
+ */
+#ifndef FIRM_STAT_IRTRACE_T_H
+#define FIRM_STAT_IRTRACE_T_H
+
+#include "irtrace.h"
+
+void do_ir_trace_push(const char *name, const ir_graph *irg);
+void do_ir_trace_pop(void);
+
+static inline void ir_trace_push_(const char *name, const ir_graph *irg)
+{
+	if (!ir_trace_enabled)
+		return;
+	do_ir_trace_push(name, irg);
+}
+
+static inline void ir_trace_pop_(void)
+{
+	if (!ir_trace_enabled)
+		return;
+	do_ir_trace_pop();
+}
+
+#define ir_trace_push(name, irg) ir_trace_push_(name, irg)
+#define ir_trace_pop()           ir_trace_pop_()
+
+#endif
@@ -182,6 +182,7 @@ struct ir_entity {
 	ir_type *type;           /**< The type of this entity */
 	ir_type *owner;          /**< The compound type (e.g. class type) this
 	                              entity belongs to. */
+	size_t member_index;     /**< Index in the member array of the owner. */
 	ENUMBF(ir_entity_kind)  kind:3;        /**< entity kind */
 	ENUMBF(ir_linkage)      linkage:7;     /**< Linkage type */
 	ENUMBF(ir_volatility)   volatility:1;  /**< Volatility of entity content.*/
@@ -44,6 +44,7 @@
 #include "xmalloc.h"
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -316,7 +317,9 @@ static void compound_init(ir_type *const type, ident *const name)
 {
 	type->flags                |= tf_compound;
 	type->name                  = name;
-	type->attr.compound.members = NEW_ARR_F(ir_entity*, 0);
+	type->attr.compound.members       = NEW_ARR_F(ir_entity*, 0);
+	type->attr.compound.n_removed     = 0;
+	type->attr.compound.first_removed = SIZE_MAX;
 }
 
 void free_compound_attrs(ir_type *type)
@@ -793,13 +796,47 @@ size_t get_compound_member_index(ir_type const *const type,
                                  ir_entity const *const entity)
 {
 	assert(is_compound_type(type));
-	for (size_t i = 0, n = get_compound_n_members(type); i < n; ++i) {
-		if (get_compound_member(type, i) == entity)
-			return i;
-	}
+	compound_attr const *const attr = &type->attr.compound;
+	if (entity->member_index >= attr->first_removed)
+		compact_compound_members((ir_type*)type);
+	size_t const index = entity->member_index;
+	if (index < ARR_LEN(attr->members) && attr->members[index] == entity)
+		return index;
 	return INVALID_MEMBER_INDEX;
 }
 
+void compact_compound_members(ir_type *type)
+{
+	compound_attr *const attr = &type->attr.compound;
+	if (attr->n_removed == 0)
+		return;
+
+	ir_entity **const members = attr->members;
+	size_t            n       = attr->first_removed;
+	for (size_t i = n + 1, n_members = ARR_LEN(members); i < n_members; ++i) {
+		ir_entity *const member = members[i];
+		if (member == NULL)
+			continue;
+		member->member_index = n;
+		members[n++]         = member;
+	}
+	ARR_SETLEN(ir_entity*, attr->members, n);
+	attr->n_removed     = 0;
+	attr->first_removed = SIZE_MAX;
+}
+
+void sort_compound_members(ir_type *type,
+                           int (*cmp)(void const *p0, void const *p1))
+{
+	assert(is_compound_type(type));
+	compact_compound_members(type);
+	ir_entity **const members   = type->attr.compound.members;
+	size_t      const n_members = ARR_LEN(members);
+	QSORT(members, n_members, cmp);
+	for (size_t i = 0; i < n_members; ++i)
+		members[i]->member_index = i;
+}
+
 int is_compound_type(const ir_type *tp)
 {
 	assert(tp->kind == k_type);
@@ -822,26 +859,33 @@ const char *get_compound_name(const ir_type *tp)
 void remove_compound_member(ir_type *type, ir_entity *member)
 {
 	assert(is_compound_type(type));
-	for (size_t i = 0, n = ARR_LEN(type->attr.compound.members); i < n; ++i) {
-		if (get_compound_member(type, i) != member)
-			continue;
-		for (; i < n - 1; ++i)
-			type->attr.compound.members[i] = type->attr.compound.members[i+1];
-		ARR_SETLEN(ir_entity*, type->attr.compound.members, n-1);
-		/* members of global type must also be removed from map */
-		if (is_segment_type(type) && !(type->flags & tf_info)
-		 && get_entity_visibility(member) != ir_visibility_private) {
-			pmap *globals = irp->globals;
-			pmap_insert(globals, get_entity_ld_ident(member), NULL);
-		}
-		break;
+	compound_attr *const attr  = &type->attr.compound;
+	size_t         const index = member->member_index;
+	size_t         const n     = ARR_LEN(attr->members);
+	if (index >= n || attr->members[index] != member)
+		return;
+
+	/* leave a gap which is closed lazily to keep the member order */
+	if (index == n - 1 && attr->n_removed == 0) {
+		ARR_SETLEN(ir_entity*, attr->members, n - 1);
+	} else {
+		attr->members[index] = NULL;
+		++attr->n_removed;
+		if (index < attr->first_removed)
+			attr->first_removed = index;
+	}
+	/* members of global type must also be removed from map */
+	if (is_segment_type(type) && !(type->flags & tf_info)
+	 && get_entity_visibility(member) != ir_visibility_private) {
+		pmap *globals = irp->globals;
+		pmap_insert(globals, get_entity_ld_ident(member), NULL);
 	}
 }
 
 void add_compound_member(ir_type *type, ir_entity *entity)
 {
 	assert(is_compound_type(type));
-	/* try to detect double-add */
+	entity->member_index = ARR_LEN(type->attr.compound.members);
 	ARR_APP1(ir_entity *, type->attr.compound.members, entity);
 	/* Add segment members to globals map. */
 	if (is_segment_type(type) && !(type->flags & tf_info)
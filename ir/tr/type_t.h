@@ -50,7 +50,11 @@
 
 /** Compound type attributes. */
 typedef struct {
-	ir_entity **members;
+	ir_entity **members;       /**< The members, removed ones are NULL until
+	                                the array is compacted. */
+	size_t      n_removed;     /**< Number of removed members in the array. */
+	size_t      first_removed; /**< Index of the first removed member or
+	                                SIZE_MAX. */
 } compound_attr;
 
 /** Class type attributes. */
@@ -127,6 +131,7 @@ struct ir_type {
 	void *link;              /**< holds temporary data - like in irnode_t.h */
 	type_dbg_info *dbi;      /**< A pointer to information for debug support. */
 	long nr;                 /**< A unique number for each type. */
+	size_t irp_index;        /**< Position in the type list of irp. */
 	union {
 		compound_attr compound;
 		class_attr    cls;
@@ -145,6 +150,16 @@ void free_method_attrs(ir_type *method);
 
 void add_compound_member(ir_type *compound, ir_entity *entity);
 
+/** Closes the gaps left by removed members of a compound type. */
+void compact_compound_members(ir_type *type);
+
+/**
+ * Sorts the members of a compound type with the qsort() compare function
+ * @p cmp, which is passed pointers to ir_entity pointers.
+ */
+void sort_compound_members(ir_type *type,
+                           int (*cmp)(void const *p0, void const *p1));
+
 /** Initialize the type module. */
 void ir_init_type(ir_prog *irp);
 
@@ -253,7 +268,7 @@ static inline int is_class_type_(const ir_type *type)
 static inline size_t get_compound_n_members_(const ir_type *type)
 {
 	assert(is_compound_type(type));
-	return ARR_LEN(type->attr.compound.members);
+	return ARR_LEN(type->attr.compound.members) - type->attr.compound.n_removed;
 }
 
 static inline ir_entity *get_compound_member_(ir_type const *const type,
@@ -261,6 +276,9 @@ static inline ir_entity *get_compound_member_(ir_type const *const type,
 {
 	assert(is_compound_type(type));
 	assert(pos < get_compound_n_members(type));
+	/* positions in front of the first removed member are still valid */
+	if (pos >= type->attr.compound.first_removed)
+		compact_compound_members((ir_type*)type);
 	return type->attr.compound.members[pos];
 }
 
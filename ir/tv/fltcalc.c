@@ -15,6 +15,7 @@
 #include "strcalc.h"
 #include "xmalloc.h"
 #include <assert.h>
+#include <fenv.h>
 #include <float.h>
 #include <inttypes.h>
 #include <limits.h>
@@ -27,6 +28,20 @@
 /** The number of extra precision rounding bits */
 #define ROUNDING_BITS 2
 
+/* Host float and double can be used for constant folding if they are IEEE
+ * binary32/binary64, are evaluated in their own precision and all rounding
+ * modes are available. fc_val_to_bytes() produces little endian bytes, which
+ * are copied into the host values directly. */
+#if FLT_RADIX == 2 && FLT_MANT_DIG == 24 && DBL_MANT_DIG == 53 \
+ && defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0 \
+ && defined(FE_TONEAREST) && defined(FE_UPWARD) && defined(FE_DOWNWARD) \
+ && defined(FE_TOWARDZERO) && defined(FE_INEXACT) \
+ && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define HOST_IEEE754 1
+#else
+#define HOST_IEEE754 0
+#endif
+
 /* our floating point value */
 struct fp_value {
 	float_descriptor_t desc;
@@ -51,6 +66,9 @@ static unsigned max_precision;
 /** Exact flag. */
 static bool fc_exact = true;
 
+/** Use the host floating point unit where possible. */
+static bool host_arith = HOST_IEEE754;
+
 static float_descriptor_t long_double_desc;
 
 /** pack machine-like */
@@ -131,7 +149,7 @@ static bool normalize(fp_value *val, bool sticky)
 
 	/* check for exponent underflow */
 	if (sc_is_negative(_exp(val))
-	 || sc_is_zero(_exp(val), value_size)) {
+	 || sc_is_zero(_exp(val), value_size*SC_BITS)) {
 		/* exponent underflow */
 		/* shift the mantissa right to have a zero exponent */
 		sc_val_from_ulong(1, temp);
@@ -190,7 +208,7 @@ static bool normalize(fp_value *val, bool sticky)
 	}
 
 	/* could have rounded down to zero */
-	if (sc_is_zero(_mant(val), value_size)
+	if (sc_is_zero(_mant(val), value_size*SC_BITS)
 	    && (val->clss == FC_SUBNORMAL))
 		val->clss = FC_ZERO;
 
@@ -233,17 +251,18 @@ static bool normalize(fp_value *val, bool sticky)
 		 * TO_ZERO     |      +        |   largest representable value
 		 *             |      -        |   smallest representable value
 		 *--------------------------------------------------------------*/
+		bool to_inf = false;
 		switch (rounding_mode) {
-		case FC_TONEAREST:
-		case FC_TOPOSITIVE:
+		case FC_TONEAREST:  to_inf = true;       break;
+		case FC_TOPOSITIVE: to_inf = !val->sign; break;
+		case FC_TONEGATIVE: to_inf = val->sign;  break;
+		case FC_TOZERO:     to_inf = false;      break;
+		}
+		if (to_inf)
 			fc_get_inf(&val->desc, val, val->sign);
-			break;
-
-		case FC_TONEGATIVE:
-		case FC_TOZERO:
+		else
 			fc_get_max(&val->desc, val, val->sign);
-			break;
-		}
+		exact = false;
 	}
 	return exact;
 }
@@ -284,6 +303,127 @@ static void fc_get_qnan(const float_descriptor_t *desc, fp_value *result)
 	fc_get_nan(desc, result, false, NULL);
 }
 
+typedef enum host_op_t {
+	HOST_ADD,
+	HOST_SUB,
+	HOST_MUL,
+	HOST_DIV,
+} host_op_t;
+
+#if HOST_IEEE754
+static bool is_finite(const fp_value *a)
+{
+	return a->clss == FC_NORMAL || a->clss == FC_ZERO
+	    || a->clss == FC_SUBNORMAL;
+}
+
+static float host_float_op(host_op_t op, float a, float b)
+{
+	volatile float va = a;
+	volatile float vb = b;
+	volatile float res;
+	switch (op) {
+	case HOST_ADD: res = va + vb; break;
+	case HOST_SUB: res = va - vb; break;
+	case HOST_MUL: res = va * vb; break;
+	case HOST_DIV: res = va / vb; break;
+	}
+	return res;
+}
+
+static double host_double_op(host_op_t op, double a, double b)
+{
+	volatile double va = a;
+	volatile double vb = b;
+	volatile double res;
+	switch (op) {
+	case HOST_ADD: res = va + vb; break;
+	case HOST_SUB: res = va - vb; break;
+	case HOST_MUL: res = va * vb; break;
+	case HOST_DIV: res = va / vb; break;
+	}
+	return res;
+}
+#endif
+
+/**
+ * Calculates a binary operation with the host floating point unit in the
+ * current rounding mode. This is only done for finite single and double
+ * precision operands; NaN results and division by zero are left to the
+ * software implementation, which defines their exact encoding.
+ *
+ * @return true if the result has been computed
+ */
+static bool host_binop(host_op_t op, const fp_value *a, const fp_value *b,
+                       fp_value *result)
+{
+#if HOST_IEEE754
+	if (!host_arith || !is_finite(a) || !is_finite(b))
+		return false;
+	if (op == HOST_DIV && b->clss == FC_ZERO)
+		return false;
+
+	const float_descriptor_t desc = a->desc;
+	if (desc.explicit_one)
+		return false;
+	bool const is_float  = desc.exponent_size == 8  && desc.mantissa_size == 23;
+	bool const is_double = desc.exponent_size == 11 && desc.mantissa_size == 52;
+	if (!is_float && !is_double)
+		return false;
+
+	static const int host_rounding[] = {
+		[FC_TONEAREST]  = FE_TONEAREST,
+		[FC_TOPOSITIVE] = FE_UPWARD,
+		[FC_TONEGATIVE] = FE_DOWNWARD,
+		[FC_TOZERO]     = FE_TOWARDZERO,
+	};
+	/* keep the floating point environment of our user intact */
+	fenv_t env;
+	if (feholdexcept(&env) != 0)
+		return false;
+	if (fesetround(host_rounding[rounding_mode]) != 0) {
+		fesetenv(&env);
+		return false;
+	}
+
+	unsigned char buf_a[sizeof(double)];
+	unsigned char buf_b[sizeof(double)];
+	unsigned char buf_res[sizeof(double)];
+	fc_val_to_bytes(a, buf_a);
+	fc_val_to_bytes(b, buf_b);
+	bool is_nan;
+	if (is_float) {
+		float fa, fb;
+		memcpy(&fa, buf_a, sizeof(fa));
+		memcpy(&fb, buf_b, sizeof(fb));
+		float const res = host_float_op(op, fa, fb);
+		is_nan = isnan(res);
+		memcpy(buf_res, &res, sizeof(res));
+	} else {
+		double da, db;
+		memcpy(&da, buf_a, sizeof(da));
+		memcpy(&db, buf_b, sizeof(db));
+		double const res = host_double_op(op, da, db);
+		is_nan = isnan(res);
+		memcpy(buf_res, &res, sizeof(res));
+	}
+	bool const inexact = fetestexcept(FE_INEXACT) != 0;
+	fesetenv(&env);
+
+	if (is_nan)
+		return false;
+	fc_val_from_bytes(result, buf_res, &desc);
+	fc_exact = !inexact;
+	return true;
+#else
+	(void)op;
+	(void)a;
+	(void)b;
+	(void)result;
+	return false;
+#endif
+}
+
 /**
  * calculate a + b, where a is the value with the bigger exponent
  */
@@ -389,11 +529,34 @@ static void _fadd(const fp_value *a, const fp_value *b, fp_value *result)
 	fc_exact &= normalize(result, sticky);
 }
 
+/**
+ * Returns a value equal to @p a whose mantissa has the leading one left of
+ * the radix point. Subnormals are stored with an exponent of zero (meaning
+ * an effective exponent of one) and leading zeros in the mantissa; they are
+ * copied to @p temp with a shifted mantissa and a possibly negative exponent.
+ */
+static const fp_value *normalize_subnormal(const fp_value *a, fp_value *temp)
+{
+	if (a->clss != FC_SUBNORMAL)
+		return a;
+
+	const float_descriptor_t *desc = &a->desc;
+	int radix = ROUNDING_BITS + desc->mantissa_size - desc->explicit_one;
+	int shift = radix - sc_get_highest_set_bit(_mant(a));
+	memcpy(temp, a, fp_value_size);
+	sc_shlI(_mant(a), shift, _mant(temp));
+	sc_val_from_long(1 - shift, _exp(temp));
+	temp->clss = FC_NORMAL;
+	return temp;
+}
+
 void fc_mul(const fp_value *a, const fp_value *b, fp_value *result)
 {
 	fc_exact = true;
 	if (handle_NAN(a, b, result))
 		return;
+	if (host_binop(HOST_MUL, a, b, result))
+		return;
 
 	if (result != a && result != b)
 		result->desc = a->desc;
@@ -440,6 +603,10 @@ void fc_mul(const fp_value *a, const fp_value *b, fp_value *result)
 		return;
 	}
 
+	/* operate on normalized mantissas to not lose precision */
+	a = normalize_subnormal(a, (fp_value*)alloca(fp_value_size));
+	b = normalize_subnormal(b, (fp_value*)alloca(fp_value_size));
+
 	/* exp = exp(a) + exp(b) - excess */
 	sc_add(_exp(a), _exp(b), _exp(result));
 
@@ -447,10 +614,6 @@ void fc_mul(const fp_value *a, const fp_value *b, fp_value *result)
 	sc_val_from_ulong((1 << (a->desc.exponent_size - 1)) - 1, temp);
 	sc_sub(_exp(result), temp, _exp(result));
 
-	/* mixed normal, subnormal values introduce an error of 1, correct it */
-	if ((a->clss == FC_SUBNORMAL) ^ (b->clss == FC_SUBNORMAL))
-		sc_inc(_exp(result));
-
 	sc_mul(_mant(a), _mant(b), _mant(result));
 
 	/* realign result: after a multiplication the digits right of the radix
@@ -471,6 +634,8 @@ void fc_div(const fp_value *a, const fp_value *b, fp_value *result)
 	fc_exact = true;
 	if (handle_NAN(a, b, result))
 		return;
+	if (host_binop(HOST_DIV, a, b, result))
+		return;
 
 	if (result != a && result != b)
 		result->desc = a->desc;
@@ -520,16 +685,16 @@ void fc_div(const fp_value *a, const fp_value *b, fp_value *result)
 		return;
 	}
 
+	/* operate on normalized mantissas to not lose precision */
+	a = normalize_subnormal(a, (fp_value*)alloca(fp_value_size));
+	b = normalize_subnormal(b, (fp_value*)alloca(fp_value_size));
+
 	/* exp = exp(a) - exp(b) + excess - 1*/
 	sc_word *temp = ALLOCAN(sc_word, value_size);
 	sc_sub(_exp(a), _exp(b), _exp(result));
 	sc_val_from_ulong((1 << (a->desc.exponent_size - 1)) - 2, temp);
 	sc_add(_exp(result), temp, _exp(result));
 
-	/* mixed normal, subnormal values introduce an error of 1, correct it */
-	if ((a->clss == FC_SUBNORMAL) ^ (b->clss == FC_SUBNORMAL))
-		sc_inc(_exp(result));
-
 	/* mant(res) = mant(a) / 1/2mant(b) */
 	/* to gain more bits of precision in the result the dividend could be
 	 * shifted left, as this operation does not loose bits. This would not
@@ -631,8 +796,8 @@ void fc_val_from_bytes(fp_value *result, const unsigned char *buffer,
 	sc_shlI(_mant(result), ROUNDING_BITS, _mant(result));
 
 	/* check for special values */
-	if (sc_is_zero(_exp(result), value_size)) {
-		if (sc_is_zero(_mant(result), value_size)) {
+	if (sc_is_zero(_exp(result), value_size*SC_BITS)) {
+		if (sc_is_zero(_mant(result), value_size*SC_BITS)) {
 			result->clss = FC_ZERO;
 		} else {
 			result->clss = FC_SUBNORMAL;
@@ -1049,6 +1214,13 @@ fc_rounding_mode_t fc_get_rounding_mode(void)
 	return rounding_mode;
 }
 
+bool fc_set_host_arith(bool enable)
+{
+	bool old   = host_arith;
+	host_arith = enable && HOST_IEEE754;
+	return old;
+}
+
 void init_fltcalc(unsigned precision)
 {
 #ifndef NDEBUG
@@ -1085,6 +1257,8 @@ void fc_add(const fp_value *a, const fp_value *b, fp_value *result)
 	fc_exact = true;
 	if (handle_NAN(a, b, result))
 		return;
+	if (host_binop(HOST_ADD, a, b, result))
+		return;
 
 	/* make the value with the bigger exponent the first one */
 	if (sc_comp(_exp(a), _exp(b)) == ir_relation_less)
@@ -1098,6 +1272,8 @@ void fc_sub(const fp_value *a, const fp_value *b, fp_value *result)
 	fc_exact = true;
 	if (handle_NAN(a, b, result))
 		return;
+	if (host_binop(HOST_SUB, a, b, result))
+		return;
 
 	fp_value *temp = (fp_value*) alloca(fp_value_size);
 	memcpy(temp, b, fp_value_size);
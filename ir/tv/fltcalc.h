@@ -203,6 +203,17 @@ fc_rounding_mode_t fc_set_rounding_mode(fc_rounding_mode_t mode);
  */
 fc_rounding_mode_t fc_get_rounding_mode(void);
 
+/**
+ * Enables or disables computing fc_add(), fc_sub(), fc_mul() and fc_div()
+ * with the host floating point unit. This is only done for IEEE single and
+ * double precision values when the host supports it; the software
+ * implementation is used otherwise.
+ *
+ * @param enable  true to allow host arithmetic
+ * @return the previous setting
+ */
+bool fc_set_host_arith(bool enable);
+
 /** Get bit representation of a value
  * This function allows to read a value in encoded form, byte wise.
  * The value will be packed corresponding to the way used by the IEEE
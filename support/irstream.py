@@ -0,0 +1,144 @@
+#! /usr/bin/env python
+#
+# This file is part of libFirm.
+# Copyright (C) 2012 Karlsruhe Institute of Technology.
+"""Rebuilds graphs from .irstream files written by dump_ir_graph_stream()
+and converts them to vcg or dot."""
+import sys
+import optparse
+
+
+class Node:
+    def __init__(self, fields):
+        self.idx = int(fields[1])
+        self.op = fields[2]
+        self.mode = fields[3]
+        self.block = parse_idx(fields[4])
+        arity = int(fields[5])
+        self.ins = [parse_idx(f) for f in fields[6:6 + arity]]
+        self.label = " ".join(fields[6 + arity:])
+
+
+def parse_idx(field):
+    if field == "-":
+        return None
+    return int(field)
+
+
+def read_dumps(stream):
+    """Yields (number, name, nodes) for every dump in the stream; nodes maps
+    node indices to the state of the graph after that dump."""
+    nodes = {}
+    header = None
+    for line in stream:
+        line = line.rstrip("\n")
+        if line.startswith("dump "):
+            if header is not None:
+                yield header[0], header[1], nodes
+            fields = line.split(" ", 3)
+            if fields[2] == "full":
+                nodes = {}
+            header = (int(fields[1]), fields[3] if len(fields) > 3 else "")
+        elif line.startswith("n "):
+            node = Node(line.split(" "))
+            nodes[node.idx] = node
+        elif line.startswith("d "):
+            del nodes[int(line[2:])]
+        elif line != "":
+            raise ValueError("invalid record: %s" % line)
+    if header is not None:
+        yield header[0], header[1], nodes
+
+
+def quote(string):
+    return '"%s"' % string.replace("\\", "\\\\").replace('"', '\\"')
+
+
+def write_dot(out, title, nodes):
+    out.write("digraph %s {\n" % quote(title))
+    for idx in sorted(nodes):
+        node = nodes[idx]
+        shape = "box" if node.op == "Block" else "ellipse"
+        out.write("\tn%d [label=%s shape=%s];\n"
+                  % (idx, quote(node.label), shape))
+    for idx in sorted(nodes):
+        node = nodes[idx]
+        if node.block is not None and node.block in nodes:
+            out.write("\tn%d -> n%d [style=dotted];\n" % (idx, node.block))
+        for pos, pred in enumerate(node.ins):
+            if pred is not None and pred in nodes:
+                out.write("\tn%d -> n%d [label=%d];\n" % (idx, pred, pos))
+    out.write("}\n")
+
+
+def write_vcg(out, title, nodes):
+    out.write("graph: { title: %s\n" % quote(title))
+    out.write("display_edge_labels: yes\nlayoutalgorithm: mindepth\n")
+    out.write("manhattan_edges: yes\nport_sharing: no\norientation: bottom_to_top\n")
+    for idx in sorted(nodes):
+        node = nodes[idx]
+        out.write("node: { title: \"n%d\" label: %s }\n"
+                  % (idx, quote(node.label)))
+    for idx in sorted(nodes):
+        node = nodes[idx]
+        if node.block is not None and node.block in nodes:
+            out.write("edge: { sourcename: \"n%d\" targetname: \"n%d\" "
+                      "label: \"-1\" class: 2 }\n" % (idx, node.block))
+        for pos, pred in enumerate(node.ins):
+            if pred is not None and pred in nodes:
+                out.write("edge: { sourcename: \"n%d\" targetname: \"n%d\" "
+                          "label: \"%d\" }\n" % (idx, pred, pos))
+    out.write("}\n")
+
+
+def main():
+    parser = optparse.OptionParser(
+        usage="%prog [options] file.irstream",
+        description="Rebuilds the graph after a dump of an irstream file.")
+    parser.add_option("-l", "--list", action="store_true",
+                      help="list the dumps in the file")
+    parser.add_option("-n", "--dump", type="int", default=None,
+                      help="select dump by number (default: last one)")
+    parser.add_option("-s", "--suffix", default=None,
+                      help="select the first dump with the given name")
+    parser.add_option("-f", "--format", choices=["vcg", "dot"],
+                      default="vcg", help="output format (vcg or dot)")
+    parser.add_option("-o", "--output", default=None,
+                      help="output file (default: stdout)")
+    (options, args) = parser.parse_args()
+    if len(args) != 1:
+        parser.error("expected exactly one input file")
+
+    selected = None
+    with open(args[0]) as stream:
+        for number, name, nodes in read_dumps(stream):
+            if options.list:
+                print("%3d %-30s %d nodes" % (number, name, len(nodes)))
+                continue
+            if options.dump is not None and number != options.dump:
+                continue
+            if options.suffix is not None and name != options.suffix:
+                continue
+            selected = (number, name, dict(nodes))
+            if options.dump is not None or options.suffix is not None:
+                break
+    if options.list:
+        return
+    if selected is None:
+        sys.stderr.write("no matching dump found\n")
+        sys.exit(1)
+
+    out = sys.stdout
+    if options.output is not None:
+        out = open(options.output, "w")
+    title = "%s-%02d-%s" % (args[0], selected[0], selected[1])
+    if options.format == "dot":
+        write_dot(out, title, selected[2])
+    else:
+        write_vcg(out, title, selected[2])
+    if out is not sys.stdout:
+        out.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,39 @@
+#include "firm.h"
+#include "testgraph.h"
+#include "util.h"
+#include <assert.h>
+
+/* Builds int f(int x) { return x + 1, x + 1; } with duplicate Const and Add
+ * nodes in bulk mode and checks that finalizing merges them. */
+int main(void)
+{
+	ir_init();
+
+	ir_graph *const irg = new_test_graph("bulk", 1, 2, 0);
+	irg_begin_bulk_cons(irg);
+
+	ir_node *const block = get_irg_start_block(irg);
+	ir_node *const x     = new_r_Proj(get_irg_args(irg), mode_Is, 0);
+	ir_node *const one0  = new_r_Const_long(irg, mode_Is, 1);
+	ir_node *const one1  = new_r_Const_long(irg, mode_Is, 1);
+	/* no CSE during bulk construction */
+	assert(one0 != one1);
+	ir_node *const add0  = new_r_Add(block, x, one0);
+	ir_node *const add1  = new_r_Add(block, x, one1);
+	assert(add0 != add1);
+	ir_node *const res[] = { add0, add1 };
+	ir_node *const mem   = get_irg_initial_mem(irg);
+	ir_node *const ret   = new_r_Return(block, mem, ARRAY_SIZE(res), res);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+
+	irg_finalize_bulk_cons(irg);
+
+	assert(!irg_is_constrained(irg, IR_GRAPH_CONSTRAINT_CONSTRUCTION));
+	ir_node *const res0 = get_Return_res(ret, 0);
+	ir_node *const res1 = get_Return_res(ret, 1);
+	assert(is_Add(res0));
+	assert(res0 == res1);
+	assert(get_Add_right(res0) == one0 || get_Add_right(res0) == one1);
+	assert(irg_verify(irg));
+	return 0;
+}
@@ -0,0 +1,152 @@
+#include "firm.h"
+#include "testgraph.h"
+#include "dfs_t.h"
+#include "irdom_t.h"
+#include "iredges_t.h"
+#include "irloop_t.h"
+#include <assert.h>
+
+/* The control flow is a chain of N_BLOCKS blocks, which gives a dominator
+ * tree and a DFS tree of depth N_BLOCKS. The last blocks form N_LOOPS nested
+ * loops: loop k has the header LOOP_HEAD(k) and the back edge from
+ * LOOP_TAIL(k), loop 0 is the outermost one. */
+#define N_BLOCKS     50000
+#define N_LOOPS      1000
+#define LOOP_HEAD(k) (N_BLOCKS - 2 * N_LOOPS - 1 + (k))
+#define LOOP_TAIL(k) (N_BLOCKS - 2 - (k))
+
+static ir_node *blocks[N_BLOCKS];
+
+static ir_graph *build_deep_cfg(void)
+{
+	ir_graph *const irg = new_test_graph("deep_cfg", 1, 0, 0);
+
+	ir_node *const args = get_irg_args(irg);
+	ir_node *const arg  = new_Proj(args, mode_Is, 0);
+	ir_node *const zero = new_Const_long(mode_Is, 0);
+	ir_node *const cmp  = new_Cmp(arg, zero, ir_relation_less);
+
+	for (int i = 0; i < N_BLOCKS; ++i)
+		blocks[i] = new_immBlock();
+	add_immBlock_pred(blocks[0], new_Jmp());
+	mature_immBlock(get_cur_block());
+
+	for (int i = 0; i < N_BLOCKS - 1; ++i) {
+		set_cur_block(blocks[i]);
+		if (i < LOOP_TAIL(N_LOOPS - 1)) {
+			add_immBlock_pred(blocks[i + 1], new_Jmp());
+			continue;
+		}
+		ir_node *const cond = new_Cond(cmp);
+		add_immBlock_pred(blocks[i + 1], new_Proj(cond, mode_X, pn_Cond_true));
+		add_immBlock_pred(blocks[LOOP_HEAD(LOOP_TAIL(0) - i)],
+		                  new_Proj(cond, mode_X, pn_Cond_false));
+	}
+
+	set_cur_block(blocks[N_BLOCKS - 1]);
+	ir_node *const ret = new_Return(get_irg_initial_mem(irg), 0, NULL);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+
+	for (int i = 0; i < N_BLOCKS; ++i)
+		mature_immBlock(blocks[i]);
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+	return irg;
+}
+
+typedef struct walk_env_t {
+	int n_pre;
+	int n_post;
+} walk_env_t;
+
+static void count_pre(ir_node *block, void *data)
+{
+	walk_env_t *const env = (walk_env_t*)data;
+	int         const pos = env->n_pre++ - 1;
+	/* the dominator tree is a path: Start block, the chain, End block */
+	assert(pos < 0 || pos >= N_BLOCKS || blocks[pos] == block);
+}
+
+static void count_post(ir_node *block, void *data)
+{
+	(void)block;
+	walk_env_t *const env = (walk_env_t*)data;
+	assert(env->n_post < env->n_pre);
+	++env->n_post;
+}
+
+static void count_block(ir_node *block, void *data)
+{
+	(void)block;
+	++*(int*)data;
+}
+
+static void check_dominance(ir_graph *irg)
+{
+	compute_doms(irg);
+	int const base = get_Block_dom_depth(blocks[0]);
+	for (int i = 0; i < N_BLOCKS; ++i) {
+		assert(get_Block_dom_depth(blocks[i]) == base + i);
+		assert(i == 0 || get_Block_idom(blocks[i]) == blocks[i - 1]);
+	}
+	assert(block_dominates(blocks[0], blocks[N_BLOCKS - 1]));
+	assert(!block_dominates(blocks[N_BLOCKS - 1], blocks[0]));
+
+	walk_env_t env = { 0, 0 };
+	dom_tree_walk_irg(irg, count_pre, count_post, &env);
+	/* start block, the chain and the end block */
+	assert(env.n_pre == N_BLOCKS + 2);
+	assert(env.n_post == N_BLOCKS + 2);
+
+	compute_postdoms(irg);
+	int n_postdom = 0;
+	postdom_tree_walk_irg(irg, count_block, NULL, &n_postdom);
+	assert(n_postdom == N_BLOCKS + 2);
+	assert(block_postdominates(blocks[N_BLOCKS - 1], blocks[0]));
+}
+
+static void check_loops(ir_graph *irg)
+{
+	construct_cf_backedges(irg);
+	ir_loop *const outermost = get_irg_loop(irg);
+	assert(get_irn_loop(blocks[0]) == outermost);
+	assert(get_irn_loop(blocks[N_BLOCKS - 1]) == outermost);
+	for (int k = 0; k < N_LOOPS; ++k) {
+		ir_loop *const loop = get_irn_loop(blocks[LOOP_HEAD(k)]);
+		assert(get_loop_depth(loop) == (unsigned)k + 1);
+		assert(get_irn_loop(blocks[LOOP_TAIL(k)]) == loop);
+	}
+	ir_node *const innermost = blocks[LOOP_HEAD(N_LOOPS - 1)];
+	assert(is_loop_invariant(get_irg_args(irg), innermost));
+	assert(!is_loop_invariant(innermost, blocks[LOOP_HEAD(0)]));
+}
+
+static void check_dfs(ir_graph *irg)
+{
+	assure_edges_kind(irg, EDGE_KIND_BLOCK);
+	dfs_t *const dfs = dfs_new(irg);
+	assert(dfs_get_n_nodes(dfs) == N_BLOCKS + 2);
+	for (int i = 1; i < N_BLOCKS; ++i) {
+		assert(dfs_get_pre_num(dfs, blocks[i]) > dfs_get_pre_num(dfs, blocks[i - 1]));
+		assert(dfs_get_post_num(dfs, blocks[i]) < dfs_get_post_num(dfs, blocks[i - 1]));
+	}
+	assert(dfs_is_ancestor(dfs, blocks[0], blocks[N_BLOCKS - 1]));
+	assert(dfs_get_edge_kind(dfs, blocks[LOOP_TAIL(0)], blocks[LOOP_HEAD(0)])
+	       == DFS_EDGE_BACK);
+	dfs_free(dfs);
+}
+
+int main(void)
+{
+	ir_init();
+
+	ir_graph *const irg = build_deep_cfg();
+	int n_blocks = 0;
+	irg_block_walk_graph(irg, count_block, NULL, &n_blocks);
+	assert(n_blocks == N_BLOCKS + 2);
+
+	check_dominance(irg);
+	check_loops(irg);
+	check_dfs(irg);
+	return 0;
+}
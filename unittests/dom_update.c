@@ -0,0 +1,187 @@
+#include "firm.h"
+#include "testgraph.h"
+#include "array.h"
+#include "irdom_t.h"
+#include "util.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+
+static uint64_t rand_state = 0x2545F4914F6CDD1DULL;
+
+static unsigned next_rand(unsigned n)
+{
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 7;
+	rand_state ^= rand_state << 17;
+	return (unsigned)(rand_state % n);
+}
+
+static void add_block_pred(ir_node *block, ir_node *pred)
+{
+	int        const n  = get_Block_n_cfgpreds(block);
+	ir_node  **const in = ALLOCAN(ir_node*, n + 1);
+	for (int i = 0; i < n; ++i)
+		in[i] = get_Block_cfgpred(block, i);
+	in[n] = pred;
+	set_irn_in(block, n + 1, in);
+}
+
+static void remove_block_pred(ir_node *block, int pos)
+{
+	int        const n  = get_Block_n_cfgpreds(block);
+	ir_node  **const in = ALLOCAN(ir_node*, n - 1);
+	for (int i = 0, j = 0; i < n; ++i) {
+		if (i != pos)
+			in[j++] = get_Block_cfgpred(block, i);
+	}
+	set_irn_in(block, n - 1, in);
+}
+
+/* Applies random edge insertions, deletions and edge splits to a random CFG
+ * with n_blocks blocks. dom_init_dbg(1) compares the dominance information
+ * with a full recomputation after every update. */
+static void check_random_updates(unsigned n_blocks, unsigned n_updates)
+{
+	static unsigned n_graphs;
+	char name[32];
+	snprintf(name, sizeof(name), "random%u", n_graphs++);
+	ir_graph *const irg = new_test_graph(name, 0, 0, 1);
+
+	ir_node **blocks = NEW_ARR_F(ir_node*, n_blocks);
+	blocks[0] = get_irg_start_block(irg);
+	for (unsigned i = 1; i < n_blocks; ++i)
+		blocks[i] = new_r_immBlock(irg);
+	for (unsigned i = 1; i < n_blocks; ++i)
+		add_immBlock_pred(blocks[i], new_r_Jmp(blocks[next_rand(i)]));
+	for (unsigned i = 0; i < n_blocks; ++i) {
+		ir_node *const from = blocks[next_rand(n_blocks)];
+		ir_node *const to   = blocks[1 + next_rand(n_blocks - 1)];
+		add_immBlock_pred(to, new_r_Jmp(from));
+	}
+	ir_node *const end_block = get_irg_end_block(irg);
+	ir_node *const mem       = get_irg_initial_mem(irg);
+	ir_node *const ret       = new_r_Return(blocks[n_blocks - 1], mem, 0, NULL);
+	add_immBlock_pred(end_block, ret);
+	for (unsigned i = 1; i < n_blocks; ++i) {
+		mature_immBlock(blocks[i]);
+		keep_alive(blocks[i]);
+	}
+	mature_immBlock(end_block);
+	irg_finalize_cons(irg);
+
+	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
+	for (unsigned u = 0; u < n_updates; ++u) {
+		size_t   const n  = ARR_LEN(blocks);
+		ir_node *const to = blocks[1 + next_rand(n - 1)];
+		int      const n_preds = get_Block_n_cfgpreds(to);
+		switch (next_rand(3)) {
+		case 0: {
+			ir_node *const from = blocks[next_rand(n)];
+			add_block_pred(to, new_r_Jmp(from));
+			ir_dom_insert_edge(from, to);
+			break;
+		}
+		case 1: {
+			if (n_preds <= 1)
+				break;
+			int      const pos  = next_rand(n_preds);
+			ir_node *const from = get_Block_cfgpred_block(to, pos);
+			remove_block_pred(to, pos);
+			ir_dom_delete_edge(from, to);
+			break;
+		}
+		case 2: {
+			/* split an edge, the new block is added before its successors;
+			 * like every block it is kept alive */
+			if (n_preds == 0)
+				break;
+			int      const pos   = next_rand(n_preds);
+			ir_node *const pred  = get_Block_cfgpred(to, pos);
+			ir_node *const from  = get_nodes_block(pred);
+			ir_node *const split = new_r_Block(irg, 1, &pred);
+			ir_dom_insert_edge(from, split);
+			keep_alive(split);
+			ir_dom_insert_edge(split, end_block);
+			set_Block_cfgpred(to, pos, new_r_Jmp(split));
+			ir_dom_delete_edge(from, to);
+			ir_dom_insert_edge(split, to);
+			ARR_APP1(ir_node*, blocks, split);
+			break;
+		}
+		}
+		assert(irg_has_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE));
+	}
+	DEL_ARR_F(blocks);
+}
+
+/* Builds:
+ *   int f(int x) { int a = x < 0 ? 1 : 0; if (a == 1) return 1; return 2; }
+ * jumpthreading redirects both branches of the first condition to the
+ * returns. */
+static void check_jumpthreading(void)
+{
+	ir_graph *const irg = new_test_graph("threaded", 1, 1, 1);
+
+	ir_node *const x    = new_Proj(get_irg_args(irg), mode_Is, 0);
+	ir_node *const zero = new_Const_long(mode_Is, 0);
+	ir_node *const one  = new_Const_long(mode_Is, 1);
+	ir_node *const cond = new_Cond(new_Cmp(x, zero, ir_relation_less));
+	ir_node *const then_proj = new_Proj(cond, mode_X, pn_Cond_true);
+	ir_node *const else_proj = new_Proj(cond, mode_X, pn_Cond_false);
+	mature_immBlock(get_cur_block());
+
+	ir_node *const join = new_immBlock();
+	ir_node *const then_block = new_immBlock();
+	add_immBlock_pred(then_block, then_proj);
+	mature_immBlock(then_block);
+	set_cur_block(then_block);
+	set_value(0, one);
+	add_immBlock_pred(join, new_Jmp());
+	ir_node *const else_block = new_immBlock();
+	add_immBlock_pred(else_block, else_proj);
+	mature_immBlock(else_block);
+	set_cur_block(else_block);
+	set_value(0, zero);
+	add_immBlock_pred(join, new_Jmp());
+	mature_immBlock(join);
+
+	set_cur_block(join);
+	ir_node *const a      = get_value(0, mode_Is);
+	ir_node *const cond_a = new_Cond(new_Cmp(a, one, ir_relation_equal));
+	ir_node *const ret_blocks[] = { new_immBlock(), new_immBlock() };
+	add_immBlock_pred(ret_blocks[0], new_Proj(cond_a, mode_X, pn_Cond_true));
+	add_immBlock_pred(ret_blocks[1], new_Proj(cond_a, mode_X, pn_Cond_false));
+	for (size_t i = 0; i < ARRAY_SIZE(ret_blocks); ++i) {
+		mature_immBlock(ret_blocks[i]);
+		set_cur_block(ret_blocks[i]);
+		ir_node *const res = new_Const_long(mode_Is, i + 1);
+		ir_node *const ret = new_Return(get_store(), 1, &res);
+		add_immBlock_pred(get_irg_end_block(irg), ret);
+	}
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+
+	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
+	opt_jumpthreading(irg);
+	assert(irg_has_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE));
+	assert(irg_verify(irg));
+	/* each branch now jumps to its return directly, the join became dead */
+	assert(get_Block_dom_depth(join) < 0);
+	assert(get_Block_idom(ret_blocks[0]) == then_block);
+	assert(get_Block_idom(ret_blocks[1]) == else_block);
+}
+
+int main(void)
+{
+	ir_init();
+	dom_init_dbg(1);
+
+	static const unsigned sizes[] = { 2, 5, 20, 100 };
+	for (size_t i = 0; i < ARRAY_SIZE(sizes); ++i) {
+		for (unsigned r = 0; r < 5; ++r)
+			check_random_updates(sizes[i], 300);
+	}
+	check_jumpthreading();
+	return 0;
+}
@@ -0,0 +1,71 @@
+#include "firm.h"
+#include "testgraph.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#define STREAM_FILE "dump_stream.irstream"
+
+/* Returns whether the last dump in the stream contains a line for the node
+ * with index idx, and counts the node lines of the last dump. */
+static bool last_dump_has_node(unsigned idx, unsigned *n_lines)
+{
+	FILE *const in = fopen(STREAM_FILE, "r");
+	assert(in != NULL);
+	char prefix[32];
+	snprintf(prefix, sizeof(prefix), "n %u ", idx);
+	bool found = false;
+	*n_lines = 0;
+	char line[1024];
+	while (fgets(line, sizeof(line), in) != NULL) {
+		if (strncmp(line, "dump ", 5) == 0) {
+			found    = false;
+			*n_lines = 0;
+		} else if (line[0] == 'n') {
+			++*n_lines;
+			found |= strncmp(line, prefix, strlen(prefix)) == 0;
+		}
+	}
+	fclose(in);
+	return found;
+}
+
+/* Builds: int dump_stream(int x, int y) { return x + 1; } */
+int main(void)
+{
+	ir_init();
+
+	ir_graph *const irg = new_test_graph("dump_stream", 2, 1, 0);
+
+	ir_node *const x   = new_Proj(get_irg_args(irg), mode_Is, 0);
+	ir_node *const one = new_Const_long(mode_Is, 1);
+	ir_node *const res = new_Add(x, one);
+	ir_node *const ret = new_Return(get_store(), 1, &res);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_cur_block());
+	irg_finalize_cons(irg);
+
+	unsigned n_lines;
+	dump_ir_graph_stream(irg, "full");
+	assert(last_dump_has_node(get_irn_idx(one), &n_lines));
+
+	/* nothing changed */
+	dump_ir_graph_stream(irg, "same");
+	assert(!last_dump_has_node(get_irn_idx(one), &n_lines));
+	assert(n_lines == 0);
+
+	/* attributes changed in place are dumped again */
+	set_Const_tarval(one, new_tarval_from_long(2, mode_Is));
+	dump_ir_graph_stream(irg, "tarval");
+	assert(last_dump_has_node(get_irn_idx(one), &n_lines));
+	assert(n_lines == 1);
+
+	set_Proj_num(x, 1);
+	dump_ir_graph_stream(irg, "proj");
+	assert(last_dump_has_node(get_irn_idx(x), &n_lines));
+	assert(n_lines == 1);
+
+	remove(STREAM_FILE);
+	return 0;
+}
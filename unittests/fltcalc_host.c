@@ -0,0 +1,107 @@
+#include "firm.h"
+#include "fltcalc.h"
+#include "util.h"
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+static uint64_t rand_state = 0x2545F4914F6CDD1DULL;
+
+static uint64_t next_rand(void)
+{
+	/* xorshift64 */
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 7;
+	rand_state ^= rand_state << 17;
+	return rand_state;
+}
+
+/** Returns a random finite bit pattern, preferring extreme exponents. */
+static uint64_t random_bits(const float_descriptor_t *desc)
+{
+	unsigned const mantissa_size = desc->mantissa_size;
+	uint64_t const max_exp       = (UINT64_C(1) << desc->exponent_size) - 2;
+	uint64_t const r             = next_rand();
+	uint64_t       exp;
+	switch (r % 4) {
+	case 0:  exp = r >> 8 & 3; break;
+	case 1:  exp = max_exp - (r >> 8 & 3); break;
+	case 2:  exp = (max_exp >> 1) - 8 + (r >> 8 & 15); break;
+	default: exp = (r >> 8) % (max_exp + 1); break;
+	}
+	uint64_t mant = next_rand() & ((UINT64_C(1) << mantissa_size) - 1);
+	if (next_rand() % 8 == 0)
+		mant &= ~((UINT64_C(1) << (mantissa_size / 2)) - 1);
+	uint64_t const sign = next_rand() & 1;
+	return sign << (mantissa_size + desc->exponent_size)
+	     | exp << mantissa_size | mant;
+}
+
+static void to_buf(uint64_t bits, unsigned char *buf, unsigned n_bytes)
+{
+	for (unsigned i = 0; i < n_bytes; ++i)
+		buf[i] = (unsigned char)(bits >> (i * 8));
+}
+
+typedef void (*fc_binop)(const fp_value *a, const fp_value *b,
+                         fp_value *result);
+
+static void check_op(fc_binop op, const fp_value *a, const fp_value *b,
+                     unsigned n_bytes)
+{
+	fp_value *const soft = (fp_value*)alloca(fc_get_value_size());
+	fp_value *const host = (fp_value*)alloca(fc_get_value_size());
+
+	fc_set_host_arith(false);
+	op(a, b, soft);
+	bool const soft_exact = fc_is_exact();
+	fc_set_host_arith(true);
+	op(a, b, host);
+	bool const host_exact = fc_is_exact();
+
+	unsigned char soft_buf[8];
+	unsigned char host_buf[8];
+	fc_val_to_bytes(soft, soft_buf);
+	fc_val_to_bytes(host, host_buf);
+	assert(memcmp(soft_buf, host_buf, n_bytes) == 0);
+	assert(soft_exact == host_exact);
+}
+
+static void check_mode(ir_mode *mode)
+{
+	static const fc_rounding_mode_t rounding_modes[] = {
+		FC_TONEAREST, FC_TOPOSITIVE, FC_TONEGATIVE, FC_TOZERO
+	};
+	static const fc_binop ops[] = { fc_add, fc_sub, fc_mul, fc_div };
+
+	const float_descriptor_t *desc    = &mode->float_desc;
+	unsigned const            n_bytes = get_mode_size_bytes(mode);
+	fp_value *const a = (fp_value*)alloca(fc_get_value_size());
+	fp_value *const b = (fp_value*)alloca(fc_get_value_size());
+
+	for (unsigned i = 0; i < 1000; ++i) {
+		unsigned char buf[8];
+		to_buf(random_bits(desc), buf, n_bytes);
+		fc_val_from_bytes(a, buf, desc);
+		to_buf(random_bits(desc), buf, n_bytes);
+		fc_val_from_bytes(b, buf, desc);
+
+		for (unsigned r = 0; r < ARRAY_SIZE(rounding_modes); ++r) {
+			fc_set_rounding_mode(rounding_modes[r]);
+			for (unsigned o = 0; o < ARRAY_SIZE(ops); ++o) {
+				check_op(ops[o], a, b, n_bytes);
+				check_op(ops[o], b, a, n_bytes);
+			}
+		}
+	}
+	fc_set_rounding_mode(FC_TONEAREST);
+}
+
+int main(void)
+{
+	ir_init();
+
+	check_mode(mode_F);
+	check_mode(mode_D);
+	return 0;
+}
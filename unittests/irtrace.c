@@ -0,0 +1,131 @@
+#include "firm.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TRACE_FILE  "irtrace.json"
+#define TRACE_FILE2 "irtrace2.json"
+
+static char events[8192];
+
+/* Reads a trace and returns its events as "B<name> E<name> ...". Checks that
+ * the file is a JSON array with one event per line. */
+static const char *read_events(const char *filename)
+{
+	FILE *const in = fopen(filename, "r");
+	assert(in != NULL);
+	char line[1024];
+	assert(fgets(line, sizeof(line), in) != NULL);
+	assert(strcmp(line, "[\n") == 0);
+	events[0] = '\0';
+	bool closed = false;
+	while (fgets(line, sizeof(line), in) != NULL) {
+		if (strcmp(line, "]\n") == 0) {
+			closed = true;
+			continue;
+		}
+		assert(!closed);
+		char name[64];
+		char phase;
+		if (line[0] == '\n')
+			continue;
+		assert(sscanf(line, "{\"name\":\"%63[^\"]\",\"cat\":\"firm\","
+		              "\"ph\":\"%c\"", name, &phase) == 2);
+		size_t const len = strlen(events);
+		snprintf(events + len, sizeof(events) - len, "%s%c%s",
+		         len > 0 ? " " : "", phase, name);
+	}
+	assert(closed);
+	fclose(in);
+	return events;
+}
+
+static void test_nested(void)
+{
+	/* pops without an open span are ignored */
+	ir_trace_pop();
+	assert(ir_trace_begin(TRACE_FILE) == 0);
+	ir_trace_pop();
+	ir_trace_push("a", NULL);
+	ir_trace_push("b", NULL);
+	ir_trace_pop();
+	ir_trace_push("c", NULL);
+	ir_trace_pop();
+	ir_trace_pop();
+	ir_trace_pop();
+	ir_trace_end();
+	assert(strcmp(read_events(TRACE_FILE), "Ba Bb Eb Bc Ec Ea") == 0);
+}
+
+static void test_unbalanced(void)
+{
+	/* open spans are closed at the end */
+	assert(ir_trace_begin(TRACE_FILE) == 0);
+	ir_trace_push("a", NULL);
+	ir_trace_push("b", NULL);
+	ir_trace_end();
+	assert(strcmp(read_events(TRACE_FILE), "Ba Bb Eb Ea") == 0);
+
+	/* the pops of spans closed by ir_trace_end() do not affect the next
+	 * trace */
+	ir_trace_pop();
+	assert(ir_trace_begin(TRACE_FILE) == 0);
+	ir_trace_push("c", NULL);
+	ir_trace_pop();
+	ir_trace_pop();
+	ir_trace_end();
+	assert(strcmp(read_events(TRACE_FILE), "Bc Ec") == 0);
+}
+
+static void test_restart(void)
+{
+	/* open spans continue in the new file */
+	assert(ir_trace_begin(TRACE_FILE) == 0);
+	ir_trace_push("a", NULL);
+	assert(ir_trace_begin(TRACE_FILE2) == 0);
+	ir_trace_push("b", NULL);
+	ir_trace_pop();
+	ir_trace_pop();
+	ir_trace_end();
+	assert(strcmp(read_events(TRACE_FILE), "Ba Ea") == 0);
+	assert(strcmp(read_events(TRACE_FILE2), "Ba Bb Eb Ea") == 0);
+}
+
+static void test_too_deep(void)
+{
+	assert(ir_trace_begin(TRACE_FILE) == 0);
+	for (int i = 0; i < 300; ++i)
+		ir_trace_push("d", NULL);
+	for (int i = 0; i < 300; ++i)
+		ir_trace_pop();
+	ir_trace_push("e", NULL);
+	ir_trace_pop();
+	ir_trace_end();
+
+	/* only the first 256 levels are recorded */
+	const char *const trace = read_events(TRACE_FILE);
+	unsigned n_begin = 0;
+	unsigned n_end   = 0;
+	for (const char *c = trace; *c != '\0'; ++c) {
+		if (c == trace || c[-1] == ' ') {
+			n_begin += c[0] == 'B' && c[1] == 'd';
+			n_end   += c[0] == 'E' && c[1] == 'd';
+		}
+	}
+	assert(n_begin == 256);
+	assert(n_end == 256);
+	assert(strcmp(trace + strlen(trace) - 5, "Be Ee") == 0);
+}
+
+int main(void)
+{
+	ir_init();
+	test_nested();
+	test_unbalanced();
+	test_restart();
+	test_too_deep();
+	remove(TRACE_FILE);
+	remove(TRACE_FILE2);
+	return 0;
+}
@@ -0,0 +1,115 @@
+#include "firm.h"
+#include "testgraph.h"
+#include "execfreq_t.h"
+#include "irgwalk.h"
+#include "irloop.h"
+#include <assert.h>
+
+#define TRIP_COUNT 16
+
+/* Builds: int f(void) { int s = 0; for (int i = 0; i < 16; ++i) s += i;
+ * return s; } */
+static ir_graph *build_counting_loop(const char *name)
+{
+	ir_graph *const irg = new_test_graph(name, 0, 1, 2);
+
+	set_value(0, new_Const_long(mode_Is, 0));
+	set_value(1, new_Const_long(mode_Is, 0));
+	ir_node *const enter = new_Jmp();
+	mature_immBlock(get_cur_block());
+
+	ir_node *const header = new_immBlock();
+	add_immBlock_pred(header, enter);
+	set_cur_block(header);
+	ir_node *const i     = get_value(0, mode_Is);
+	ir_node *const limit = new_Const_long(mode_Is, TRIP_COUNT);
+	ir_node *const cond  = new_Cond(new_Cmp(i, limit, ir_relation_less));
+	ir_node *const body  = new_immBlock();
+	add_immBlock_pred(body, new_Proj(cond, mode_X, pn_Cond_true));
+	ir_node *const exit  = new_immBlock();
+	add_immBlock_pred(exit, new_Proj(cond, mode_X, pn_Cond_false));
+
+	mature_immBlock(body);
+	set_cur_block(body);
+	set_value(1, new_Add(get_value(1, mode_Is), i));
+	set_value(0, new_Add(i, new_Const_long(mode_Is, 1)));
+	add_immBlock_pred(header, new_Jmp());
+	mature_immBlock(header);
+
+	mature_immBlock(exit);
+	set_cur_block(exit);
+	ir_node *const res = get_value(1, mode_Is);
+	ir_node *const ret = new_Return(get_store(), 1, &res);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+
+	irg_finalize_cons(irg);
+	return irg;
+}
+
+static void scale_freq(ir_node *block, void *data)
+{
+	double const factor = *(double*)data;
+	if (block != get_irg_start_block(get_irn_irg(block)))
+		set_block_execfreq(block, get_block_execfreq(block) * factor);
+}
+
+static void count_block(ir_node *block, void *data)
+{
+	(void)block;
+	++*(unsigned*)data;
+}
+
+static unsigned count_blocks(ir_graph *irg)
+{
+	unsigned n_blocks = 0;
+	irg_block_walk_graph(irg, count_block, NULL, &n_blocks);
+	return n_blocks;
+}
+
+static size_t count_loops(ir_graph *irg)
+{
+	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO);
+	ir_loop *const outermost = get_irg_loop(irg);
+	size_t         n_loops   = 0;
+	for (size_t i = 0, n = get_loop_n_elements(outermost); i < n; ++i) {
+		if (*get_loop_element(outermost, i).kind == k_ir_loop)
+			++n_loops;
+	}
+	return n_loops;
+}
+
+int main(void)
+{
+	ir_init();
+
+	/* without frequencies the loop is unrolled by the given factor */
+	ir_graph *const plain = build_counting_loop("plain");
+	unsigned  const plain_blocks = count_blocks(plain);
+	assert(!ir_has_execfreq(plain));
+	unroll_loops(plain, 4, 64);
+	assert(irg_verify(plain));
+	assert(count_blocks(plain) > plain_blocks);
+	assert(count_loops(plain) == 1);
+
+	/* the estimated frequencies make the loop hot, and a hot loop with few
+	 * iterations is unrolled completely */
+	ir_graph *const hot = build_counting_loop("hot");
+	ir_estimate_execfreq(hot);
+	assert(ir_has_execfreq(hot));
+	unroll_loops(hot, 4, 64);
+	assert(irg_verify(hot));
+	assert(count_loops(hot) == 0);
+
+	/* a cold loop is left alone */
+	ir_graph *const cold = build_counting_loop("cold");
+	unsigned  const cold_blocks = count_blocks(cold);
+	ir_estimate_execfreq(cold);
+	double const cold_factor = 0.01;
+	irg_block_walk_graph(cold, scale_freq, NULL, (void*)&cold_factor);
+	unroll_loops(cold, 4, 64);
+	assert(irg_verify(cold));
+	assert(count_blocks(cold) == cold_blocks);
+	assert(count_loops(cold) == 1);
+	return 0;
+}
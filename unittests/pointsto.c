@@ -0,0 +1,80 @@
+#include "firm.h"
+#include "testgraph.h"
+#include <assert.h>
+
+static ir_type *int_type;
+
+static ir_entity *new_local_entity(const char *name, ir_type *type)
+{
+	return new_global_entity(get_glob_type(), new_id_from_str(name), type,
+	                         ir_visibility_local, IR_LINKAGE_DEFAULT);
+}
+
+/* Builds: static void use(int *p, int *q) { *p = 0; *q = 1; } */
+static ir_graph *build_callee(ir_entity *ent, ir_node **p, ir_node **q)
+{
+	ir_graph *const irg = new_ir_graph(ent, 0);
+	set_current_ir_graph(irg);
+
+	ir_node *const args = get_irg_args(irg);
+	*p = new_Proj(args, mode_P, 0);
+	*q = new_Proj(args, mode_P, 1);
+	ir_node *const st0 = new_Store(get_store(), *p, new_Const_long(mode_Is, 0),
+	                               int_type, cons_none);
+	set_store(new_Proj(st0, mode_M, pn_Store_M));
+	ir_node *const st1 = new_Store(get_store(), *q, new_Const_long(mode_Is, 1),
+	                               int_type, cons_none);
+	set_store(new_Proj(st1, mode_M, pn_Store_M));
+	ir_node *const ret = new_Return(get_store(), 0, NULL);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_cur_block());
+
+	irg_finalize_cons(irg);
+	return irg;
+}
+
+/* Builds: void caller(void) { use(&a, &b); } */
+static void build_caller(ir_entity *use, ir_entity *a, ir_entity *b)
+{
+	ir_graph *const irg = new_test_graph("caller", 0, 0, 0);
+
+	ir_node *const in[] = { new_Address(a), new_Address(b) };
+	ir_node *const call = new_Call(get_store(), new_Address(use), 2, in,
+	                               get_entity_type(use));
+	set_store(new_Proj(call, mode_M, pn_Call_M));
+	ir_node *const ret = new_Return(get_store(), 0, NULL);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_cur_block());
+
+	irg_finalize_cons(irg);
+}
+
+int main(void)
+{
+	ir_init();
+	int_type = new_type_primitive(mode_Is);
+	ir_type *const ptr_type = new_type_pointer(int_type);
+	ir_type *const use_type = new_test_method_type(2, 0);
+	set_method_param_type(use_type, 0, ptr_type);
+	set_method_param_type(use_type, 1, ptr_type);
+
+	ir_entity *const use = new_local_entity("use", use_type);
+	ir_entity *const a   = new_local_entity("a", int_type);
+	ir_entity *const b   = new_local_entity("b", int_type);
+	ir_node        *p;
+	ir_node        *q;
+	build_callee(use, &p, &q);
+	build_caller(use, a, b);
+
+	/* two parameters may point to the same object */
+	assert(get_alias_relation(p, int_type, 4, q, int_type, 4) == ir_may_alias);
+
+	/* the only call passes pointers to different objects */
+	set_irp_memory_disambiguator_options(aa_opt_points_to);
+	compute_irp_points_to();
+	assert(get_alias_relation(p, int_type, 4, q, int_type, 4) == ir_no_alias);
+
+	/* the results are freed with the program */
+	ir_finish();
+	return 0;
+}
@@ -0,0 +1,59 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2026 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Graph setup shared by the unit tests.
+ */
+#ifndef FIRM_UNITTESTS_TESTGRAPH_H
+#define FIRM_UNITTESTS_TESTGRAPH_H
+
+#include "firm.h"
+#include <stdbool.h>
+
+/**
+ * Creates a method type with @p n_params int parameters and @p n_res int
+ * results.
+ */
+static inline ir_type *new_test_method_type(size_t n_params, size_t n_res)
+{
+	ir_type *const int_type = new_type_primitive(mode_Is);
+	ir_type *const mtp      = new_type_method(n_params, n_res, false,
+	                                          cc_cdecl_set, mtp_no_property);
+	for (size_t i = 0; i < n_params; ++i)
+		set_method_param_type(mtp, i, int_type);
+	for (size_t i = 0; i < n_res; ++i)
+		set_method_res_type(mtp, i, int_type);
+	return mtp;
+}
+
+/**
+ * Creates an externally visible function @p name of type @p mtp and a graph
+ * with @p n_loc local variables for it, which becomes the current graph.
+ */
+static inline ir_graph *new_test_graph_of_type(const char *name, ir_type *mtp,
+                                               int n_loc)
+{
+	ident     *const id  = new_id_from_str(name);
+	ir_entity *const ent = new_global_entity(get_glob_type(), id, mtp,
+	                                         ir_visibility_external,
+	                                         IR_LINKAGE_DEFAULT);
+	ir_graph  *const irg = new_ir_graph(ent, n_loc);
+	set_current_ir_graph(irg);
+	return irg;
+}
+
+/**
+ * Creates a function @p name with @p n_params int parameters and @p n_res int
+ * results, see new_test_graph_of_type().
+ */
+static inline ir_graph *new_test_graph(const char *name, size_t n_params,
+                                       size_t n_res, int n_loc)
+{
+	ir_type *const mtp = new_test_method_type(n_params, n_res);
+	return new_test_graph_of_type(name, mtp, n_loc);
+}
+
+#endif
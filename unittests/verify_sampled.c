@@ -0,0 +1,77 @@
+#include "firm.h"
+#include "testgraph.h"
+#include <assert.h>
+#include <stdbool.h>
+
+/* Builds: int f(int *p, int x) { (void)*p; return x + 1; } */
+static ir_graph *build_graph(ir_node **add, ir_node **ret)
+{
+	ir_type  *const mtp      = new_test_method_type(2, 1);
+	ir_type  *const int_type = get_method_param_type(mtp, 1);
+	set_method_param_type(mtp, 0, new_type_pointer(int_type));
+	ir_graph *const irg      = new_test_graph_of_type("sampled", mtp, 0);
+
+	ir_node *const args = get_irg_args(irg);
+	ir_node *const p    = new_Proj(args, mode_P, 0);
+	ir_node *const x    = new_Proj(args, mode_Is, 1);
+	ir_node *const load = new_Load(get_store(), p, mode_Is, int_type,
+	                               cons_none);
+	set_store(new_Proj(load, mode_M, pn_Load_M));
+	*add = new_Add(x, new_Const_long(mode_Is, 1));
+	*ret = new_Return(get_store(), 1, add);
+	add_immBlock_pred(get_irg_end_block(irg), *ret);
+	mature_immBlock(get_cur_block());
+
+	irg_finalize_cons(irg);
+	return irg;
+}
+
+int main(void)
+{
+	ir_init();
+	irg_verify_set_sample_period(3);
+
+	ir_node        *add;
+	ir_node        *ret;
+	ir_graph *const irg   = build_graph(&add, &ret);
+	ir_node  *const block = get_nodes_block(add);
+	ir_node  *const one   = get_Add_right(add);
+	/* created before the partial checks below, so it is not recorded there */
+	ir_node  *const bad   = new_r_Const_long(irg, mode_Iu, 1);
+
+	/* the first check of a graph is a full one */
+	assert(irg_verify_sampled(irg));
+
+	/* the unused Load is removed with kill_node() */
+	optimize_load_store(irg);
+	assert(irg_verify_sampled(irg));
+
+	/* an input changed in place is not recorded, only the full check finds
+	 * it */
+	set_irn_n(add, n_Add_right, bad);
+	assert(irg_verify_sampled(irg));
+	assert(!irg_verify_sampled(irg));
+	set_irn_n(add, n_Add_right, one);
+
+	/* a broken new node is found by the partial check */
+	ir_node *const two  = new_r_Const_long(irg, mode_Is, 2);
+	ir_node *const add2 = new_r_Add(block, get_Add_left(add), two);
+	assert(add2 != add);
+	set_irn_n(add2, n_Add_right, bad);
+	set_Return_res(ret, 0, add2);
+	assert(!irg_verify_sampled(irg));
+	set_irn_n(add2, n_Add_right, two);
+	assert(irg_verify_sampled(irg));
+
+	/* many changes without a check make the next check a full one */
+	assert(irg_verify_sampled(irg));
+	set_irn_n(add2, n_Add_right, bad);
+	for (long i = 0; i < 100; ++i)
+		new_r_Const_long(irg, mode_Is, 100 + i);
+	assert(!irg_verify_sampled(irg));
+	set_irn_n(add2, n_Add_right, two);
+
+	irg_verify_set_sample_period(0);
+	assert(irg_verify(irg));
+	return 0;
+}